@@ -0,0 +1,84 @@
+/*
+ *  aabbtree.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Dynamic bounding volume hierarchy. Every body is a leaf holding a fattened copy of its
+ *  bounding box, so a leaf only has to be removed and reinserted once the body leaves its fat
+ *  box. Internal nodes are kept balanced with AVL-style rotations. Unlike a uniform grid the
+ *  tree doesn't care how much body sizes vary, and the same tree answers region queries.
+ *
+ *  Pairs whose fat boxes overlap are kept between frames and only leaves that were inserted or
+ *  reinserted are queried for new ones, so a mostly settled scene costs little more than one
+ *  exact box test per candidate pair. Leaves and pairs are tracked by body slot so they survive
+ *  swap-remove reordering of the body store.
+ *
+ */
+
+#ifndef _INC_AABBTREE_H
+#define _INC_AABBTREE_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define AABBTREE_NULL UINT32_MAX                                // no node
+#define AABBTREE_MARGIN 3.0f                                    // fat boxes grow by this much, a bit over one step at max velocity
+#define AABBTREE_MARGIN_FRACTION 0.1f                           // plus this fraction of the body's extent
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+#include "bodystore.h"
+#include "broadphase.h"
+#include "pairmap.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+typedef struct aabbtree_node_t
+{
+
+    float               min_x, min_y;                           // bounding box, fattened for leaves
+    float               max_x, max_y;
+
+    uint32_t            parent;                                 // parent node, or next free node when unused
+    uint32_t            child1, child2;                         // AABBTREE_NULL for leaves
+    int32_t             height;                                 // 0 for leaves, -1 for unused nodes
+    uint32_t            slot;                                   // body slot of a leaf
+
+} aabbtree_node_t;
+
+struct aabbtree_t
+{
+
+    uint32_t            root;
+
+    uint32_t            node_count;                             // nodes ever handed out
+    uint32_t            node_capacity;
+    aabbtree_node_t     *nodes;
+    uint32_t            free_node;                              // head of the unused node list
+
+    uint32_t            slot_capacity;
+    uint32_t            *leaf;                                  // leaf node of each body slot, AABBTREE_NULL if untracked
+    uint32_t            *tracked;                               // generation each slot was tracked at
+
+    uint32_t            move_count;                             // leaves inserted or reinserted since the last find_pairs
+    uint32_t            move_capacity;
+    uint32_t            *moved;                                 // their body slots
+
+    pairmap_t           candidates;                             // slot pairs whose fat boxes overlap
+
+    uint32_t            stack_capacity;
+    uint32_t            *stack;                                 // traversal stack for queries
+
+};
+
+/* ---------------------------------------------------------------------------------------- */
+
+void aabbtree_init(aabbtree_t *tree);
+void aabbtree_destroy(aabbtree_t *tree);
+void aabbtree_update(aabbtree_t *tree, const bodystore_t *bodies);
+void aabbtree_find_pairs(aabbtree_t *tree, const bodystore_t *bodies, broadphase_pairs_t *pairs);
+void aabbtree_query(aabbtree_t *tree, const bodystore_t *bodies, float min_x, float min_y, float max_x, float max_y, broadphase_query_t callback, void *context);
+int32_t aabbtree_height(const aabbtree_t *tree);
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ *  bodystore.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Structure-of-arrays storage for every body in the simulation. Each property lives in its
+ *  own contiguous, SIMD-aligned array so the integrate, collide and render passes can stream
+ *  over exactly the data they touch.
+ *
+ *  Awake bodies are kept packed at the front of the arrays and sleeping ones behind them, so
+ *  passes that only care about moving bodies can run over [0, awake_count) and stay contiguous.
+ *
+ *  Bodies are referenced from outside the store through generational handles. The dense
+ *  arrays are kept packed by swap-remove, so a body's dense index can change whenever another
+ *  body is removed, but its handle stays valid until the body itself is removed.
+ *
+ */
+
+#ifndef _INC_BODYSTORE_H
+#define _INC_BODYSTORE_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define BODYSTORE_ALIGNMENT 16                                  // arrays are padded to a multiple of this many elements
+#define BODYSTORE_MIN_CAPACITY 64                               // smallest capacity the store will grow from
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+#include "simobject.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// stable reference to a body, stale once the body is removed
+typedef struct body_handle_t
+{
+
+    uint32_t            slot;                                   // index into the store's slot table
+    uint32_t            generation;                             // must match the slot's generation to be valid
+
+} body_handle_t;
+
+typedef struct bodystore_t
+{
+
+    uint32_t            count;                                  // number of bodies currently in the store
+    uint32_t            awake_count;                            // bodies [0, awake_count) are awake, the rest sleep
+    uint32_t            capacity;                               // number of bodies the arrays can hold
+
+    float               *x_pos, *y_pos;                         // position relative to the border's center
+    float               *prev_x_pos, *prev_y_pos;               // position before the latest step, for render interpolation
+    float               *x_vel, *y_vel;                         // velocity
+    float               *x_acc, *y_acc;                         // acceleration
+    float               *intr_x_vel, *intr_y_vel;               // intrinsic velocity
+    float               *intr_x_acc, *intr_y_acc;               // intrinsic acceleration
+    float               *ext_x_acc, *ext_y_acc;                 // pull of gravity and the force field, rebuilt every step
+
+    float               *mass;                                  // mass
+    float               *width, *height;                        // extents of the body's bounding box
+    float               *momentum;                              // magnitude of the body's momentum
+    float               *friction;                              // friction coefficient against whatever it touches
+    float               *restitution;                           // bounciness, 0 absorbs an impact and 1 returns all of it
+
+    uint32_t            *sleep_frames;                          // consecutive steps the body has been resting for
+    uint32_t            *color;                                 // packed 0xRRGGBBAA render color
+    uint32_t            *slot;                                  // slot each dense body is referenced through
+
+    uint32_t            slot_count;                             // number of slots ever handed out
+    uint32_t            slot_capacity;                          // number of slots the slot table can hold
+    uint32_t            *slot_index;                            // slot -> dense index, or next free slot when unused
+    uint32_t            *slot_generation;                       // bumped every time a slot is freed
+    uint32_t            free_slot;                              // head of the free slot list (UINT32_MAX if empty)
+
+} bodystore_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+// a body is the circle inscribed in the top left of its bounding box, as wide across as the box.
+// The narrowphase, CCD, gravity, the force field and every renderer take its center and radius
+// from here
+static inline float bodystore_radius(float width)
+{
+    return width * 0.5f;
+}
+
+static inline float bodystore_center(float pos, float width)
+{
+    return pos + bodystore_radius(width);
+}
+
+void bodystore_init(bodystore_t *store, uint32_t capacity);
+void bodystore_destroy(bodystore_t *store);
+void bodystore_reserve(bodystore_t *store, uint32_t capacity);
+body_handle_t bodystore_insert(bodystore_t *store, const simobject_t *obj);
+void bodystore_insert_many(bodystore_t *store, const simobject_t *objs, uint32_t count, body_handle_t *handles);
+bool bodystore_remove(bodystore_t *store, body_handle_t handle);
+uint32_t bodystore_lookup(const bodystore_t *store, body_handle_t handle);
+body_handle_t bodystore_handle(const bodystore_t *store, uint32_t index);
+void bodystore_save_positions(bodystore_t *store);
+uint32_t bodystore_sleep(bodystore_t *store, uint32_t index);
+uint32_t bodystore_wake(bodystore_t *store, uint32_t index);
+void bodystore_wake_all(bodystore_t *store);
+uint64_t bodystore_hash(const bodystore_t *store);
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ *  broadphase.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Finds the pairs of bodies whose bounding boxes overlap, so the narrowphase only has to look
+ *  at bodies that can actually be touching. Every unordered pair is reported exactly once,
+ *  with the lower dense index first.
+ *
+ */
+
+#ifndef _INC_BROADPHASE_H
+#define _INC_BROADPHASE_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+#include "bodystore.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+typedef struct spatialhash_t spatialhash_t;
+typedef struct sweepprune_t sweepprune_t;
+typedef struct aabbtree_t aabbtree_t;
+
+// which algorithm the broadphase runs
+typedef enum broadphase_type_t
+{
+
+    BROADPHASE_BRUTE_FORCE,                                     // tests every pair, reference for the others
+    BROADPHASE_SPATIAL_HASH,                                    // uniform grid hashed into a flat table
+    BROADPHASE_SWEEP_PRUNE,                                     // x-sorted endpoints kept across frames
+    BROADPHASE_AABB_TREE,                                       // dynamic bounding volume hierarchy of fat boxes
+
+} broadphase_type_t;
+
+// called by broadphase_query for each body in the region, return false to stop the query
+typedef bool (*broadphase_query_t)(uint32_t index, void *context);
+
+// two bodies whose bounding boxes overlap, a < b
+typedef struct broadphase_pair_t
+{
+
+    uint32_t            a;
+    uint32_t            b;
+
+} broadphase_pair_t;
+
+// reusable list of candidate pairs, only ever grows
+typedef struct broadphase_pairs_t
+{
+
+    uint32_t            count;
+    uint32_t            capacity;
+    broadphase_pair_t   *pairs;
+
+} broadphase_pairs_t;
+
+typedef struct broadphase_t
+{
+
+    broadphase_type_t   type;                                   // algorithm selected at startup
+    spatialhash_t       *grid;                                  // state for BROADPHASE_SPATIAL_HASH
+    sweepprune_t        *sap;                                   // state for BROADPHASE_SWEEP_PRUNE
+    aabbtree_t          *tree;                                  // state for BROADPHASE_AABB_TREE
+
+} broadphase_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void broadphase_init(broadphase_t *bp, broadphase_type_t type);
+void broadphase_destroy(broadphase_t *bp);
+void broadphase_find_pairs(broadphase_t *bp, const bodystore_t *bodies, broadphase_pairs_t *pairs);
+void broadphase_update(broadphase_t *bp, const bodystore_t *bodies);
+void broadphase_query(broadphase_t *bp, const bodystore_t *bodies, float min_x, float min_y, float max_x, float max_y, broadphase_query_t callback, void *context);
+bool broadphase_events(const broadphase_t *bp, const broadphase_pairs_t **began, const broadphase_pairs_t **ended);
+const char* broadphase_name(broadphase_type_t type);
+bool broadphase_parse_type(const char *name, broadphase_type_t *type);
+
+void broadphase_pairs_init(broadphase_pairs_t *pairs);
+void broadphase_pairs_destroy(broadphase_pairs_t *pairs);
+void broadphase_pairs_push(broadphase_pairs_t *pairs, uint32_t a, uint32_t b);
+
+#endif
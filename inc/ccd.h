@@ -0,0 +1,63 @@
+/*
+ *  ccd.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Continuous collision detection for fast bodies. The discrete collision stage only sees where
+ *  bodies end up, so a body that covers more than its own size in one step can pass straight
+ *  through another body or the border. After integration, every body that moved further than a
+ *  fraction of its radius is swept from where it started: the earliest time of impact against
+ *  the border and against the bodies along its path splits the step, the body is stopped just
+ *  short of the contact, bounced, and swept again for the rest of the step. Slow bodies are left
+ *  to the discrete stage.
+ *
+ *  Bodies are treated as circles inscribed in their bounding box against each other and as
+ *  boxes against the border, the same shapes the discrete stage uses.
+ *
+ */
+
+#ifndef _INC_CCD_H
+#define _INC_CCD_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define CCD_MOTION_THRESHOLD 0.5f                               // bodies moving more than this fraction of their radius per step are swept
+#define CCD_MAX_SUBSTEPS 4                                      // most impacts resolved for one body in one step
+#define CCD_MAX_ITERATIONS 32                                   // conservative advancement iterations per time of impact
+#define CCD_SLOP 0.01f                                          // gap left between a swept body and what it hit
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+#include "bodystore.h"
+#include "broadphase.h"
+#include "simobject.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+typedef struct ccd_t
+{
+
+    uint32_t            capacity;
+    float               *start_x, *start_y;                     // positions before the step was integrated
+
+    uint32_t            candidate_count;
+    uint32_t            candidate_capacity;
+    uint32_t            *candidates;                            // bodies overlapping the current sweep
+
+    uint32_t            swept;                                  // bodies swept by the last ccd_resolve
+    uint32_t            substeps;                               // impacts the last ccd_resolve split steps at
+
+} ccd_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void ccd_init(ccd_t *ccd);
+void ccd_destroy(ccd_t *ccd);
+void ccd_begin(ccd_t *ccd, const bodystore_t *bodies);
+void ccd_resolve(ccd_t *ccd, bodystore_t *bodies, broadphase_t *bp, const fieldproperties_t *props, float half_w, float half_h);
+bool ccd_circle_toi(float ax, float ay, float dx, float dy, float bx, float by, float radius, float *toi);
+bool ccd_border_toi(float min_x, float min_y, float max_x, float max_y, float dx, float dy, float half_w, float half_h, float *toi, float *normal_x, float *normal_y);
+
+#endif
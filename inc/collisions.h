@@ -14,11 +14,60 @@
 #include <stdbool.h>
 
 #include "SDL2/SDL.h"
+#include "bodystore.h"
+#include "broadphase.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define CONTACT_NO_BODY UINT32_MAX                              // body b of a border contact
+
+/* ---------------------------------------------------------------------------------------- */
+
+// what body a touched
+typedef enum contact_type_t
+{
+
+    CONTACT_BODY,                                               // another body, b
+    CONTACT_BORDER,                                             // the simulation border
+
+} contact_type_t;
+
+// one touching pair found this frame
+typedef struct contact_t
+{
+
+    uint32_t            a;                                      // dense index of the first body
+    uint32_t            b;                                      // dense index of the second body, CONTACT_NO_BODY for the border
+    uint8_t             type;                                   // contact_type_t
+    uint8_t             sides;                                  // side flags, as detect_object/border_collision set them
+    float               normal_x, normal_y;                     // unit normal pointing from a towards b (or the border wall)
+    float               depth;                                  // penetration along the normal
+    float               normal_impulse;                         // impulse accumulated along the normal, warm-started from the contact cache
+    float               tangent_impulse;                        // impulse accumulated across the normal
+
+} contact_t;
+
+// reusable list of contacts, cleared every frame and only ever grows
+typedef struct contactlist_t
+{
+
+    uint32_t            count;
+    uint32_t            capacity;
+    contact_t           *contacts;
+
+} contactlist_t;
 
 /* ---------------------------------------------------------------------------------------- */
 
 uint8_t detect_object_collision(SDL_FRect rect1, SDL_FRect rect2);
 uint8_t detect_border_collision(SDL_FRect rect1, SDL_FRect border);
+void detect_circle_contacts(const bodystore_t *bodies, const broadphase_pairs_t *pairs, contactlist_t *contacts);
+void detect_circle_contacts_range(const bodystore_t *bodies, const broadphase_pairs_t *pairs, uint32_t begin, uint32_t end, contactlist_t *contacts);
+bool detect_border_contact(SDL_FRect rect1, SDL_FRect border, contact_t *contact);
+
+void contactlist_init(contactlist_t *list);
+void contactlist_destroy(contactlist_t *list);
+contact_t* contactlist_push(contactlist_t *list);
 
 /* ---------------------------------------------------------------------------------------- */
 
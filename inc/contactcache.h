@@ -0,0 +1,66 @@
+/*
+ *  contactcache.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Per-contact state that outlives a frame: how long a pair has been touching, the impulse the
+ *  response has built up on it and the normal it was built along. Entries live in a pair map
+ *  keyed by body slot (the border counts as CONTACT_NO_BODY), so memory follows the number of
+ *  contacts and survives swap-remove reordering.
+ *
+ *  When the broadphase reports which pairs stopped overlapping (sweep and prune does), those are
+ *  the only entries evicted: a pair can't touch once its bounds are apart. The other entries may
+ *  go stale while their bounds still overlap, so a pair that wasn't touching last frame starts
+ *  over. Border entries are kept too, at most one per slot. Without events, the pairs that
+ *  weren't touching this frame are dropped in one pass over the table.
+ *
+ */
+
+#ifndef _INC_CONTACTCACHE_H
+#define _INC_CONTACTCACHE_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define CONTACTCACHE_NORMAL_TOLERANCE 0.95f                     // cached impulse is only reused if the normal turned less than ~18 degrees
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+#include "bodystore.h"
+#include "collisions.h"
+#include "pairmap.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// what the cache remembers about a touching pair
+typedef struct contactcache_entry_t
+{
+
+    uint32_t            generation_a, generation_b;             // slot generations the entry belongs to
+    uint32_t            last_frame;                             // frame the pair was last touching
+    uint32_t            age;                                    // consecutive frames the pair has been touching
+
+    float               normal_impulse;                         // impulse accumulated along the normal
+    float               tangent_impulse;                        // impulse accumulated across it
+    float               normal_x, normal_y;                     // normal the impulses were accumulated along
+
+} contactcache_entry_t;
+
+typedef struct contactcache_t
+{
+
+    pairmap_t           entries;                                // slot pair -> contactcache_entry_t
+    uint32_t            frame;                                  // bumped by every contactcache_update
+
+} contactcache_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void contactcache_init(contactcache_t *cache);
+void contactcache_destroy(contactcache_t *cache);
+void contactcache_update(contactcache_t *cache, const bodystore_t *bodies, contactlist_t *contacts, const broadphase_pairs_t *ended);
+contactcache_entry_t* contactcache_find(const contactcache_t *cache, const bodystore_t *bodies, const contact_t *contact);
+void contactcache_store(contactcache_t *cache, const bodystore_t *bodies, const contactlist_t *contacts);
+
+#endif
@@ -22,5 +22,7 @@
 void evt_sdl_quit_handler(SDL_Event *event, simulation_t *sim);
 void evt_sdl_keydown_handler(SDL_Event *event, simulation_t *sim);
 void evt_sdl_keyup_handler(SDL_Event *event, simulation_t *sim);
+void evt_sdl_mousebutton_handler(SDL_Event *event, simulation_t *sim);
+void evt_sdl_mousemotion_handler(SDL_Event *event, simulation_t *sim);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+/*
+ *  forcefield.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  A grid of acceleration vectors laid over the border. Each awake body samples it at its
+ *  center, interpolating bilinearly between the four grid points around it, and the sample is
+ *  added to its external acceleration. A body costs the same however the field was built.
+ *
+ *  The field starts out empty and is built up by adding to it: a uniform wind, vortices and
+ *  attractors each only touch the grid points within their radius, and single points can be set
+ *  outright. A whole grid can also be loaded from a text file:
+ *
+ *      # comments run to the end of the line
+ *      <columns> <rows>
+ *      <ax> <ay>               columns * rows times, row by row from the border's smallest y
+ *
+ *  The grid is stretched over the border whatever its resolution. Bodies outside the border
+ *  sample its edge. Once the simulation has started, only the physics thread may change the
+ *  field.
+ *
+ *  Batches of bodies are sampled with SSE2 or AVX2, whichever is the widest the CPU supports.
+ *  Every operation mirrors forcefield_sample in the same order, so the batches match it bit for
+ *  bit.
+ *
+ */
+
+#ifndef _INC_FORCEFIELD_H
+#define _INC_FORCEFIELD_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define FORCEFIELD_MIN_POINTS 2                                 // fewest grid points along an axis, enough for one cell
+#define FORCEFIELD_GRAIN 1024                                   // bodies a worker samples at a time
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+#include "bodystore.h"
+#include "workers.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+typedef struct forcefield_t forcefield_t;
+
+// samples bodies [begin, end), returns where it stopped so the rest can go to forcefield_sample
+typedef uint32_t (*forcefield_sampler_t)(const forcefield_t *field, bodystore_t *bodies, uint32_t begin, uint32_t end);
+
+struct forcefield_t
+{
+
+    bool                enabled;                                // whether anything has been added since the last clear
+    workers_t           *workers;                               // threads the bodies are sampled across
+
+    uint32_t            columns, rows;                          // grid points along x and along y
+    float               min_x, min_y;                           // position of the first grid point
+    float               max_x, max_y;                           // position of the last grid point
+    float               inv_dx, inv_dy;                         // grid cells per unit along x and along y
+    float               *x_acc, *y_acc;                         // acceleration at each grid point, row by row
+
+    forcefield_sampler_t sampler;                               // widest batch sampler the CPU supports
+    const char          *sampler_name;
+
+};
+
+/* ---------------------------------------------------------------------------------------- */
+
+void forcefield_init(forcefield_t *field, float min_x, float min_y, float max_x, float max_y, uint32_t columns, uint32_t rows, workers_t *workers);
+void forcefield_destroy(forcefield_t *field);
+void forcefield_resize(forcefield_t *field, uint32_t columns, uint32_t rows);
+void forcefield_clear(forcefield_t *field);
+void forcefield_set(forcefield_t *field, uint32_t column, uint32_t row, float ax, float ay);
+void forcefield_add_wind(forcefield_t *field, float ax, float ay);
+void forcefield_add_vortex(forcefield_t *field, float x, float y, float radius, float strength);
+void forcefield_add_attractor(forcefield_t *field, float x, float y, float radius, float strength);
+bool forcefield_load(forcefield_t *field, const char *path);
+void forcefield_sample(const forcefield_t *field, float x, float y, float *ax, float *ay);
+void forcefield_apply(forcefield_t *field, bodystore_t *bodies);
+void forcefield_apply_range(const forcefield_t *field, bodystore_t *bodies, uint32_t begin, uint32_t end);
+
+#endif
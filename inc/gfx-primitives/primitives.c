@@ -70,6 +70,190 @@ typedef struct {
 	Sint16 last1x, last1y, last2x, last2y, first1x, first1y, first2x, first2y, tempx, tempy;
 } SDL2_gfxMurphyIterator;
 
+/* ---- Span batching */
+
+/*!
+\brief The spans filled primitives collect between gfxPrimitivesBeginBatch and gfxPrimitivesFlushBatch.
+
+Note: Spans only share a batch while they share a color, so a primitive in a new color flushes
+the spans before it. Like the polygon cache, there is one batch for the whole program.
+*/
+typedef struct {
+	SDL_Renderer *renderer;	/* renderer the batch draws to, NULL outside a batch */
+	SDL_FRect *spans;		/* pending spans, reused from one batch to the next */
+	int count, allocated;
+	Uint8 r, g, b, a;		/* color of the pending spans */
+} SDL2_gfxSpanBatch;
+
+static SDL2_gfxSpanBatch gfxPrimitivesSpanBatch = { NULL, NULL, 0, 0, 0, 0, 0, 0 };
+
+/*!
+\brief Draw every pending span with one call and empty the batch.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+static int _gfxPrimitivesDrawSpans(void)
+{
+	SDL2_gfxSpanBatch *batch = &gfxPrimitivesSpanBatch;
+	int result = 0;
+
+	if (batch->count == 0) {
+		return 0;
+	}
+
+	result |= SDL_SetRenderDrawBlendMode(batch->renderer, (batch->a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+	result |= SDL_SetRenderDrawColor(batch->renderer, batch->r, batch->g, batch->b, batch->a);
+	result |= SDL_RenderFillRectsF(batch->renderer, batch->spans, batch->count);
+
+	batch->count = 0;
+	return result;
+}
+
+/*!
+\brief Set the color the following spans are filled with.
+
+Inside a batch this only flushes the pending spans if the color changes, outside of one it sets
+the renderer's draw color and blend mode directly.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+static int _gfxPrimitivesSpanColor(SDL_Renderer * renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+	SDL2_gfxSpanBatch *batch = &gfxPrimitivesSpanBatch;
+	int result = 0;
+
+	if (batch->renderer != renderer) {
+		result |= SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+		result |= SDL_SetRenderDrawColor(renderer, r, g, b, a);
+		return result;
+	}
+
+	if ((batch->r != r) || (batch->g != g) || (batch->b != b) || (batch->a != a)) {
+		result |= _gfxPrimitivesDrawSpans();
+		batch->r = r;
+		batch->g = g;
+		batch->b = b;
+		batch->a = a;
+	}
+
+	return result;
+}
+
+/*!
+\brief Fill a rectangle in the span color, adding it to the batch when there is one.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+static int _gfxPrimitivesSpan(SDL_Renderer * renderer, float x, float y, float w, float h)
+{
+	SDL2_gfxSpanBatch *batch = &gfxPrimitivesSpanBatch;
+	SDL_FRect *spansNew;
+	SDL_FRect rect;
+	int allocatedNew;
+
+	rect.x = x;
+	rect.y = y;
+	rect.w = w;
+	rect.h = h;
+
+	if (batch->renderer != renderer) {
+		return SDL_RenderFillRectF(renderer, &rect);
+	}
+
+	/*
+	* Grow the span array, keeping the old one and the spans in it if it can't
+	*/
+	if (batch->count == batch->allocated) {
+		allocatedNew = (batch->allocated) ? 2 * batch->allocated : 1024;
+		spansNew = (SDL_FRect *) realloc(batch->spans, sizeof(SDL_FRect) * allocatedNew);
+		if (!spansNew) {
+			return -1;
+		}
+		batch->spans = spansNew;
+		batch->allocated = allocatedNew;
+	}
+
+	batch->spans[batch->count++] = rect;
+	return 0;
+}
+
+/*!
+\brief Fill a horizontal line in the span color, adding it to the batch when there is one.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+static int _gfxPrimitivesHspan(SDL_Renderer * renderer, Sint16 x1, Sint16 x2, Sint16 y)
+{
+	if (x1 > x2) {
+		return _gfxPrimitivesSpan(renderer, x2, y, x1 - x2 + 1, 1);
+	}
+	return _gfxPrimitivesSpan(renderer, x1, y, x2 - x1 + 1, 1);
+}
+
+/*!
+\brief Start collecting the scanlines of filled primitives instead of drawing them one by one.
+
+Until gfxPrimitivesFlushBatch, filledCircle, filledEllipse, filledPolygon, filledPie, filledTrigon,
+box and roundedBox only add their spans to a buffer, which is drawn with one SDL_RenderFillRectsF
+call per run of primitives of the same color. Other primitives still draw right away, so they can
+land underneath spans that are still pending. Only the renderer given here is batched.
+
+\param renderer The renderer to batch.
+
+\returns Returns 0 on success, -1 if a batch is already open.
+*/
+int gfxPrimitivesBeginBatch(SDL_Renderer * renderer)
+{
+	if ((renderer == NULL) || (gfxPrimitivesSpanBatch.renderer != NULL)) {
+		return -1;
+	}
+
+	gfxPrimitivesSpanBatch.renderer = renderer;
+	gfxPrimitivesSpanBatch.count = 0;
+	return 0;
+}
+
+/*!
+\brief Draw the spans collected since gfxPrimitivesBeginBatch and close the batch.
+
+\param renderer The renderer the batch was opened on.
+
+\returns Returns 0 on success, -1 on failure or if no batch is open on the renderer.
+*/
+int gfxPrimitivesFlushBatch(SDL_Renderer * renderer)
+{
+	int result;
+
+	if ((renderer == NULL) || (gfxPrimitivesSpanBatch.renderer != renderer)) {
+		return -1;
+	}
+
+	result = _gfxPrimitivesDrawSpans();
+	gfxPrimitivesSpanBatch.renderer = NULL;
+	return result;
+}
+
+/*!
+\brief Free the span buffer batches are collected in.
+
+The buffer is kept from one batch to the next, so call this once no more batches will be drawn.
+A later gfxPrimitivesBeginBatch allocates a new one.
+
+\returns Returns 0 on success, -1 if a batch is still open.
+*/
+int gfxPrimitivesFreeBatch(void)
+{
+	if (gfxPrimitivesSpanBatch.renderer != NULL) {
+		return -1;
+	}
+
+	free(gfxPrimitivesSpanBatch.spans);
+	gfxPrimitivesSpanBatch.spans = NULL;
+	gfxPrimitivesSpanBatch.count = 0;
+	gfxPrimitivesSpanBatch.allocated = 0;
+	return 0;
+}
+
 /* ---- Pixel */
 
 /*!
@@ -724,9 +908,8 @@ int boxRGBA(SDL_Renderer * renderer, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2,
 	* Draw
 	*/
 	result = 0;
-	result |= SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
-	result |= SDL_SetRenderDrawColor(renderer, r, g, b, a);	
-	result |= SDL_RenderFillRect(renderer, &rect);
+	result |= _gfxPrimitivesSpanColor(renderer, r, g, b, a);
+	result |= _gfxPrimitivesSpan(renderer, rect.x, rect.y, rect.w, rect.h);
 	return result;
 }
 
@@ -1463,8 +1646,7 @@ int filledCircleRGBA(SDL_Renderer * renderer, Sint16 x, Sint16 y, Sint16 rad, Ui
 	* Set color
 	*/
 	result = 0;
-	result |= SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
-	result |= SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	result |= _gfxPrimitivesSpanColor(renderer, r, g, b, a);
 
 	/*
 	* Draw 
@@ -1478,10 +1660,10 @@ int filledCircleRGBA(SDL_Renderer * renderer, Sint16 x, Sint16 y, Sint16 rad, Ui
 			if (cy > 0) {
 				ypcy = y + cy;
 				ymcy = y - cy;
-				result |= hline(renderer, xmcx, xpcx, ypcy);
-				result |= hline(renderer, xmcx, xpcx, ymcy);
+				result |= _gfxPrimitivesHspan(renderer, xmcx, xpcx, ypcy);
+				result |= _gfxPrimitivesHspan(renderer, xmcx, xpcx, ymcy);
 			} else {
-				result |= hline(renderer, xmcx, xpcx, y);
+				result |= _gfxPrimitivesHspan(renderer, xmcx, xpcx, y);
 			}
 			ocy = cy;
 		}
@@ -1490,10 +1672,10 @@ int filledCircleRGBA(SDL_Renderer * renderer, Sint16 x, Sint16 y, Sint16 rad, Ui
 				if (cx > 0) {
 					ypcx = y + cx;
 					ymcx = y - cx;
-					result |= hline(renderer, xmcy, xpcy, ymcx);
-					result |= hline(renderer, xmcy, xpcy, ypcx);
+					result |= _gfxPrimitivesHspan(renderer, xmcy, xpcy, ymcx);
+					result |= _gfxPrimitivesHspan(renderer, xmcy, xpcy, ypcx);
 				} else {
-					result |= hline(renderer, xmcy, xpcy, y);
+					result |= _gfxPrimitivesHspan(renderer, xmcy, xpcy, y);
 				}
 			}
 			ocx = cx;
@@ -2018,8 +2200,7 @@ int filledEllipseRGBA(SDL_Renderer * renderer, Sint16 x, Sint16 y, Sint16 rx, Si
 	* Set color
 	*/
 	result = 0;
-	result |= SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
-	result |= SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	result |= _gfxPrimitivesSpanColor(renderer, r, g, b, a);
 
 	/*
 	* Init vars 
@@ -2043,10 +2224,10 @@ int filledEllipseRGBA(SDL_Renderer * renderer, Sint16 x, Sint16 y, Sint16 rx, Si
 				xph = x + h;
 				xmh = x - h;
 				if (k > 0) {
-					result |= hline(renderer, xmh, xph, y + k);
-					result |= hline(renderer, xmh, xph, y - k);
+					result |= _gfxPrimitivesHspan(renderer, xmh, xph, y + k);
+					result |= _gfxPrimitivesHspan(renderer, xmh, xph, y - k);
 				} else {
-					result |= hline(renderer, xmh, xph, y);
+					result |= _gfxPrimitivesHspan(renderer, xmh, xph, y);
 				}
 				ok = k;
 			}
@@ -2054,10 +2235,10 @@ int filledEllipseRGBA(SDL_Renderer * renderer, Sint16 x, Sint16 y, Sint16 rx, Si
 				xmi = x - i;
 				xpi = x + i;
 				if (j > 0) {
-					result |= hline(renderer, xmi, xpi, y + j);
-					result |= hline(renderer, xmi, xpi, y - j);
+					result |= _gfxPrimitivesHspan(renderer, xmi, xpi, y + j);
+					result |= _gfxPrimitivesHspan(renderer, xmi, xpi, y - j);
 				} else {
-					result |= hline(renderer, xmi, xpi, y);
+					result |= _gfxPrimitivesHspan(renderer, xmi, xpi, y);
 				}
 				oj = j;
 			}
@@ -2080,10 +2261,10 @@ int filledEllipseRGBA(SDL_Renderer * renderer, Sint16 x, Sint16 y, Sint16 rx, Si
 				xmj = x - j;
 				xpj = x + j;
 				if (i > 0) {
-					result |= hline(renderer, xmj, xpj, y + i);
-					result |= hline(renderer, xmj, xpj, y - i);
+					result |= _gfxPrimitivesHspan(renderer, xmj, xpj, y + i);
+					result |= _gfxPrimitivesHspan(renderer, xmj, xpj, y - i);
 				} else {
-					result |= hline(renderer, xmj, xpj, y);
+					result |= _gfxPrimitivesHspan(renderer, xmj, xpj, y);
 				}
 				oi = i;
 			}
@@ -2091,10 +2272,10 @@ int filledEllipseRGBA(SDL_Renderer * renderer, Sint16 x, Sint16 y, Sint16 rx, Si
 				xmk = x - k;
 				xpk = x + k;
 				if (h > 0) {
-					result |= hline(renderer, xmk, xpk, y + h);
-					result |= hline(renderer, xmk, xpk, y - h);
+					result |= _gfxPrimitivesHspan(renderer, xmk, xpk, y + h);
+					result |= _gfxPrimitivesHspan(renderer, xmk, xpk, y - h);
 				} else {
-					result |= hline(renderer, xmk, xpk, y);
+					result |= _gfxPrimitivesHspan(renderer, xmk, xpk, y);
 				}
 				oh = h;
 			}
@@ -2928,15 +3109,14 @@ int filledPolygonRGBAMT(SDL_Renderer * renderer, const Sint16 * vx, const Sint16
 		* Set color 
 		*/
 		result = 0;
-	    result |= SDL_SetRenderDrawBlendMode(renderer, (a == 255) ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
-		result |= SDL_SetRenderDrawColor(renderer, r, g, b, a);	
+		result |= _gfxPrimitivesSpanColor(renderer, r, g, b, a);
 
 		for (i = 0; (i < ints); i += 2) {
 			xa = gfxPrimitivesPolyInts[i] + 1;
 			xa = (xa >> 16) + ((xa & 32768) >> 15);
 			xb = gfxPrimitivesPolyInts[i+1] - 1;
 			xb = (xb >> 16) + ((xb & 32768) >> 15);
-			result |= hline(renderer, xa, xb, y);
+			result |= _gfxPrimitivesHspan(renderer, xa, xb, y);
 		}
 	}
 
@@ -59,6 +59,12 @@ Andreas Schiffler -- aschiffler at ferzkopp dot net
 
 	/* Note: all ___Color routines expect the color to be in format 0xRRGGBBAA */
 
+	/* Span batching */
+
+	int gfxPrimitivesBeginBatch(SDL_Renderer * renderer);
+	int gfxPrimitivesFlushBatch(SDL_Renderer * renderer);
+	int gfxPrimitivesFreeBatch(void);
+
 	/* Pixel */
 
 	int pixelColor(SDL_Renderer * renderer, Sint16 x, Sint16 y, Uint32 color);
@@ -0,0 +1,114 @@
+/*
+ *  gravity.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Mutual gravitation. Every awake body is pulled toward every other body, sleeping ones
+ *  included, and the pull is added to its external acceleration for the integrator to apply.
+ *
+ *    barnes-hut   bodies are sorted along a Morton curve and a quadtree is built over the sorted
+ *                 order, each node keeping the total mass and center of mass of its cell. A body
+ *                 takes a node as one point mass once the node's side is less than theta times
+ *                 its distance to the node's center of mass, and opens it otherwise, so a far
+ *                 away cluster costs one term. Bodies of a leaf are summed one by one. A theta of
+ *                 0 opens every node and gives the direct sum. O(n log n).
+ *
+ *    direct       every pair, O(n^2). The reference barnes-hut is checked against.
+ *
+ *  The top GRAVITY_TOP_LEVELS levels of the tree are always split, so the cells below them are
+ *  built as independent subtrees across the workers. The bounds, the sort and the force walk are
+ *  split across them too. Every pass works in fixed chunks and every body adds up its terms in a
+ *  fixed order, so the result doesn't depend on the number of threads.
+ *
+ */
+
+#ifndef _INC_GRAVITY_H
+#define _INC_GRAVITY_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define GRAVITY_CONSTANT 1.0f                                   // acceleration toward a unit mass at unit distance
+#define GRAVITY_SOFTENING 8.0f                                  // distance added in quadrature so close pairs stay finite
+#define GRAVITY_LEAF_SIZE 8                                     // bodies a cell holds before it's split
+#define GRAVITY_MAX_DEPTH 16                                    // Morton code bits per axis, cells are never split past it
+#define GRAVITY_TOP_LEVELS 3                                    // levels that are always split
+#define GRAVITY_TOP_CELLS 64                                    // cells on the last of those levels, 4 ^ GRAVITY_TOP_LEVELS
+#define GRAVITY_TOP_NODES 85                                    // nodes on all of those levels
+#define GRAVITY_GRAIN 4096                                      // bodies per chunk of the bounds, sort and gather passes
+#define GRAVITY_WALK_GRAIN 256                                  // bodies per chunk of the force walk
+#define GRAVITY_RADIX_BITS 8                                    // key bits sorted per radix pass
+#define GRAVITY_RADIX_SIZE 256                                  // digits per radix pass
+#define GRAVITY_STACK 64                                        // nodes the walk holds, four per level is plenty
+#define GRAVITY_LEAF UINT32_MAX                                 // child index of a leaf
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+#include "bodystore.h"
+#include "workers.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+typedef enum gravity_mode_t
+{
+
+    GRAVITY_OFF,                                                // bodies don't pull on each other
+    GRAVITY_BARNES_HUT,                                         // quadtree, far cells taken as one mass
+    GRAVITY_DIRECT,                                             // every pair
+
+} gravity_mode_t;
+
+typedef struct gravity_node_t
+{
+
+    float               x, y;                                   // center of mass
+    float               mass;
+    float               size;                                   // side of the node's square cell
+    uint32_t            first, count;                           // sorted bodies inside the cell
+    uint32_t            child;                                  // first of four consecutive children, GRAVITY_LEAF for a leaf
+
+} gravity_node_t;
+
+// the part of the tree below one top cell, built by one worker
+typedef struct gravity_subtree_t
+{
+
+    gravity_node_t      root;                                   // the top cell itself
+    gravity_node_t      *nodes;                                 // its descendants, child indices local to this array
+    uint32_t            count, capacity;
+    uint32_t            offset;                                 // where the descendants land in the whole tree
+
+} gravity_subtree_t;
+
+typedef struct gravity_t
+{
+
+    gravity_mode_t      mode;
+    float               theta;                                  // opening angle, smaller is more accurate and slower
+    workers_t           *workers;                               // threads every pass splits its work across
+
+    uint32_t            capacity;
+    uint64_t            *keys, *scratch;                        // Morton code << 32 | dense index, sorted by code
+    float               *x, *y, *mass;                          // bodies in sorted order
+
+    uint32_t            chunk_capacity;
+    uint32_t            *histograms;                            // digit counts of each chunk, then where it scatters each digit
+    float               *chunk_bounds;                          // smallest x and y, largest x and y of each chunk
+
+    float               min_x, min_y, size;                     // the root cell
+    uint32_t            node_count, node_capacity;
+    gravity_node_t      *nodes;                                 // the top levels level by level, then each subtree in turn
+    gravity_subtree_t   subtrees[GRAVITY_TOP_CELLS];
+
+} gravity_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void gravity_init(gravity_t *gravity, gravity_mode_t mode, float theta, workers_t *workers);
+void gravity_destroy(gravity_t *gravity);
+void gravity_apply(gravity_t *gravity, bodystore_t *bodies);
+const char* gravity_mode_name(gravity_mode_t mode);
+bool gravity_parse_mode(const char *name, gravity_mode_t *mode);
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ *  islands.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Simulation islands and sleeping. Bodies that touch, directly or through other bodies, form an
+ *  island; the border doesn't join islands since nothing it touches can move it. Islands are
+ *  rebuilt every step with union-find over the contact list.
+ *
+ *  A body counts as resting once the solver leaves it slower than ISLANDS_SLEEP_VELOCITY. When
+ *  every body in an island has rested for ISLANDS_SLEEP_FRAMES steps the whole island goes to
+ *  sleep: its bodies are moved behind the awake ones in the body store and skip integration,
+ *  collision and solving. A sleeping body wakes when an awake body touches it or when something
+ *  gives it velocity, and the rest of its island follows through their contacts.
+ *
+ */
+
+#ifndef _INC_ISLANDS_H
+#define _INC_ISLANDS_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define ISLANDS_SLEEP_VELOCITY 0.1f                             // speed below which a body counts as resting
+#define ISLANDS_SLEEP_FRAMES 500                                // steps an island has to rest before it sleeps
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+#include "bodystore.h"
+#include "collisions.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+typedef struct islands_t
+{
+
+    uint32_t            capacity;                               // bodies every array has room for
+    uint32_t            *parent;                                // union-find parent of each awake body
+    uint32_t            *rested;                                // fewest steps any body of a root's island has rested for
+    uint32_t            *waking;                                // slots of the bodies to wake
+    uint32_t            *sleeping;                              // slots of the bodies to put to sleep
+
+    uint32_t            island_count;                           // awake islands found by the last update
+    uint32_t            slept;                                  // bodies the last update put to sleep
+    uint32_t            woken;                                  // bodies the last update woke
+
+} islands_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void islands_init(islands_t *islands);
+void islands_destroy(islands_t *islands);
+void islands_update(islands_t *islands, bodystore_t *bodies, const contactlist_t *contacts);
+
+#endif
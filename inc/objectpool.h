@@ -0,0 +1,53 @@
+/*
+ *  objectpool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Fixed-size block allocator. Blocks are carved out of large cache-line-aligned slabs and
+ *  recycled through an intrusive free list, so allocating and freeing a block never touches
+ *  the general-purpose heap once the pool has warmed up.
+ *
+ */
+
+#ifndef _INC_OBJECTPOOL_H
+#define _INC_OBJECTPOOL_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define OBJECTPOOL_CACHE_LINE 64                                // slabs start on a cache line boundary
+#define OBJECTPOOL_SLAB_BLOCKS 4096                             // blocks per slab unless a bulk request needs more
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+typedef struct objectpool_slab_t objectpool_slab_t;
+
+typedef struct objectpool_t
+{
+
+    size_t              block_size;                             // bytes per block, at least a pointer wide
+
+    objectpool_slab_t   *slabs;                                 // every slab the pool owns, newest first
+    uint8_t             *bump;                                  // next never-used block in the newest slab
+    uint8_t             *bump_end;                              // end of the newest slab
+    void                *free_list;                             // singly linked list of freed blocks
+
+    uint32_t            live;                                   // blocks currently handed out
+
+} objectpool_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void objectpool_init(objectpool_t *pool, size_t block_size);
+void objectpool_destroy(objectpool_t *pool);
+void objectpool_reserve(objectpool_t *pool, uint32_t count);
+void* objectpool_alloc(objectpool_t *pool);
+void* objectpool_alloc_many(objectpool_t *pool, uint32_t count);
+void objectpool_free(objectpool_t *pool, void *block);
+void objectpool_free_many(objectpool_t *pool, void *blocks, uint32_t count);
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ *  pairmap.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Open-addressing hash map keyed by an unordered pair of 32-bit ids, with a fixed-size value
+ *  stored inline next to each key. Linear probing with backward-shift deletion, so there are
+ *  no tombstones and lookups stay short under heavy churn.
+ *
+ */
+
+#ifndef _INC_PAIRMAP_H
+#define _INC_PAIRMAP_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define PAIRMAP_EMPTY UINT64_MAX                                // key of an unused slot
+#define PAIRMAP_MIN_CAPACITY 64                                 // smallest table the map will use
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// decides whether pairmap_retain keeps an entry
+typedef bool (*pairmap_filter_t)(uint64_t key, void *value, void *context);
+
+typedef struct pairmap_t
+{
+
+    uint32_t            count;                                  // entries in the map
+    uint32_t            capacity;                               // slots in the table (a power of two)
+    uint32_t            shift;                                  // 64 - log2(capacity), for fibonacci hashing
+    size_t              value_size;                             // bytes of payload stored with each key
+
+    uint64_t            *keys;                                  // packed pair, PAIRMAP_EMPTY if the slot is unused
+    uint8_t             *values;                                // capacity * value_size bytes of payload
+
+} pairmap_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void pairmap_init(pairmap_t *map, size_t value_size, uint32_t capacity);
+void pairmap_destroy(pairmap_t *map);
+void pairmap_clear(pairmap_t *map);
+void* pairmap_find(const pairmap_t *map, uint64_t key);
+void* pairmap_insert(pairmap_t *map, uint64_t key, bool *inserted);
+bool pairmap_remove(pairmap_t *map, uint64_t key);
+bool pairmap_remove_at(pairmap_t *map, uint32_t index);
+void pairmap_retain(pairmap_t *map, pairmap_filter_t keep, void *context);
+
+/* ---------------------------------------------------------------------------------------- */
+
+// packs two ids into an order-independent key, the smaller id lands in the high half
+static inline uint64_t pairmap_key(uint32_t a, uint32_t b)
+{
+    return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+}
+
+static inline uint32_t pairmap_key_lo(uint64_t key) { return (uint32_t)(key >> 32); }
+static inline uint32_t pairmap_key_hi(uint64_t key) { return (uint32_t)key; }
+
+static inline void* pairmap_value_at(const pairmap_t *map, uint32_t index)
+{
+    return map->values + (size_t)index * map->value_size;
+}
+
+#endif
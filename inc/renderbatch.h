@@ -0,0 +1,61 @@
+/*
+ *  renderbatch.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Collects a frame's shapes as triangles in one vertex and index buffer and hands the whole
+ *  buffer to SDL_RenderGeometry at once, so a frame costs one submission however many shapes it
+ *  has. Each vertex carries its own color.
+ *
+ *  An ellipse is a fan of triangles around its center. Its outline gets as many segments as it
+ *  takes to keep every edge within RENDERBATCH_TOLERANCE pixels of the true curve, so small
+ *  bodies stay cheap and large ones stay round. The sines and cosines of every segment count are
+ *  worked out once, in renderbatch_init.
+ *
+ *  A quad is two triangles cut from a texture, such as a disc from the sprite atlas. A batch is
+ *  drawn with one texture, so quads and ellipses can't share one.
+ *
+ */
+
+#ifndef _INC_RENDERBATCH_H
+#define _INC_RENDERBATCH_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define RENDERBATCH_TOLERANCE 0.35f                             // farthest an outline edge may stray from the curve, in pixels
+#define RENDERBATCH_MIN_SEGMENTS 6                              // fewest segments around an ellipse
+#define RENDERBATCH_MAX_SEGMENTS 128                            // most segments around an ellipse
+#define RENDERBATCH_MIN_VERTICES 1024                           // smallest capacity the buffers grow from
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "SDL2/SDL.h"
+#include "common.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+typedef struct renderbatch_t
+{
+
+    uint32_t            vertex_count, vertex_capacity;
+    SDL_Vertex          *vertices;
+    uint32_t            index_count, index_capacity;
+    int                 *indices;                               // three per triangle
+
+    float               *unit_x, *unit_y;                       // outline points of a unit circle for every segment count
+    uint32_t            unit_start[RENDERBATCH_MAX_SEGMENTS + 1]; // where each segment count's points start
+
+} renderbatch_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void renderbatch_init(renderbatch_t *batch);
+void renderbatch_destroy(renderbatch_t *batch);
+void renderbatch_clear(renderbatch_t *batch);
+void renderbatch_add_ellipse(renderbatch_t *batch, float x, float y, float rx, float ry, uint32_t color);
+void renderbatch_add_quad(renderbatch_t *batch, const SDL_FRect *rect, const SDL_FRect *uv, uint32_t color);
+int renderbatch_submit(renderbatch_t *batch, SDL_Renderer *renderer, SDL_Texture *texture);
+uint32_t renderbatch_segments(float radius);
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ *  rng.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Counter-based random numbers. The n-th number of a stream is a hash of the seed, the stream and
+ *  n, so every stream gives the same sequence for the same seed on any platform or C library, and
+ *  streams never disturb each other no matter how their draws interleave.
+ *
+ */
+
+#ifndef _INC_RNG_H
+#define _INC_RNG_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// what each stream of the simulation is drawn for
+typedef enum rng_stream_t
+{
+
+    RNG_STREAM_SPAWN,                                           // masses and positions of new bodies
+    RNG_STREAM_DESPAWN,                                         // which body a despawn removes
+    RNG_STREAM_COLOR,                                           // body colors
+    RNG_STREAM_CHECK,                                           // inputs of the integrator check
+
+} rng_stream_t;
+
+typedef struct rng_t
+{
+
+    uint64_t            seed;
+    uint64_t            stream;
+    uint64_t            counter;                                // numbers drawn so far
+
+} rng_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void rng_init(rng_t *rng, uint64_t seed, uint64_t stream);
+uint64_t rng_at(uint64_t seed, uint64_t stream, uint64_t counter);
+uint32_t rng_next(rng_t *rng);
+uint32_t rng_below(rng_t *rng, uint32_t bound);
+
+#endif
@@ -23,7 +23,7 @@ typedef struct
 
 /* ---------------------------------------------------------------------------------------- */
 
-uint8_t shapes_render_circle(simulation_t *sim, simobject_t *obj);
+uint8_t shapes_render_circle(simulation_t *sim, float x_pos, float y_pos, float width, float height, uint32_t color);
 
 /* ---------------------------------------------------------------------------------------- */
 
@@ -10,6 +10,10 @@
 
 /* ---------------------------------------------------------------------------------------- */
 
+#define SIMOBJECT_CHECK_BODIES 1027                             // bodies simobject_check_integrator runs, not a multiple of any batch width
+
+/* ---------------------------------------------------------------------------------------- */
+
 #include "SDL2/SDL.h"
 #include "common.h"
 
@@ -59,17 +63,36 @@ typedef struct simobject_t
 
     float momentum;
 
+    float friction;
+    float restitution;
+
 } simobject_t;
 
+typedef struct bodystore_t bodystore_t;
+
 /* ---------------------------------------------------------------------------------------- */
 
 void destroyObject(simobject_t *obj);
+void destroyObjects(simobject_t *objs, uint32_t count);
 simobject_t* createObject
 (
     float mass, float x_pos, float y_pos, float x_vel, float y_vel, float x_acc, float y_acc,
     float intr_x_vel, float intr_y_vel, float intr_x_acc, float intr_y_acc
 );
-void simobject_update_state(simobject_t *obj, fieldproperties_t props);
-void simobject_collision(simobject_t *obj1, simobject_t *obj2, uint8_t collision_type, fieldproperties_t props);
+simobject_t* createObjects
+(
+    uint32_t count,
+    float mass, float x_pos, float y_pos, float x_vel, float y_vel, float x_acc, float y_acc,
+    float intr_x_vel, float intr_y_vel, float intr_x_acc, float intr_y_acc
+);
+void simobject_set_mass(simobject_t *obj, float mass);
+void simobject_seed(uint64_t seed);
+void simobject_pool_reserve(uint32_t count);
+void simobject_pool_release(void);
+void simobject_update_states(bodystore_t *bodies, const fieldproperties_t *props);
+void simobject_update_states_range(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props);
+void simobject_update_states_scalar(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props);
+const char* simobject_integrator_name(void);
+bool simobject_check_integrator(const fieldproperties_t *props);
 
 #endif
\ No newline at end of file
@@ -15,24 +15,93 @@
 #define WINDOW_WIDTH 1152
 #define WINDOW_HEIGHT 648
 
-#define SIMULATION_FPS 1000
-#define SIMULATION_NUM_OBJECTS 10
+#define SIMULATION_FPS 1000                                     // physics steps per second, independent of the display rate
+#define SIMULATION_MAX_STEPS_PER_FRAME 50                       // catch-up cap, time beyond it is dropped instead of simulated
+#define SIMULATION_NUM_OBJECTS 10                               // default number of bodies spawned at startup
 #define SIMULATION_CONSTANT_ACCELERATION 1
 #define SIMULATION_PERFECTLY_ELASTIC 1
+#define SIMULATION_SIMD_INTEGRATOR 1                            // 0 forces the scalar reference integrator
+#define SIMULATION_BROADPHASE BROADPHASE_AABB_TREE              // default broadphase, overridden with -b
+#define SIMULATION_CCD 1                                        // 0 turns off sweeping fast bodies for continuous collision
+#define SIMULATION_RESTITUTION 0.8f                             // default body bounciness when not perfectly elastic
+#define SIMULATION_FRICTION 0.3f                                // default body friction coefficient
+#define SIMULATION_SLEEP 1                                      // 0 keeps every body awake
+#define SIMULATION_SOLVER_ITERATIONS 8                          // default contact solver iterations per step, overridden with -i
+#define SIMULATION_SOLVER SOLVER_COLORED                        // default contact solver mode, overridden with -s
+#define SIMULATION_THREADS 0                                    // default worker threads, 0 for one per CPU, overridden with -t
+#define SIMULATION_RENDER_THREADS 0                             // default software rasterizer threads, 0 for one per CPU, overridden with -w
+#define SIMULATION_NARROWPHASE_GRAIN 256                        // candidate pairs per narrowphase chunk, fixed so contacts keep their order
+#define SIMULATION_GRAVITY GRAVITY_OFF                          // default mutual gravitation mode, overridden with -g
+#define SIMULATION_GRAVITY_THETA 0.5f                           // default barnes-hut opening angle, overridden with -a
+#define SIMULATION_BATCH_RENDER 1                               // 0 draws each body with its own ellipse fill instead of one batch
+#define SIMULATION_SPRITE_RENDER 1                              // 0 tessellates each batched body instead of drawing an atlas sprite
+#define SIMULATION_FIELD_COLUMNS 64                             // force field grid points across the border
+#define SIMULATION_FIELD_ROWS 36                                // force field grid points down the border
+#define SIMULATION_FIELD_BRUSH_RADIUS 80.0f                     // reach of the attractor or swirl a held mouse button adds to the field
+#define SIMULATION_FIELD_BRUSH_STRENGTH 0.05f                   // acceleration it adds at its center each frame the button is held
+#define SIMULATION_SEED 1                                       // default seed of every random stream, overridden with -d
 
 /* ---------------------------------------------------------------------------------------- */
 
 #include "SDL2/SDL.h"
 #include "simobject.h"
+#include "bodystore.h"
+#include "broadphase.h"
+#include "collisions.h"
+#include "contactcache.h"
+#include "ccd.h"
+#include "solver.h"
+#include "gravity.h"
+#include "forcefield.h"
+#include "islands.h"
+#include "workers.h"
+#include "snapshots.h"
+#include "renderbatch.h"
+#include "spriteatlas.h"
+#include "softraster.h"
+#include "rng.h"
 #include "userinteractions.h"
 #include "common.h"
 
 /* ---------------------------------------------------------------------------------------- */
 
+// what the render thread asks the physics thread to do to the force field, see simulation_apply_requests
+typedef enum simfield_edit_t
+{
+
+    SIMULATION_FIELD_NONE,
+    SIMULATION_FIELD_ATTRACT,                                   // pull toward the cursor, left mouse button
+    SIMULATION_FIELD_SWIRL,                                     // swirl around the cursor, right mouse button
+    SIMULATION_FIELD_CLEAR,                                     // empty the field, c
+
+} simfield_edit_t;
+
+// startup options, filled with defaults and then overridden from the command line
+typedef struct simsettings_t
+{
+
+    uint32_t            num_objects;                            // number of bodies spawned at startup
+    broadphase_type_t   broadphase;                             // collision broadphase algorithm
+    uint32_t            solver_iterations;                      // most contact solver iterations per step
+    solver_mode_t       solver_mode;                            // how the contact solver spreads its work
+    uint32_t            threads;                                // worker threads including the main one, 0 for one per CPU
+    gravity_mode_t      gravity_mode;                           // how bodies pull on each other
+    float               gravity_theta;                          // barnes-hut opening angle
+    const char          *field_path;                            // force field file loaded at startup, NULL for none
+    uint64_t            seed;                                   // seed of the spawn, despawn and color streams
+    bool                deterministic;                          // print a hash of the body state after every step
+    bool                software_render;                        // draw frames on the CPU instead of through the SDL renderer
+    uint32_t            render_threads;                         // threads the software rasterizer draws with including the main one, 0 for one per CPU
+
+} simsettings_t;
+
 typedef struct simproperties_t
 {
     bool                running;                                // simulation on/off
     uint16_t            fps;                                    // how many times the simulation is updated per second
+    uint32_t            num_objects;                            // number of bodies spawned at startup
+    bool                deterministic;                          // print a hash of the body state after every step
+    bool                software_render;                        // frames are drawn on the CPU and uploaded to the texture
 
     int32_t             windowHeight;                           // the window's height in screen coordinates
     int32_t             windowLength;                           // the window's length in screen coordinates
@@ -53,6 +122,21 @@ typedef struct sdlstructures_t
 
 } sdlstructures_t;
 
+// the step laid out as a task graph, plus what its tasks pass each other
+typedef struct simstep_t
+{
+
+    workers_graph_t     graph;                                  // border, broadphase, forces, narrowphase, solve, integrate, render-prep
+    uint32_t            chunk_capacity;
+    contactlist_t       *chunk_contacts;                        // contacts found by each chunk of narrowphase pairs
+    bool                render_prep;                            // whether this step publishes a snapshot for the render thread
+    float               alpha;                                  // fraction of a step left in the accumulator after this batch
+    uint32_t            report_steps;                           // steps since the phases were last reported
+    uint64_t            steps;                                  // steps run since the simulation started
+    uint64_t            hash;                                   // hash of the body state after the last step, in deterministic mode
+
+} simstep_t;
+
 typedef struct simulation_t
 {
     
@@ -60,14 +144,42 @@ typedef struct simulation_t
     simproperties_t     *properties;                            // simulation properties
     userinteractions_t  *userinteractions;                      // structure of possible user interactions
     fieldproperties_t   *fieldproperties;                       // physics field properties
-    simobject_t         **objects;                              // array of (pointers to) objects in the simulation
+    bodystore_t         *bodies;                                // structure-of-arrays store of every body in the simulation
+    broadphase_t        *broadphase;                            // finds candidate collision pairs each frame
+    broadphase_pairs_t  *pairs;                                 // candidate pairs found this frame
+    contactlist_t       *contacts;                              // touching pairs and border hits found this frame
+    contactcache_t      *contact_cache;                         // state of touching pairs carried between frames
+    ccd_t               *ccd;                                   // continuous collision for bodies that move fast
+    solver_t            *solver;                                // sequential impulse contact solver
+    gravity_t           *gravity;                               // pull bodies have on each other
+    forcefield_t        *field;                                 // grid of accelerations laid over the border
+    islands_t           *islands;                               // groups touching bodies so resting groups can sleep
+    workers_t           *workers;                               // threads parallel stages split their work across
+    simstep_t           *step;                                  // task graph each step runs
+    snapshots_t         *snapshots;                             // body state handed from the physics thread to the render thread
+    renderbatch_t       *batch;                                 // triangles of the frame being drawn, only the render thread touches it
+    spriteatlas_t       *atlas;                                 // pre-rasterized discs bodies are drawn with, no texture if it's off
+    softraster_t        *raster;                                // CPU frame buffer behind the texture, no pixels unless software rendering
+    workers_t           *render_workers;                        // threads the render thread draws tiles on, NULL unless software rendering
+
+    SDL_Thread          *physics;                               // steps the simulation while the main thread renders
+    SDL_atomic_t        stepping;                               // cleared to stop the physics thread
+    SDL_atomic_t        paused;                                 // the physics thread holds still while it's set
+    SDL_atomic_t        spawns;                                 // bodies the render thread asked to add
+    SDL_atomic_t        despawns;                               // bodies the render thread asked to remove
+    SDL_atomic_t        field_edit;                             // simfield_edit_t << 24 | window y << 12 | window x, 0 if none
+    rng_t               spawn_rng;                              // masses and positions of spawned bodies
+    rng_t               despawn_rng;                            // which bodies despawns remove
 
 } simulation_t;
 
 /* ---------------------------------------------------------------------------------------- */
 
-void simulation_init(simulation_t *sim);
+void simulation_default_settings(simsettings_t *settings);
+void simulation_init(simulation_t *sim, const simsettings_t *settings);
 void simulation_start(simulation_t *sim);
 void simulation_kill(simulation_t *sim);
+body_handle_t simulation_add_object(simulation_t *sim, simobject_t *obj);
+bool simulation_remove_object(simulation_t *sim, body_handle_t handle);
 
 #endif
\ No newline at end of file
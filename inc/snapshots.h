@@ -0,0 +1,67 @@
+/*
+ *  snapshots.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Lock-free triple buffer of body-state snapshots, handed from the physics thread to the render
+ *  thread. The physics thread fills the back buffer and swaps it with the shared middle one; the
+ *  render thread swaps the middle one with its front buffer whenever the middle holds something
+ *  newer. Both swaps are a single atomic exchange, so neither thread ever waits on the other and
+ *  the render thread always draws the newest complete snapshot.
+ *
+ *  The physics thread publishes after the last step of every batch of steps it runs, so the
+ *  newest snapshot is never more than one batch behind. Along with the positions before and after
+ *  that step it carries how far into the next step the accumulator already is, which the render
+ *  thread interpolates by.
+ *
+ */
+
+#ifndef _INC_SNAPSHOTS_H
+#define _INC_SNAPSHOTS_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define SNAPSHOTS_FRESH 4                                       // set on middle while it holds a snapshot the reader hasn't taken
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "SDL2/SDL.h"
+#include "common.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// what the renderer needs of every body at the end of one step, plus where it was before the step
+// so the render can interpolate
+typedef struct snapshot_t
+{
+
+    uint32_t            count;
+    uint32_t            capacity;
+    float               *prev_x_pos, *prev_y_pos;               // positions before the step
+    float               *x_pos, *y_pos;                         // positions after it
+    float               *width, *height;
+    uint32_t            *color;
+    float               alpha;                                  // fraction of a step the accumulator held past the step, 0 to 1
+
+} snapshot_t;
+
+typedef struct snapshots_t
+{
+
+    snapshot_t          buffers[3];
+    uint32_t            back;                                   // buffer the writer fills, only the writer touches it
+    uint32_t            front;                                  // buffer the reader draws, only the reader touches it
+    SDL_atomic_t        middle;                                 // the third buffer, ORed with SNAPSHOTS_FRESH if it's newer than front
+
+} snapshots_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void snapshots_init(snapshots_t *snapshots);
+void snapshots_destroy(snapshots_t *snapshots);
+snapshot_t* snapshots_back(snapshots_t *snapshots, uint32_t count);
+void snapshots_publish(snapshots_t *snapshots);
+const snapshot_t* snapshots_latest(snapshots_t *snapshots);
+
+#endif
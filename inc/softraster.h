@@ -0,0 +1,110 @@
+/*
+ *  softraster.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Draws a frame on the CPU into a pixel buffer laid out like SDL_PIXELFORMAT_RGBA8888, one
+ *  0xRRGGBBAA word per pixel, row by row. The frame is uploaded to a texture in one go, so the
+ *  cost of drawing doesn't depend on the render backend and the same frame comes out with or
+ *  without a GPU.
+ *
+ *  A frame is recorded first and drawn at the end. Shapes are given in window coordinates and
+ *  scaled down to the buffer, and a shape that lands entirely outside the buffer is dropped
+ *  right away. softraster_end bins every shape into the SOFTRASTER_TILE_SIZE square tiles its
+ *  bounds touch, then the workers each take whole tiles, clear them and draw their shapes in the
+ *  order they were recorded, clipped to the tile. No two tiles share a pixel, so nothing is
+ *  locked, and a pixel's value only depends on the shapes over it, so the frame is the same on
+ *  any number of threads. The bins are built like gravity's radix passes: each chunk of shapes
+ *  counts what it puts in every tile, the counts become where each chunk writes, and each chunk
+ *  writes in order.
+ *
+ *  Lines are one pixel wide and drawn like a DDA, one pixel per column, or per row when they are
+ *  steeper than 45 degrees. Each pixel is worked out from the line's ends alone rather than by
+ *  stepping from the previous one, so a tile can start anywhere along a line and draw the same
+ *  pixels it would have drawn on its own. A line is binned by its bounds like any other shape;
+ *  rectangle outlines are recorded as their four sides, so only the tiles along the edges draw
+ *  them.
+ *
+ *  Circles are anti-aliased: a pixel is covered by how far its center lies inside the edge, so
+ *  only the pixels within half a pixel of the edge are blended and the rest of each row is one
+ *  solid span. Spans are filled with SSE2 or AVX2 stores, whichever is the widest the CPU
+ *  supports.
+ *
+ */
+
+#ifndef _INC_SOFTRASTER_H
+#define _INC_SOFTRASTER_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define SOFTRASTER_TILE_SIZE 64                                 // side of a tile in pixels
+#define SOFTRASTER_GRAIN 4096                                   // shapes per chunk of the binning passes
+#define SOFTRASTER_MIN_SHAPES 1024                              // smallest capacity the shape and bin arrays grow from
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+#include "workers.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// writes count copies of color from pixels on
+typedef void (*softraster_fill_t)(uint32_t *pixels, uint32_t count, uint32_t color);
+
+typedef enum softraster_kind_t
+{
+
+    SOFTRASTER_BOX,                                             // filled rectangle
+    SOFTRASTER_LINE,                                            // one pixel wide line
+    SOFTRASTER_CIRCLE,                                          // anti-aliased disc
+
+} softraster_kind_t;
+
+typedef struct softraster_shape_t
+{
+
+    softraster_kind_t   kind;
+    uint32_t            color;
+    float               x, y, radius;                           // center and radius of a circle, or start of a line, in pixels
+    float               end_x, end_y;                           // other end of a line, in pixels
+    uint32_t            first_x, first_y, last_x, last_y;       // pixels it may touch, clipped to the buffer
+
+} softraster_shape_t;
+
+typedef struct softraster_t
+{
+
+    uint32_t            width, height;                          // size of the buffer in pixels
+    uint32_t            *pixels;                                // 0xRRGGBBAA, row by row with no padding
+    float               scale;                                  // buffer pixels per window unit
+    workers_t           *workers;                               // threads the bins and tiles are split across
+
+    softraster_fill_t   fill;                                   // widest span fill the CPU supports
+    const char          *fill_name;
+
+    uint32_t            clear;                                  // color every tile starts the frame with
+    uint32_t            shape_count, shape_capacity;
+    softraster_shape_t  *shapes;                                // recorded this frame, in drawing order
+
+    uint32_t            tiles_x, tiles_y;
+    uint32_t            chunk_capacity;
+    uint32_t            *histograms;                            // shapes each chunk puts in each tile, then where it writes them
+    uint32_t            *bin_start;                             // where each tile's shapes start in bins, plus the end
+    uint32_t            bin_capacity;
+    uint32_t            *bins;                                  // shape indices tile by tile, in drawing order within a tile
+
+} softraster_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void softraster_init(softraster_t *raster, uint32_t width, uint32_t height, float scale, workers_t *workers);
+void softraster_destroy(softraster_t *raster);
+void softraster_begin(softraster_t *raster, uint32_t clear);
+void softraster_fill_rect(softraster_t *raster, float x, float y, float w, float h, uint32_t color);
+void softraster_draw_rect(softraster_t *raster, float x, float y, float w, float h, uint32_t color);
+void softraster_draw_line(softraster_t *raster, float x0, float y0, float x1, float y1, uint32_t color);
+void softraster_fill_circle(softraster_t *raster, float x, float y, float radius, uint32_t color);
+void softraster_end(softraster_t *raster);
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ *  solver.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Sequential impulse contact solver. Every contact gets a normal impulse that stops its bodies
+ *  approaching and a friction impulse across the normal, bounded by the normal one. Contacts
+ *  share bodies, so a single pass leaves earlier contacts disturbed by later ones; the solver
+ *  sweeps the list repeatedly, accumulating and clamping each contact's total impulse, until
+ *  the impulses stop changing or the iteration budget runs out.
+ *
+ *  Contacts start from the impulses the contact cache kept for them from the previous step, so
+ *  a resting stack begins close to its answer and settles in a few iterations. Restitution is
+ *  only applied to impacts faster than SOLVER_RESTITUTION_THRESHOLD, so resting contacts don't
+ *  bounce on gravity. Overlap left after the velocity pass is pushed out directly.
+ *
+ *  Large scenes can be solved across the worker threads in one of two ways:
+ *
+ *    colored    contacts are greedily colored so no two contacts of a color share a body, then
+ *               sorted by color. The colors are swept in order and each color's contacts are
+ *               split across the threads, which can't race since they touch different bodies.
+ *               Convergence matches the sequential sweep. Contacts left over once
+ *               SOLVER_MAX_COLORS colors are used up are swept on the calling thread.
+ *
+ *    jacobi     every contact computes its impulse from the same velocities, then every body
+ *               gathers the impulses of its contacts. There's no coloring, only a per-body
+ *               contact list, but impulses don't see each other within an iteration so each is
+ *               scaled down by how many contacts share its busiest body, and it needs more
+ *               iterations to settle.
+ *
+ */
+
+#ifndef _INC_SOLVER_H
+#define _INC_SOLVER_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define SOLVER_MIN_CONSTRAINTS 64                               // smallest capacity the constraint array grows from
+#define SOLVER_TOLERANCE 0.001f                                 // velocity change below which an iteration counts as converged
+#define SOLVER_RESTITUTION_THRESHOLD 1.0f                       // approach speed below which contacts don't bounce
+#define SOLVER_CORRECTION_FRACTION 0.4f                         // share of the overlap pushed out of contacts each step
+#define SOLVER_CORRECTION_SLOP 0.05f                            // overlap left alone so resting contacts don't jitter
+#define SOLVER_MAX_COLORS 64                                    // colors a body can take part in, one bit each
+#define SOLVER_GRAIN 128                                        // contacts or bodies a worker claims at a time
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <math.h>
+
+#include "common.h"
+#include "bodystore.h"
+#include "collisions.h"
+#include "workers.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// how the solver sweeps the contacts
+typedef enum solver_mode_t
+{
+
+    SOLVER_SEQUENTIAL,                                          // one thread, in list order
+    SOLVER_COLORED,                                             // colors in order, each color across the workers
+    SOLVER_JACOBI,                                              // every contact at once, then every body at once
+
+} solver_mode_t;
+
+// per-contact terms that stay fixed while the solver iterates
+typedef struct solver_constraint_t
+{
+
+    float               inv_mass_a, inv_mass_b;                 // inverse masses, 0 for the border
+    float               normal_mass;                            // impulse per unit of relative velocity along the normal
+    float               tangent_mass;                           // same, across the normal
+    float               friction;                               // mixed friction of the two bodies
+    float               bias;                                   // separating speed restitution asks for
+    float               relaxation;                             // share of each impulse applied, below 1 only for jacobi
+
+} solver_constraint_t;
+
+typedef struct solver_t
+{
+
+    uint32_t            iterations;                             // most iterations per solve
+    solver_mode_t       mode;
+    workers_t           *workers;                               // threads the parallel modes split work across
+
+    uint32_t            capacity;
+    solver_constraint_t *constraints;                           // one per contact, rebuilt every solve
+    contact_t           *scratch;                               // colored: contacts while they're sorted by color
+    uint8_t             *contact_colors;                        // colored: color of each contact
+    float               *impulse_x, *impulse_y;                 // jacobi: impulse each contact applies this pass
+    uint32_t            *body_contacts;                         // jacobi: contacts of each body, index << 1 | (body is b)
+
+    uint32_t            body_capacity;
+    uint64_t            *body_colors;                           // colored: colors each body already takes part in
+    uint32_t            *body_start;                            // jacobi: where each body's contacts start, count + 1 entries
+
+    uint32_t            color_count;                            // colors the last solve used, the overflow not included
+    uint32_t            color_start[SOLVER_MAX_COLORS + 2];     // where each color starts in the sorted contacts, last is the overflow
+    float               worker_residual[WORKERS_MAX];           // each worker's residual for the iteration under way
+
+    uint32_t            iterations_used;                        // iterations the last solve ran
+    float               residual;                               // largest velocity change in the last solve's final iteration
+
+} solver_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+// bounciness of a contact between two bodies, the bouncier one wins
+static inline float solver_mix_restitution(float a, float b)
+{
+    return a > b ? a : b;
+}
+
+// friction of a contact between two bodies, either one being frictionless makes it frictionless
+static inline float solver_mix_friction(float a, float b)
+{
+    return sqrtf(a * b);
+}
+
+void solver_init(solver_t *solver, uint32_t iterations, solver_mode_t mode, workers_t *workers);
+void solver_destroy(solver_t *solver);
+void solver_solve(solver_t *solver, bodystore_t *bodies, contactlist_t *contacts);
+const char* solver_mode_name(solver_mode_t mode);
+bool solver_parse_mode(const char *name, solver_mode_t *mode);
+
+#endif
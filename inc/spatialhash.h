@@ -0,0 +1,49 @@
+/*
+ *  spatialhash.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Uniform-grid broadphase. Cells are as wide as the largest body, so every body touches at
+ *  most 2x2 cells. Occupied cells are hashed into a flat table that is rebuilt each frame with
+ *  a counting sort, which keeps a bucket's bodies contiguous in memory.
+ *
+ */
+
+#ifndef _INC_SPATIALHASH_H
+#define _INC_SPATIALHASH_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+#include "bodystore.h"
+#include "broadphase.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+struct spatialhash_t
+{
+
+    float               cell_size;                              // width and height of one grid cell
+
+    uint32_t            body_capacity;                          // bodies the per-body arrays can hold
+    int32_t             *cell_x0, *cell_y0;                     // first cell each body touches
+    int32_t             *cell_x1, *cell_y1;                     // last cell each body touches
+
+    uint32_t            entry_capacity;                         // (body, cell) entries the arrays can hold
+    uint32_t            *entry_body;                            // body of each entry, grouped by bucket
+    uint64_t            *entry_cell;                            // packed cell of each entry, tells apart cells sharing a bucket
+
+    uint32_t            table_capacity;                         // buckets the table can hold (a power of two)
+    uint32_t            table_mask;                             // buckets in use this frame minus one
+    uint32_t            *bucket_start;                          // first entry of each bucket, plus one past the end
+
+};
+
+/* ---------------------------------------------------------------------------------------- */
+
+void spatialhash_init(spatialhash_t *grid);
+void spatialhash_destroy(spatialhash_t *grid);
+void spatialhash_find_pairs(spatialhash_t *grid, const bodystore_t *bodies, broadphase_pairs_t *pairs);
+
+#endif
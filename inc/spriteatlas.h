@@ -0,0 +1,60 @@
+/*
+ *  spriteatlas.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  One texture holding white anti-aliased discs at every radius from SPRITEATLAS_STEP up to
+ *  SPRITEATLAS_MAX_RADIUS, in steps of SPRITEATLAS_STEP pixels. The discs are rasterized once when
+ *  the atlas is built, so drawing a body is just a quad cut from the texture, tinted by the
+ *  vertex color and stretched to the body's exact size. Bodies larger than the largest disc
+ *  stretch it.
+ *
+ *  Each disc's alpha is how much of a pixel it covers, and its color is white all the way out,
+ *  transparent pixels included, so filtering at the edge never darkens the tint.
+ *
+ */
+
+#ifndef _INC_SPRITEATLAS_H
+#define _INC_SPRITEATLAS_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define SPRITEATLAS_STEP 0.5f                                   // radius difference between neighbouring discs, in pixels
+#define SPRITEATLAS_MAX_RADIUS 64.0f                            // radius of the largest disc
+#define SPRITEATLAS_SPRITES 128                                 // discs in the atlas, SPRITEATLAS_MAX_RADIUS / SPRITEATLAS_STEP
+#define SPRITEATLAS_WIDTH 1024                                  // width of the texture, the discs are packed in rows across it
+#define SPRITEATLAS_GAP 1                                       // transparent pixels between neighbouring cells
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "SDL2/SDL.h"
+#include "common.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+typedef struct spriteatlas_sprite_t
+{
+
+    float               radius;                                 // radius of the disc, in texture pixels
+    SDL_FRect           uv;                                     // the disc's square cell, in texture coordinates
+    float               extent;                                 // half the cell's side over the radius
+
+} spriteatlas_sprite_t;
+
+typedef struct spriteatlas_t
+{
+
+    SDL_Texture         *texture;                               // NULL if the atlas couldn't be built
+    int                 width, height;
+    spriteatlas_sprite_t sprites[SPRITEATLAS_SPRITES];          // smallest disc first
+
+} spriteatlas_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+bool spriteatlas_init(spriteatlas_t *atlas, SDL_Renderer *renderer);
+void spriteatlas_destroy(spriteatlas_t *atlas);
+const spriteatlas_sprite_t* spriteatlas_find(const spriteatlas_t *atlas, float radius);
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ *  sweepprune.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Sort-and-sweep broadphase with temporal coherence. The min and max of every body on each axis
+ *  are kept in a sorted endpoint list across frames and re-sorted with insertion sort, which is
+ *  close to linear when bodies only move a little each step. A min endpoint passing a max
+ *  endpoint is exactly when two intervals start or stop overlapping, so the set of overlapping
+ *  pairs is updated from the swaps alone instead of being rebuilt.
+ *
+ *  Both axes are swept. Sorting x alone would leave every pair of bodies sharing a column in the
+ *  pair set, which for scattered scenes is far more pairs than actually touch.
+ *
+ *  Pairs and events are tracked by body slot so they survive swap-remove reordering of the
+ *  body store.
+ *
+ */
+
+#ifndef _INC_SWEEPPRUNE_H
+#define _INC_SWEEPPRUNE_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define SWEEPPRUNE_REBUILD_FRACTION 8                           // re-sort from scratch once 1/8th of the bodies are new
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "common.h"
+#include "bodystore.h"
+#include "broadphase.h"
+#include "pairmap.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// one end of a body's interval on one axis
+typedef struct sweepprune_endpoint_t
+{
+
+    float               value;                                  // coordinate of the endpoint
+    uint32_t            id;                                     // body slot << 1, low bit set for the max endpoint
+
+} sweepprune_endpoint_t;
+
+struct sweepprune_t
+{
+
+    uint32_t                endpoint_count;                     // two per tracked body, on each axis
+    uint32_t                endpoint_capacity;
+    sweepprune_endpoint_t   *endpoints[2];                      // x then y, sorted by value, max before min on ties
+
+    uint32_t                slot_capacity;
+    uint32_t                *tracked;                           // generation each slot was tracked at, UINT32_MAX if untracked
+
+    pairmap_t               overlaps;                           // overlapping pairs of slots, value holds SWEEPPRUNE_* flags
+
+    uint32_t                active_capacity;
+    uint32_t                *active;                            // scratch list of open intervals for full rebuilds
+
+    broadphase_pairs_t      began;                              // slot pairs that started overlapping this frame
+    broadphase_pairs_t      ended;                              // slot pairs that stopped overlapping this frame
+
+    uint32_t                swaps;                              // endpoint swaps the last re-sort needed, both axes
+
+};
+
+/* ---------------------------------------------------------------------------------------- */
+
+void sweepprune_init(sweepprune_t *sap);
+void sweepprune_destroy(sweepprune_t *sap);
+void sweepprune_find_pairs(sweepprune_t *sap, const bodystore_t *bodies, broadphase_pairs_t *pairs);
+
+#endif
@@ -18,6 +18,14 @@ typedef struct userinteractions_t
     
     bool space_pressed;
     bool escape_pressed;
+    bool plus_pressed;
+    bool minus_pressed;
+    bool c_pressed;
+    bool left_pressed;
+    bool right_pressed;
+
+    int32_t mouse_x;
+    int32_t mouse_y;
 
 } userinteractions_t;
 
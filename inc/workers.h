@@ -0,0 +1,132 @@
+/*
+ *  workers.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ *
+ *  Work-stealing job system. Every thread, the one that created the pool included, has a deque
+ *  of work items: it pushes and pops at the back of its own and, once that runs dry, steals from
+ *  the front of the others'. Threads that find nothing to steal for a while go to sleep until
+ *  new work is pushed.
+ *
+ *  workers_parallel_for splits a loop lazily: a thread running a range bigger than the grain
+ *  pushes its upper half for someone else to steal and keeps splitting the lower half, so a
+ *  loop is only cut as finely as idle threads ask for. Range bounds are always multiples of the
+ *  grain, so a loop with a fixed grain is cut the same way on any number of threads. The caller
+ *  runs work, its own loop's or anyone's, until the loop is done.
+ *
+ *  A graph is a fixed set of tasks where a task may wait on up to WORKERS_MAX_DEPENDENTS others.
+ *  Running it pushes the tasks nothing waits on, each finished task pushes the ones it released,
+ *  and workers_graph_run returns once every task has run. Tasks may call workers_parallel_for.
+ *  Each task keeps the time each thread spent on it and on the loops it started, which is how
+ *  its parallel efficiency is measured.
+ *
+ *  Work is handed to the pool by one thread outside it at a time, which acts as worker 0.
+ *
+ */
+
+#ifndef _INC_WORKERS_H
+#define _INC_WORKERS_H
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define WORKERS_MAX 64                                          // most threads a pool runs, the caller included
+#define WORKERS_DEQUE_SIZE 1024                                 // items a deque holds, pushes past it run on the spot
+#define WORKERS_CHUNKS_PER_WORKER 8                             // chunks per thread an automatic grain cuts a loop into
+#define WORKERS_SPINS 1024                                      // empty steal rounds before a thread sleeps or yields
+#define WORKERS_MAX_TASKS 16                                    // tasks a graph holds
+#define WORKERS_MAX_DEPENDENTS 8                                // tasks that can wait on one task
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "SDL2/SDL.h"
+#include "common.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+typedef struct workers_graph_t workers_graph_t;
+typedef struct workers_task_t workers_task_t;
+typedef struct workers_loop_t workers_loop_t;
+
+// runs [begin, end) of a loop, worker tells which thread is running it (0 is the pool's creator)
+typedef void (*workers_range_t)(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+
+// runs a graph task
+typedef void (*workers_func_t)(uint32_t worker, void *context);
+
+// one entry of a deque, a range of a loop or a whole task
+typedef struct workers_item_t
+{
+
+    workers_loop_t      *loop;                                  // NULL for a task
+    workers_task_t      *task;
+    uint32_t            begin, end;
+
+} workers_item_t;
+
+typedef struct workers_deque_t
+{
+
+    SDL_SpinLock        lock;
+    uint32_t            head;                                   // where thieves take from, only ever grows
+    uint32_t            tail;                                   // where the owner pushes and pops
+    workers_item_t      items[WORKERS_DEQUE_SIZE];              // indexed by head and tail modulo the size
+
+} workers_deque_t;
+
+struct workers_task_t
+{
+
+    const char          *name;
+    workers_func_t      func;
+    void                *context;
+    workers_graph_t     *graph;
+
+    uint32_t            dependencies;                           // tasks this one waits on
+    SDL_atomic_t        pending;                                // of those, how many haven't finished this run
+    uint32_t            dependent_count;
+    workers_task_t      *dependents[WORKERS_MAX_DEPENDENTS];    // tasks waiting on this one
+
+    uint32_t            runs;                                   // runs timed since the last report
+    uint64_t            start;                                  // performance counter when the current run began
+    uint64_t            wall;                                   // time from start to finish, summed over runs
+    uint64_t            busy[WORKERS_MAX];                      // time each thread spent on it or its loops, summed over runs
+
+};
+
+struct workers_graph_t
+{
+
+    uint32_t            count;
+    workers_task_t      tasks[WORKERS_MAX_TASKS];
+    SDL_atomic_t        remaining;                              // tasks of the current run that haven't finished
+
+};
+
+typedef struct workers_t
+{
+
+    uint32_t            count;                                  // threads working, the caller included
+    SDL_Thread          *threads[WORKERS_MAX];
+    workers_deque_t     *deques;                                // one per thread
+    SDL_atomic_t        started;                                // threads that have taken a worker number
+
+    SDL_sem             *wake;                                  // posted once for each sleeping thread new work wakes
+    SDL_atomic_t        sleeping;                               // threads asleep or about to be that no post is owed to yet
+    SDL_atomic_t        quit;
+
+} workers_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+void workers_init(workers_t *workers, uint32_t count);
+void workers_destroy(workers_t *workers);
+void workers_parallel_for(workers_t *workers, uint32_t total, uint32_t grain, workers_range_t job, void *context);
+
+void workers_graph_init(workers_graph_t *graph);
+workers_task_t* workers_graph_add(workers_graph_t *graph, const char *name, workers_func_t func, void *context);
+void workers_graph_depend(workers_task_t *task, workers_task_t *on);
+void workers_graph_run(workers_t *workers, workers_graph_t *graph);
+void workers_graph_report(const workers_t *workers, workers_graph_t *graph);
+
+#endif
@@ -0,0 +1,616 @@
+/*
+ *  aabbtree.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/bodystore.h"
+#include "../inc/broadphase.h"
+#include "../inc/aabbtree.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define AABBTREE_MIN_NODES 64                                   // smallest node pool the tree grows from
+#define AABBTREE_UNTRACKED UINT32_MAX
+
+/* ---------------------------------------------------------------------------------------- */
+
+// what aabbtree_emit_pair needs while walking the candidate pairs
+typedef struct aabbtree_emit_t
+{
+
+    aabbtree_t              *tree;
+    const bodystore_t       *bodies;
+    broadphase_pairs_t      *pairs;
+
+} aabbtree_emit_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+static uint32_t aabbtree_alloc_node(aabbtree_t *tree);
+static void aabbtree_free_node(aabbtree_t *tree, uint32_t node);
+static void aabbtree_insert_leaf(aabbtree_t *tree, uint32_t leaf);
+static void aabbtree_remove_leaf(aabbtree_t *tree, uint32_t leaf);
+static void aabbtree_refit_upwards(aabbtree_t *tree, uint32_t node);
+static uint32_t aabbtree_balance(aabbtree_t *tree, uint32_t a);
+static void aabbtree_set_union(aabbtree_node_t *dst, const aabbtree_node_t *a, const aabbtree_node_t *b);
+static void aabbtree_fatten(aabbtree_node_t *node, const bodystore_t *bodies, uint32_t i);
+static float aabbtree_union_perimeter(const aabbtree_node_t *a, const aabbtree_node_t *b);
+static float aabbtree_perimeter(const aabbtree_node_t *node);
+static void aabbtree_push(aabbtree_t *tree, uint32_t *top, uint32_t node);
+static void aabbtree_mark_moved(aabbtree_t *tree, uint32_t slot);
+static bool aabbtree_emit_pair(uint64_t key, void *value, void *context);
+
+/* ---------------------------------------------------------------------------------------- */
+
+void aabbtree_init(aabbtree_t *tree)
+{
+
+    memset(tree, 0, sizeof(aabbtree_t));
+
+    tree->root      = AABBTREE_NULL;
+    tree->free_node = AABBTREE_NULL;
+
+    pairmap_init(&tree->candidates, sizeof(uint8_t), 0);
+
+}
+
+void aabbtree_destroy(aabbtree_t *tree)
+{
+
+    free(tree->nodes);
+    free(tree->leaf);
+    free(tree->tracked);
+    free(tree->moved);
+    free(tree->stack);
+
+    pairmap_destroy(&tree->candidates);
+
+    memset(tree, 0, sizeof(aabbtree_t));
+
+}
+
+// brings the leaves in line with the body store: drops removed bodies, adds new ones and
+// reinserts the ones that moved out of their fat box
+void aabbtree_update(aabbtree_t *tree, const bodystore_t *bodies)
+{
+
+    aabbtree_node_t *node;
+    uint32_t i, slot, leaf, old_capacity;
+
+    if (bodies->slot_count > tree->slot_capacity)
+    {
+        old_capacity = tree->slot_capacity;
+        tree->slot_capacity = bodies->slot_capacity;
+        tree->leaf    = realloc(tree->leaf,    tree->slot_capacity * sizeof(uint32_t));
+        tree->tracked = realloc(tree->tracked, tree->slot_capacity * sizeof(uint32_t));
+        memset(tree->leaf    + old_capacity, 0xFF, (tree->slot_capacity - old_capacity) * sizeof(uint32_t));
+        memset(tree->tracked + old_capacity, 0xFF, (tree->slot_capacity - old_capacity) * sizeof(uint32_t));
+    }
+
+    // a slot whose generation moved on was removed (and maybe reused)
+    for (slot = 0; slot < bodies->slot_count; slot++)
+    {
+        if (tree->tracked[slot] != AABBTREE_UNTRACKED && tree->tracked[slot] != bodies->slot_generation[slot])
+        {
+            aabbtree_remove_leaf(tree, tree->leaf[slot]);
+            aabbtree_free_node(tree, tree->leaf[slot]);
+            tree->leaf[slot]    = AABBTREE_NULL;
+            tree->tracked[slot] = AABBTREE_UNTRACKED;
+        }
+    }
+
+    // sleeping bodies don't move, so their leaves can't have left their fat boxes
+    for (i = 0; i < bodies->awake_count; i++)
+    {
+
+        slot = bodies->slot[i];
+        leaf = tree->leaf[slot];
+
+        if (leaf == AABBTREE_NULL)
+        {
+
+            leaf = aabbtree_alloc_node(tree);
+
+            node = &tree->nodes[leaf];
+            node->slot = slot;
+            aabbtree_fatten(node, bodies, i);
+
+            tree->leaf[slot]    = leaf;
+            tree->tracked[slot] = bodies->slot_generation[slot];
+
+            aabbtree_insert_leaf(tree, leaf);
+            aabbtree_mark_moved(tree, slot);
+            continue;
+
+        }
+
+        node = &tree->nodes[leaf];
+
+        if (bodies->x_pos[i] < node->min_x || bodies->x_pos[i] + bodies->width[i]  > node->max_x ||
+            bodies->y_pos[i] < node->min_y || bodies->y_pos[i] + bodies->height[i] > node->max_y)
+        {
+            aabbtree_remove_leaf(tree, leaf);
+            aabbtree_fatten(&tree->nodes[leaf], bodies, i);
+            aabbtree_insert_leaf(tree, leaf);
+            aabbtree_mark_moved(tree, slot);
+        }
+
+    }
+
+}
+
+// updates the tree and the candidate pairs, then reports every candidate whose real boxes overlap
+void aabbtree_find_pairs(aabbtree_t *tree, const bodystore_t *bodies, broadphase_pairs_t *pairs)
+{
+
+    aabbtree_emit_t emit = { tree, bodies, pairs };
+    const aabbtree_node_t *node;
+    uint32_t m, slot, leaf, top, index;
+    float min_x, min_y, max_x, max_y;
+
+    aabbtree_update(tree, bodies);
+
+    pairs->count = 0;
+
+    // only leaves that got a new fat box can have gained a candidate
+    for (m = 0; m < tree->move_count; m++)
+    {
+
+        slot = tree->moved[m];
+        leaf = tree->leaf[slot];
+
+        if (leaf == AABBTREE_NULL) continue;
+
+        min_x = tree->nodes[leaf].min_x;
+        min_y = tree->nodes[leaf].min_y;
+        max_x = tree->nodes[leaf].max_x;
+        max_y = tree->nodes[leaf].max_y;
+
+        top = 0;
+        aabbtree_push(tree, &top, tree->root);
+
+        while (top > 0)
+        {
+
+            index = tree->stack[--top];
+            node  = &tree->nodes[index];
+
+            if (node->max_x <= min_x || max_x <= node->min_x || node->max_y <= min_y || max_y <= node->min_y) continue;
+
+            if (node->height > 0)
+            {
+                aabbtree_push(tree, &top, node->child1);
+                aabbtree_push(tree, &top, tree->nodes[index].child2);
+                continue;
+            }
+
+            if (index != leaf)
+            {
+                pairmap_insert(&tree->candidates, pairmap_key(slot, node->slot), NULL);
+            }
+
+        }
+
+    }
+
+    tree->move_count = 0;
+
+    pairmap_retain(&tree->candidates, aabbtree_emit_pair, &emit);
+
+}
+
+// calls callback with the dense index of every body whose box overlaps the region, until it returns
+// false. Only bodies inside their fat box as of the last update are guaranteed to be found
+void aabbtree_query(aabbtree_t *tree, const bodystore_t *bodies, float min_x, float min_y, float max_x, float max_y, broadphase_query_t callback, void *context)
+{
+
+    const aabbtree_node_t *node;
+    uint32_t top, index, j;
+
+    if (tree->root == AABBTREE_NULL)
+    {
+        return;
+    }
+
+    top = 0;
+    aabbtree_push(tree, &top, tree->root);
+
+    while (top > 0)
+    {
+
+        index = tree->stack[--top];
+        node  = &tree->nodes[index];
+
+        if (node->max_x <= min_x || max_x <= node->min_x || node->max_y <= min_y || max_y <= node->min_y) continue;
+
+        if (node->height > 0)
+        {
+            aabbtree_push(tree, &top, node->child1);
+            aabbtree_push(tree, &top, tree->nodes[index].child2);
+            continue;
+        }
+
+        j = bodies->slot_index[node->slot];
+
+        if (bodies->x_pos[j] < max_x && min_x < bodies->x_pos[j] + bodies->width[j] &&
+            bodies->y_pos[j] < max_y && min_y < bodies->y_pos[j] + bodies->height[j])
+        {
+            if (!callback(j, context)) return;
+        }
+
+    }
+
+}
+
+// height of the tree, 0 for a single leaf and -1 when empty
+int32_t aabbtree_height(const aabbtree_t *tree)
+{
+    return tree->root == AABBTREE_NULL ? -1 : tree->nodes[tree->root].height;
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// takes a node off the free list, growing the pool when it's empty. Invalidates node pointers
+static uint32_t aabbtree_alloc_node(aabbtree_t *tree)
+{
+
+    uint32_t node = tree->free_node;
+
+    if (node == AABBTREE_NULL)
+    {
+
+        if (tree->node_count >= tree->node_capacity)
+        {
+            tree->node_capacity = tree->node_capacity ? tree->node_capacity * 2 : AABBTREE_MIN_NODES;
+            tree->nodes = realloc(tree->nodes, tree->node_capacity * sizeof(aabbtree_node_t));
+        }
+
+        node = tree->node_count++;
+
+    }
+    else
+    {
+        tree->free_node = tree->nodes[node].parent;
+    }
+
+    tree->nodes[node].parent = AABBTREE_NULL;
+    tree->nodes[node].child1 = AABBTREE_NULL;
+    tree->nodes[node].child2 = AABBTREE_NULL;
+    tree->nodes[node].height = 0;
+    tree->nodes[node].slot   = UINT32_MAX;
+
+    return node;
+
+}
+
+static void aabbtree_free_node(aabbtree_t *tree, uint32_t node)
+{
+
+    tree->nodes[node].parent = tree->free_node;
+    tree->nodes[node].height = -1;
+    tree->free_node = node;
+
+}
+
+// walks down picking the cheapest sibling by perimeter, then splices the leaf in beside it
+static void aabbtree_insert_leaf(aabbtree_t *tree, uint32_t leaf)
+{
+
+    aabbtree_node_t *nodes;
+    uint32_t index, sibling, old_parent, new_parent, child1, child2;
+    float area, combined, cost, inheritance, cost1, cost2;
+
+    if (tree->root == AABBTREE_NULL)
+    {
+        tree->root = leaf;
+        tree->nodes[leaf].parent = AABBTREE_NULL;
+        return;
+    }
+
+    // allocate the new parent up front, it may move the node pool
+    new_parent = aabbtree_alloc_node(tree);
+    nodes = tree->nodes;
+
+    index = tree->root;
+    while (nodes[index].height > 0)
+    {
+
+        child1 = nodes[index].child1;
+        child2 = nodes[index].child2;
+
+        area     = aabbtree_perimeter(&nodes[index]);
+        combined = aabbtree_union_perimeter(&nodes[index], &nodes[leaf]);
+
+        // cost of pairing the leaf with this node, and the cost pushed down onto either child
+        cost        = 2.0f * combined;
+        inheritance = 2.0f * (combined - area);
+
+        cost1 = aabbtree_union_perimeter(&nodes[leaf], &nodes[child1]) + inheritance;
+        cost2 = aabbtree_union_perimeter(&nodes[leaf], &nodes[child2]) + inheritance;
+
+        if (nodes[child1].height > 0) cost1 -= aabbtree_perimeter(&nodes[child1]);
+        if (nodes[child2].height > 0) cost2 -= aabbtree_perimeter(&nodes[child2]);
+
+        if (cost < cost1 && cost < cost2) break;
+
+        index = cost1 < cost2 ? child1 : child2;
+
+    }
+
+    sibling    = index;
+    old_parent = nodes[sibling].parent;
+
+    nodes[new_parent].parent = old_parent;
+    nodes[new_parent].child1 = sibling;
+    nodes[new_parent].child2 = leaf;
+    nodes[new_parent].height = nodes[sibling].height + 1;
+    aabbtree_set_union(&nodes[new_parent], &nodes[sibling], &nodes[leaf]);
+
+    if (old_parent != AABBTREE_NULL)
+    {
+        if (nodes[old_parent].child1 == sibling) nodes[old_parent].child1 = new_parent;
+        else                                     nodes[old_parent].child2 = new_parent;
+    }
+    else
+    {
+        tree->root = new_parent;
+    }
+
+    nodes[sibling].parent = new_parent;
+    nodes[leaf].parent    = new_parent;
+
+    aabbtree_refit_upwards(tree, nodes[leaf].parent);
+
+}
+
+// unlinks a leaf, its parent is freed and the sibling takes the parent's place
+static void aabbtree_remove_leaf(aabbtree_t *tree, uint32_t leaf)
+{
+
+    aabbtree_node_t *nodes = tree->nodes;
+    uint32_t parent, grandparent, sibling;
+
+    if (leaf == tree->root)
+    {
+        tree->root = AABBTREE_NULL;
+        return;
+    }
+
+    parent      = nodes[leaf].parent;
+    grandparent = nodes[parent].parent;
+    sibling     = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandparent != AABBTREE_NULL)
+    {
+
+        if (nodes[grandparent].child1 == parent) nodes[grandparent].child1 = sibling;
+        else                                     nodes[grandparent].child2 = sibling;
+
+        nodes[sibling].parent = grandparent;
+        aabbtree_free_node(tree, parent);
+
+        aabbtree_refit_upwards(tree, grandparent);
+
+    }
+    else
+    {
+        tree->root = sibling;
+        nodes[sibling].parent = AABBTREE_NULL;
+        aabbtree_free_node(tree, parent);
+    }
+
+    nodes[leaf].parent = AABBTREE_NULL;
+
+}
+
+// rebalances and recomputes boxes and heights from node up to the root
+static void aabbtree_refit_upwards(aabbtree_t *tree, uint32_t node)
+{
+
+    aabbtree_node_t *nodes = tree->nodes;
+    uint32_t child1, child2;
+
+    while (node != AABBTREE_NULL)
+    {
+
+        node = aabbtree_balance(tree, node);
+
+        child1 = nodes[node].child1;
+        child2 = nodes[node].child2;
+
+        nodes[node].height = 1 + SDL_max(nodes[child1].height, nodes[child2].height);
+        aabbtree_set_union(&nodes[node], &nodes[child1], &nodes[child2]);
+
+        node = nodes[node].parent;
+
+    }
+
+}
+
+// if a's subtrees differ in height by more than one, rotates the taller child up into a's place.
+// Returns the node now sitting where a was
+static uint32_t aabbtree_balance(aabbtree_t *tree, uint32_t a)
+{
+
+    aabbtree_node_t *nodes = tree->nodes;
+    uint32_t b, c, up, low, grandchild1, grandchild2, tall, short_;
+    int32_t balance;
+
+    if (nodes[a].height < 2)
+    {
+        return a;
+    }
+
+    b = nodes[a].child1;
+    c = nodes[a].child2;
+    balance = nodes[c].height - nodes[b].height;
+
+    if (balance >= -1 && balance <= 1)
+    {
+        return a;
+    }
+
+    // up is the taller child that replaces a, low is the child that stays under a
+    up  = balance > 1 ? c : b;
+    low = balance > 1 ? b : c;
+
+    grandchild1 = nodes[up].child1;
+    grandchild2 = nodes[up].child2;
+
+    // up takes a's place under a's parent
+    nodes[up].child1 = a;
+    nodes[up].parent = nodes[a].parent;
+    nodes[a].parent  = up;
+
+    if (nodes[up].parent != AABBTREE_NULL)
+    {
+        if (nodes[nodes[up].parent].child1 == a) nodes[nodes[up].parent].child1 = up;
+        else                                     nodes[nodes[up].parent].child2 = up;
+    }
+    else
+    {
+        tree->root = up;
+    }
+
+    // up keeps its taller grandchild, the shorter one moves under a in up's old place
+    tall   = nodes[grandchild1].height > nodes[grandchild2].height ? grandchild1 : grandchild2;
+    short_ = tall == grandchild1 ? grandchild2 : grandchild1;
+
+    nodes[up].child2 = tall;
+
+    if (balance > 1) nodes[a].child2 = short_;
+    else             nodes[a].child1 = short_;
+
+    nodes[short_].parent = a;
+
+    aabbtree_set_union(&nodes[a], &nodes[low], &nodes[short_]);
+    nodes[a].height = 1 + SDL_max(nodes[low].height, nodes[short_].height);
+
+    aabbtree_set_union(&nodes[up], &nodes[a], &nodes[tall]);
+    nodes[up].height = 1 + SDL_max(nodes[a].height, nodes[tall].height);
+
+    return up;
+
+}
+
+static void aabbtree_set_union(aabbtree_node_t *dst, const aabbtree_node_t *a, const aabbtree_node_t *b)
+{
+
+    dst->min_x = SDL_min(a->min_x, b->min_x);
+    dst->min_y = SDL_min(a->min_y, b->min_y);
+    dst->max_x = SDL_max(a->max_x, b->max_x);
+    dst->max_y = SDL_max(a->max_y, b->max_y);
+
+}
+
+// sets a leaf's box to body i's box grown by the margin
+static void aabbtree_fatten(aabbtree_node_t *node, const bodystore_t *bodies, uint32_t i)
+{
+
+    float margin_x = AABBTREE_MARGIN + AABBTREE_MARGIN_FRACTION * bodies->width[i];
+    float margin_y = AABBTREE_MARGIN + AABBTREE_MARGIN_FRACTION * bodies->height[i];
+
+    node->min_x = bodies->x_pos[i] - margin_x;
+    node->min_y = bodies->y_pos[i] - margin_y;
+    node->max_x = bodies->x_pos[i] + bodies->width[i]  + margin_x;
+    node->max_y = bodies->y_pos[i] + bodies->height[i] + margin_y;
+
+}
+
+static float aabbtree_union_perimeter(const aabbtree_node_t *a, const aabbtree_node_t *b)
+{
+
+    float w = SDL_max(a->max_x, b->max_x) - SDL_min(a->min_x, b->min_x);
+    float h = SDL_max(a->max_y, b->max_y) - SDL_min(a->min_y, b->min_y);
+
+    return 2.0f * (w + h);
+
+}
+
+static float aabbtree_perimeter(const aabbtree_node_t *node)
+{
+    return 2.0f * ((node->max_x - node->min_x) + (node->max_y - node->min_y));
+}
+
+// pushes onto the traversal stack, growing it when full
+static void aabbtree_push(aabbtree_t *tree, uint32_t *top, uint32_t node)
+{
+
+    if (*top >= tree->stack_capacity)
+    {
+        tree->stack_capacity = tree->stack_capacity ? tree->stack_capacity * 2 : AABBTREE_MIN_NODES;
+        tree->stack = realloc(tree->stack, tree->stack_capacity * sizeof(uint32_t));
+    }
+
+    tree->stack[(*top)++] = node;
+
+}
+
+// remembers a leaf that got a new fat box, so find_pairs looks for its new candidates
+static void aabbtree_mark_moved(aabbtree_t *tree, uint32_t slot)
+{
+
+    if (tree->move_count >= tree->move_capacity)
+    {
+        tree->move_capacity = tree->move_capacity ? tree->move_capacity * 2 : AABBTREE_MIN_NODES;
+        tree->moved = realloc(tree->moved, tree->move_capacity * sizeof(uint32_t));
+    }
+
+    tree->moved[tree->move_count++] = slot;
+
+}
+
+// drops candidates whose bodies are gone or whose fat boxes came apart, and reports the rest if
+// the bodies' real boxes overlap and one of them is awake
+static bool aabbtree_emit_pair(uint64_t key, void *value, void *context)
+{
+
+    aabbtree_emit_t *emit = context;
+    const bodystore_t *bodies = emit->bodies;
+    const aabbtree_node_t *a, *b;
+    uint32_t leaf_a, leaf_b, i, j;
+
+    (void)value;
+
+    leaf_a = emit->tree->leaf[pairmap_key_lo(key)];
+    leaf_b = emit->tree->leaf[pairmap_key_hi(key)];
+
+    if (leaf_a == AABBTREE_NULL || leaf_b == AABBTREE_NULL)
+    {
+        return false;
+    }
+
+    i = bodies->slot_index[pairmap_key_lo(key)];
+    j = bodies->slot_index[pairmap_key_hi(key)];
+
+    // two sleeping bodies haven't moved, so they're still a candidate and still not touching
+    if (i >= bodies->awake_count && j >= bodies->awake_count)
+    {
+        return true;
+    }
+
+    a = &emit->tree->nodes[leaf_a];
+    b = &emit->tree->nodes[leaf_b];
+
+    if (a->max_x <= b->min_x || b->max_x <= a->min_x || a->max_y <= b->min_y || b->max_y <= a->min_y)
+    {
+        return false;
+    }
+
+    if (bodies->x_pos[i] < bodies->x_pos[j] + bodies->width[j]  && bodies->x_pos[j] < bodies->x_pos[i] + bodies->width[i] &&
+        bodies->y_pos[i] < bodies->y_pos[j] + bodies->height[j] && bodies->y_pos[j] < bodies->y_pos[i] + bodies->height[i])
+    {
+        broadphase_pairs_push(emit->pairs, i < j ? i : j, i < j ? j : i);
+    }
+
+    return true;
+
+}
@@ -0,0 +1,456 @@
+/*
+ *  bodystore.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/bodystore.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+static void* bodystore_grow_array(void *array, uint32_t old_capacity, uint32_t new_capacity, size_t element_size);
+static void bodystore_move(bodystore_t *store, uint32_t dst, uint32_t src);
+static void bodystore_swap(bodystore_t *store, uint32_t i, uint32_t j);
+static uint32_t bodystore_alloc_slot(bodystore_t *store);
+static uint64_t bodystore_hash_floats(uint64_t hash, const float *values, uint32_t count);
+
+/* ---------------------------------------------------------------------------------------- */
+
+// sets up an empty store with room for at least capacity bodies
+void bodystore_init(bodystore_t *store, uint32_t capacity)
+{
+
+    memset(store, 0, sizeof(bodystore_t));
+
+    store->free_slot = UINT32_MAX;
+
+    bodystore_reserve(store, capacity);
+
+}
+
+void bodystore_destroy(bodystore_t *store)
+{
+
+    SDL_SIMDFree(store->x_pos);
+    SDL_SIMDFree(store->y_pos);
+    SDL_SIMDFree(store->prev_x_pos);
+    SDL_SIMDFree(store->prev_y_pos);
+    SDL_SIMDFree(store->x_vel);
+    SDL_SIMDFree(store->y_vel);
+    SDL_SIMDFree(store->x_acc);
+    SDL_SIMDFree(store->y_acc);
+    SDL_SIMDFree(store->intr_x_vel);
+    SDL_SIMDFree(store->intr_y_vel);
+    SDL_SIMDFree(store->intr_x_acc);
+    SDL_SIMDFree(store->intr_y_acc);
+    SDL_SIMDFree(store->ext_x_acc);
+    SDL_SIMDFree(store->ext_y_acc);
+    SDL_SIMDFree(store->mass);
+    SDL_SIMDFree(store->width);
+    SDL_SIMDFree(store->height);
+    SDL_SIMDFree(store->momentum);
+    SDL_SIMDFree(store->friction);
+    SDL_SIMDFree(store->restitution);
+    SDL_SIMDFree(store->sleep_frames);
+    SDL_SIMDFree(store->color);
+    SDL_SIMDFree(store->slot);
+
+    free(store->slot_index);
+    free(store->slot_generation);
+
+    memset(store, 0, sizeof(bodystore_t));
+
+}
+
+// grows every array so at least capacity bodies fit, rounded up so SIMD passes never run off the end
+void bodystore_reserve(bodystore_t *store, uint32_t capacity)
+{
+
+    uint32_t old_capacity = store->capacity;
+
+    if (capacity <= old_capacity)
+    {
+        return;
+    }
+
+    if (capacity < BODYSTORE_MIN_CAPACITY) capacity = BODYSTORE_MIN_CAPACITY;
+    capacity = (capacity + BODYSTORE_ALIGNMENT - 1) & ~(uint32_t)(BODYSTORE_ALIGNMENT - 1);
+
+    store->x_pos      = bodystore_grow_array(store->x_pos,      old_capacity, capacity, sizeof(float));
+    store->y_pos      = bodystore_grow_array(store->y_pos,      old_capacity, capacity, sizeof(float));
+    store->prev_x_pos = bodystore_grow_array(store->prev_x_pos, old_capacity, capacity, sizeof(float));
+    store->prev_y_pos = bodystore_grow_array(store->prev_y_pos, old_capacity, capacity, sizeof(float));
+    store->x_vel      = bodystore_grow_array(store->x_vel,      old_capacity, capacity, sizeof(float));
+    store->y_vel      = bodystore_grow_array(store->y_vel,      old_capacity, capacity, sizeof(float));
+    store->x_acc      = bodystore_grow_array(store->x_acc,      old_capacity, capacity, sizeof(float));
+    store->y_acc      = bodystore_grow_array(store->y_acc,      old_capacity, capacity, sizeof(float));
+    store->intr_x_vel = bodystore_grow_array(store->intr_x_vel, old_capacity, capacity, sizeof(float));
+    store->intr_y_vel = bodystore_grow_array(store->intr_y_vel, old_capacity, capacity, sizeof(float));
+    store->intr_x_acc = bodystore_grow_array(store->intr_x_acc, old_capacity, capacity, sizeof(float));
+    store->intr_y_acc = bodystore_grow_array(store->intr_y_acc, old_capacity, capacity, sizeof(float));
+    store->ext_x_acc  = bodystore_grow_array(store->ext_x_acc,  old_capacity, capacity, sizeof(float));
+    store->ext_y_acc  = bodystore_grow_array(store->ext_y_acc,  old_capacity, capacity, sizeof(float));
+    store->mass       = bodystore_grow_array(store->mass,       old_capacity, capacity, sizeof(float));
+    store->width      = bodystore_grow_array(store->width,      old_capacity, capacity, sizeof(float));
+    store->height     = bodystore_grow_array(store->height,     old_capacity, capacity, sizeof(float));
+    store->momentum   = bodystore_grow_array(store->momentum,   old_capacity, capacity, sizeof(float));
+    store->friction   = bodystore_grow_array(store->friction,   old_capacity, capacity, sizeof(float));
+    store->restitution = bodystore_grow_array(store->restitution, old_capacity, capacity, sizeof(float));
+    store->sleep_frames = bodystore_grow_array(store->sleep_frames, old_capacity, capacity, sizeof(uint32_t));
+    store->color      = bodystore_grow_array(store->color,      old_capacity, capacity, sizeof(uint32_t));
+    store->slot       = bodystore_grow_array(store->slot,       old_capacity, capacity, sizeof(uint32_t));
+
+    store->capacity = capacity;
+
+}
+
+// copies an object's state onto the end of the awake bodies, growing the arrays if needed
+body_handle_t bodystore_insert(bodystore_t *store, const simobject_t *obj)
+{
+
+    uint32_t i = store->count;
+    uint32_t slot;
+
+    if (i >= store->capacity)
+    {
+        bodystore_reserve(store, store->capacity ? store->capacity * 2 : BODYSTORE_MIN_CAPACITY);
+    }
+
+    slot = bodystore_alloc_slot(store);
+
+    store->x_pos[i]      = obj->x_pos;
+    store->y_pos[i]      = obj->y_pos;
+    store->prev_x_pos[i] = obj->x_pos;
+    store->prev_y_pos[i] = obj->y_pos;
+    store->x_vel[i]      = obj->x_vel;
+    store->y_vel[i]      = obj->y_vel;
+    store->x_acc[i]      = obj->x_acc;
+    store->y_acc[i]      = obj->y_acc;
+    store->intr_x_vel[i] = obj->intr_x_vel;
+    store->intr_y_vel[i] = obj->intr_y_vel;
+    store->intr_x_acc[i] = obj->intr_x_acc;
+    store->intr_y_acc[i] = obj->intr_y_acc;
+    store->ext_x_acc[i]  = 0.0f;
+    store->ext_y_acc[i]  = 0.0f;
+    store->mass[i]       = obj->mass;
+    store->width[i]      = obj->width;
+    store->height[i]     = obj->height;
+    store->momentum[i]   = obj->momentum;
+    store->friction[i]   = obj->friction;
+    store->restitution[i] = obj->restitution;
+    store->sleep_frames[i] = 0;
+    store->color[i]      = ((uint32_t)obj->color_r << 24) | (obj->color_g << 16) | (obj->color_b << 8) | 0xFF;
+    store->slot[i]       = slot;
+
+    store->slot_index[slot] = i;
+
+    store->count++;
+
+    // new bodies start awake, in front of any sleeping ones
+    if (i != store->awake_count)
+    {
+        bodystore_swap(store, i, store->awake_count);
+    }
+
+    store->awake_count++;
+
+    return (body_handle_t){ slot, store->slot_generation[slot] };
+
+}
+
+// inserts count objects with a single grow, writing their handles out if handles isn't NULL
+void bodystore_insert_many(bodystore_t *store, const simobject_t *objs, uint32_t count, body_handle_t *handles)
+{
+
+    body_handle_t handle;
+
+    bodystore_reserve(store, store->count + count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+
+        handle = bodystore_insert(store, &objs[i]);
+
+        if (handles)
+        {
+            handles[i] = handle;
+        }
+
+    }
+
+}
+
+// removes a body by moving the last body into its place, returns false for stale handles. An
+// awake body's place is first filled by the last awake body, so the awake ones stay packed
+bool bodystore_remove(bodystore_t *store, body_handle_t handle)
+{
+
+    uint32_t i = bodystore_lookup(store, handle);
+    uint32_t last;
+
+    if (i == UINT32_MAX)
+    {
+        return false;
+    }
+
+    if (i < store->awake_count)
+    {
+
+        last = --store->awake_count;
+
+        if (i != last)
+        {
+            bodystore_move(store, i, last);
+            store->slot_index[store->slot[i]] = i;
+        }
+
+        i = last;
+
+    }
+
+    last = store->count - 1;
+
+    if (i != last)
+    {
+        bodystore_move(store, i, last);
+        store->slot_index[store->slot[i]] = i;
+    }
+
+    store->count--;
+
+    // retire the slot, invalidating every outstanding handle to it
+    store->slot_generation[handle.slot]++;
+    store->slot_index[handle.slot] = store->free_slot;
+    store->free_slot = handle.slot;
+
+    return true;
+
+}
+
+// dense index of the body a handle refers to, or UINT32_MAX if the handle is stale
+uint32_t bodystore_lookup(const bodystore_t *store, body_handle_t handle)
+{
+
+    if (handle.slot >= store->slot_count || store->slot_generation[handle.slot] != handle.generation)
+    {
+        return UINT32_MAX;
+    }
+
+    return store->slot_index[handle.slot];
+
+}
+
+// handle to the body currently at a dense index
+body_handle_t bodystore_handle(const bodystore_t *store, uint32_t index)
+{
+
+    uint32_t slot = store->slot[index];
+
+    return (body_handle_t){ slot, store->slot_generation[slot] };
+
+}
+
+// remembers every body's current position as the one to interpolate from
+void bodystore_save_positions(bodystore_t *store)
+{
+
+    memcpy(store->prev_x_pos, store->x_pos, store->count * sizeof(float));
+    memcpy(store->prev_y_pos, store->y_pos, store->count * sizeof(float));
+
+}
+
+// puts an awake body to sleep by moving it behind the awake ones, returns its new dense index
+uint32_t bodystore_sleep(bodystore_t *store, uint32_t index)
+{
+
+    uint32_t last = --store->awake_count;
+
+    store->x_vel[index] = 0.0f;
+    store->y_vel[index] = 0.0f;
+
+    bodystore_swap(store, index, last);
+
+    return last;
+
+}
+
+// wakes a sleeping body by moving it to the end of the awake ones, returns its new dense index
+uint32_t bodystore_wake(bodystore_t *store, uint32_t index)
+{
+
+    uint32_t first = store->awake_count++;
+
+    store->sleep_frames[index] = 0;
+
+    bodystore_swap(store, index, first);
+
+    return first;
+
+}
+
+// wakes every body, the sleeping ones already sit right behind the awake ones so nothing moves
+void bodystore_wake_all(bodystore_t *store)
+{
+
+    memset(store->sleep_frames, 0, store->count * sizeof(uint32_t));
+
+    store->awake_count = store->count;
+
+}
+
+// FNV-1a over the exact bits of every body's position and velocity in dense order, plus how many
+// bodies there are and how many are awake. Two stores hash the same only if they're bit for bit
+// the same, so it tells whether two runs have diverged
+uint64_t bodystore_hash(const bodystore_t *store)
+{
+
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    hash = (hash ^ store->count) * 0x100000001B3ull;
+    hash = (hash ^ store->awake_count) * 0x100000001B3ull;
+    hash = bodystore_hash_floats(hash, store->x_pos, store->count);
+    hash = bodystore_hash_floats(hash, store->y_pos, store->count);
+    hash = bodystore_hash_floats(hash, store->x_vel, store->count);
+    hash = bodystore_hash_floats(hash, store->y_vel, store->count);
+
+    return hash;
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// reallocates a SIMD-aligned array, zero-filling the new tail so padding lanes hold harmless values
+static void* bodystore_grow_array(void *array, uint32_t old_capacity, uint32_t new_capacity, size_t element_size)
+{
+
+    array = SDL_SIMDRealloc(array, new_capacity * element_size);
+
+    if (array)
+    {
+        memset((uint8_t *)array + old_capacity * element_size, 0, (new_capacity - old_capacity) * element_size);
+    }
+
+    return array;
+
+}
+
+// copies every property of dense body src over dense body dst
+static void bodystore_move(bodystore_t *store, uint32_t dst, uint32_t src)
+{
+
+    store->x_pos[dst]      = store->x_pos[src];
+    store->y_pos[dst]      = store->y_pos[src];
+    store->prev_x_pos[dst] = store->prev_x_pos[src];
+    store->prev_y_pos[dst] = store->prev_y_pos[src];
+    store->x_vel[dst]      = store->x_vel[src];
+    store->y_vel[dst]      = store->y_vel[src];
+    store->x_acc[dst]      = store->x_acc[src];
+    store->y_acc[dst]      = store->y_acc[src];
+    store->intr_x_vel[dst] = store->intr_x_vel[src];
+    store->intr_y_vel[dst] = store->intr_y_vel[src];
+    store->intr_x_acc[dst] = store->intr_x_acc[src];
+    store->intr_y_acc[dst] = store->intr_y_acc[src];
+    store->ext_x_acc[dst]  = store->ext_x_acc[src];
+    store->ext_y_acc[dst]  = store->ext_y_acc[src];
+    store->mass[dst]       = store->mass[src];
+    store->width[dst]      = store->width[src];
+    store->height[dst]     = store->height[src];
+    store->momentum[dst]   = store->momentum[src];
+    store->friction[dst]   = store->friction[src];
+    store->restitution[dst] = store->restitution[src];
+    store->sleep_frames[dst] = store->sleep_frames[src];
+    store->color[dst]      = store->color[src];
+    store->slot[dst]       = store->slot[src];
+
+}
+
+#define BODYSTORE_SWAP(type, array) { type t = store->array[i]; store->array[i] = store->array[j]; store->array[j] = t; }
+
+// exchanges dense bodies i and j, keeping their slots pointing at them
+static void bodystore_swap(bodystore_t *store, uint32_t i, uint32_t j)
+{
+
+    if (i == j)
+    {
+        return;
+    }
+
+    BODYSTORE_SWAP(float, x_pos);
+    BODYSTORE_SWAP(float, y_pos);
+    BODYSTORE_SWAP(float, prev_x_pos);
+    BODYSTORE_SWAP(float, prev_y_pos);
+    BODYSTORE_SWAP(float, x_vel);
+    BODYSTORE_SWAP(float, y_vel);
+    BODYSTORE_SWAP(float, x_acc);
+    BODYSTORE_SWAP(float, y_acc);
+    BODYSTORE_SWAP(float, intr_x_vel);
+    BODYSTORE_SWAP(float, intr_y_vel);
+    BODYSTORE_SWAP(float, intr_x_acc);
+    BODYSTORE_SWAP(float, intr_y_acc);
+    BODYSTORE_SWAP(float, ext_x_acc);
+    BODYSTORE_SWAP(float, ext_y_acc);
+    BODYSTORE_SWAP(float, mass);
+    BODYSTORE_SWAP(float, width);
+    BODYSTORE_SWAP(float, height);
+    BODYSTORE_SWAP(float, momentum);
+    BODYSTORE_SWAP(float, friction);
+    BODYSTORE_SWAP(float, restitution);
+    BODYSTORE_SWAP(uint32_t, sleep_frames);
+    BODYSTORE_SWAP(uint32_t, color);
+    BODYSTORE_SWAP(uint32_t, slot);
+
+    store->slot_index[store->slot[i]] = i;
+    store->slot_index[store->slot[j]] = j;
+
+}
+
+#undef BODYSTORE_SWAP
+
+// pops a slot off the free list, or appends a new one (doubling the slot table when full)
+static uint32_t bodystore_alloc_slot(bodystore_t *store)
+{
+
+    uint32_t slot = store->free_slot;
+
+    if (slot != UINT32_MAX)
+    {
+        store->free_slot = store->slot_index[slot];
+        return slot;
+    }
+
+    if (store->slot_count >= store->slot_capacity)
+    {
+        store->slot_capacity   = store->slot_capacity ? store->slot_capacity * 2 : BODYSTORE_MIN_CAPACITY;
+        store->slot_index      = realloc(store->slot_index, store->slot_capacity * sizeof(uint32_t));
+        store->slot_generation = realloc(store->slot_generation, store->slot_capacity * sizeof(uint32_t));
+    }
+
+    slot = store->slot_count++;
+    store->slot_generation[slot] = 0;
+
+    return slot;
+
+}
+
+// folds the bit patterns of count floats into an FNV-1a hash a word at a time
+static uint64_t bodystore_hash_floats(uint64_t hash, const float *values, uint32_t count)
+{
+
+    uint32_t bits;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        memcpy(&bits, &values[i], sizeof(uint32_t));
+        hash = (hash ^ bits) * 0x100000001B3ull;
+    }
+
+    return hash;
+
+}
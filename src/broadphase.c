@@ -0,0 +1,252 @@
+/*
+ *  broadphase.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+
+#include "../inc/common.h"
+#include "../inc/bodystore.h"
+#include "../inc/broadphase.h"
+#include "../inc/spatialhash.h"
+#include "../inc/sweepprune.h"
+#include "../inc/aabbtree.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define BROADPHASE_MIN_PAIRS 256                                // smallest capacity the pair list grows from
+
+/* ---------------------------------------------------------------------------------------- */
+
+static void broadphase_brute_force(const bodystore_t *bodies, broadphase_pairs_t *pairs);
+
+/* ---------------------------------------------------------------------------------------- */
+
+// sets up the state the selected algorithm keeps between frames
+void broadphase_init(broadphase_t *bp, broadphase_type_t type)
+{
+
+    memset(bp, 0, sizeof(broadphase_t));
+
+    bp->type = type;
+
+    switch (type)
+    {
+
+        case BROADPHASE_SPATIAL_HASH:
+            bp->grid = malloc(sizeof(spatialhash_t));
+            spatialhash_init(bp->grid);
+            break;
+
+        case BROADPHASE_SWEEP_PRUNE:
+            bp->sap = malloc(sizeof(sweepprune_t));
+            sweepprune_init(bp->sap);
+            break;
+
+        case BROADPHASE_AABB_TREE:
+            bp->tree = malloc(sizeof(aabbtree_t));
+            aabbtree_init(bp->tree);
+            break;
+
+        default:
+            break;
+
+    }
+
+}
+
+void broadphase_destroy(broadphase_t *bp)
+{
+
+    if (bp->grid)
+    {
+        spatialhash_destroy(bp->grid);
+        free(bp->grid);
+    }
+
+    if (bp->sap)
+    {
+        sweepprune_destroy(bp->sap);
+        free(bp->sap);
+    }
+
+    if (bp->tree)
+    {
+        aabbtree_destroy(bp->tree);
+        free(bp->tree);
+    }
+
+    memset(bp, 0, sizeof(broadphase_t));
+
+}
+
+// replaces the contents of pairs with every overlapping pair of bodies
+void broadphase_find_pairs(broadphase_t *bp, const bodystore_t *bodies, broadphase_pairs_t *pairs)
+{
+
+    switch (bp->type)
+    {
+
+        case BROADPHASE_SPATIAL_HASH:
+            spatialhash_find_pairs(bp->grid, bodies, pairs);
+            break;
+
+        case BROADPHASE_SWEEP_PRUNE:
+            sweepprune_find_pairs(bp->sap, bodies, pairs);
+            break;
+
+        case BROADPHASE_AABB_TREE:
+            aabbtree_find_pairs(bp->tree, bodies, pairs);
+            break;
+
+        case BROADPHASE_BRUTE_FORCE:
+        default:
+            broadphase_brute_force(bodies, pairs);
+            break;
+
+    }
+
+}
+
+// brings the state queries run against up to date with the bodies, without finding pairs
+void broadphase_update(broadphase_t *bp, const bodystore_t *bodies)
+{
+
+    if (bp->type == BROADPHASE_AABB_TREE)
+    {
+        aabbtree_update(bp->tree, bodies);
+    }
+
+}
+
+// calls callback with the dense index of every body whose box overlaps the region, until it returns
+// false. Only the tree has an index to answer this with, the rest scan every body. The tree answers
+// for bodies as of the last broadphase_update or broadphase_find_pairs
+void broadphase_query(broadphase_t *bp, const bodystore_t *bodies, float min_x, float min_y, float max_x, float max_y, broadphase_query_t callback, void *context)
+{
+
+    if (bp->type == BROADPHASE_AABB_TREE)
+    {
+        aabbtree_query(bp->tree, bodies, min_x, min_y, max_x, max_y, callback, context);
+        return;
+    }
+
+    for (uint32_t i = 0; i < bodies->count; i++)
+    {
+        if (bodies->x_pos[i] < max_x && min_x < bodies->x_pos[i] + bodies->width[i] &&
+            bodies->y_pos[i] < max_y && min_y < bodies->y_pos[i] + bodies->height[i])
+        {
+            if (!callback(i, context)) return;
+        }
+    }
+
+}
+
+// pairs (by body slot) that started and stopped overlapping during the last find_pairs. Returns
+// false if the selected algorithm doesn't keep state between frames and so can't report them
+bool broadphase_events(const broadphase_t *bp, const broadphase_pairs_t **began, const broadphase_pairs_t **ended)
+{
+
+    switch (bp->type)
+    {
+
+        case BROADPHASE_SWEEP_PRUNE:
+            *began = &bp->sap->began;
+            *ended = &bp->sap->ended;
+            return true;
+
+        default:
+            return false;
+
+    }
+
+}
+
+const char* broadphase_name(broadphase_type_t type)
+{
+
+    switch (type)
+    {
+        case BROADPHASE_BRUTE_FORCE:    return "brute";
+        case BROADPHASE_SPATIAL_HASH:   return "grid";
+        case BROADPHASE_SWEEP_PRUNE:    return "sap";
+        case BROADPHASE_AABB_TREE:      return "bvh";
+        default:                        return "unknown";
+    }
+
+}
+
+// looks up a broadphase by the name broadphase_name gives it, returns false if there's no match
+bool broadphase_parse_type(const char *name, broadphase_type_t *type)
+{
+
+    for (broadphase_type_t t = BROADPHASE_BRUTE_FORCE; t <= BROADPHASE_AABB_TREE; t++)
+    {
+        if (!strcmp(name, broadphase_name(t)))
+        {
+            *type = t;
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+void broadphase_pairs_init(broadphase_pairs_t *pairs)
+{
+    memset(pairs, 0, sizeof(broadphase_pairs_t));
+}
+
+void broadphase_pairs_destroy(broadphase_pairs_t *pairs)
+{
+    free(pairs->pairs);
+    memset(pairs, 0, sizeof(broadphase_pairs_t));
+}
+
+// appends a pair, doubling the list when it's full
+void broadphase_pairs_push(broadphase_pairs_t *pairs, uint32_t a, uint32_t b)
+{
+
+    if (pairs->count >= pairs->capacity)
+    {
+        pairs->capacity = pairs->capacity ? pairs->capacity * 2 : BROADPHASE_MIN_PAIRS;
+        pairs->pairs = realloc(pairs->pairs, pairs->capacity * sizeof(broadphase_pair_t));
+    }
+
+    pairs->pairs[pairs->count++] = (broadphase_pair_t){ a, b };
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// O(N^2) bounding box test over every unordered pair
+static void broadphase_brute_force(const bodystore_t *bodies, broadphase_pairs_t *pairs)
+{
+
+    const float *x_pos  = bodies->x_pos;
+    const float *y_pos  = bodies->y_pos;
+    const float *width  = bodies->width;
+    const float *height = bodies->height;
+
+    pairs->count = 0;
+
+    for (uint32_t i = 0; i < bodies->count; i++)
+    {
+        for (uint32_t j = i + 1; j < bodies->count; j++)
+        {
+            if (x_pos[i] < x_pos[j] + width[j]  && x_pos[j] < x_pos[i] + width[i] &&
+                y_pos[i] < y_pos[j] + height[j] && y_pos[j] < y_pos[i] + height[i])
+            {
+                broadphase_pairs_push(pairs, i, j);
+            }
+        }
+    }
+
+}
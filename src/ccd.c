@@ -0,0 +1,323 @@
+/*
+ *  ccd.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <math.h>
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/bodystore.h"
+#include "../inc/broadphase.h"
+#include "../inc/simobject.h"
+#include "../inc/solver.h"
+#include "../inc/ccd.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define CCD_MIN_CANDIDATES 64                                   // smallest capacity the candidate list grows from
+#define CCD_NO_HIT UINT32_MAX
+#define CCD_BORDER (UINT32_MAX - 1)
+
+/* ---------------------------------------------------------------------------------------- */
+
+static bool ccd_collect(uint32_t index, void *context);
+static void ccd_sweep(ccd_t *ccd, bodystore_t *bodies, broadphase_t *bp, const fieldproperties_t *props, uint32_t i, float half_w, float half_h);
+
+/* ---------------------------------------------------------------------------------------- */
+
+void ccd_init(ccd_t *ccd)
+{
+    memset(ccd, 0, sizeof(ccd_t));
+}
+
+void ccd_destroy(ccd_t *ccd)
+{
+
+    free(ccd->start_x);
+    free(ccd->start_y);
+    free(ccd->candidates);
+
+    memset(ccd, 0, sizeof(ccd_t));
+
+}
+
+// remembers where every awake body starts the step, call before integrating
+void ccd_begin(ccd_t *ccd, const bodystore_t *bodies)
+{
+
+    if (bodies->count > ccd->capacity)
+    {
+        ccd->capacity = bodies->capacity;
+        ccd->start_x  = realloc(ccd->start_x, ccd->capacity * sizeof(float));
+        ccd->start_y  = realloc(ccd->start_y, ccd->capacity * sizeof(float));
+    }
+
+    memcpy(ccd->start_x, bodies->x_pos, bodies->awake_count * sizeof(float));
+    memcpy(ccd->start_y, bodies->y_pos, bodies->awake_count * sizeof(float));
+
+}
+
+// sweeps every body that moved fast enough to tunnel, from where ccd_begin saw it to where the
+// integrator put it. half_w and half_h are the border's half extents around the origin
+void ccd_resolve(ccd_t *ccd, bodystore_t *bodies, broadphase_t *bp, const fieldproperties_t *props, float half_w, float half_h)
+{
+
+    float dx, dy, reach;
+
+    ccd->swept    = 0;
+    ccd->substeps = 0;
+
+    // candidates come from the broadphase's view of where bodies ended up
+    broadphase_update(bp, bodies);
+
+    // sleeping bodies weren't integrated, so only awake ones can have moved
+    for (uint32_t i = 0; i < bodies->awake_count; i++)
+    {
+
+        dx    = bodies->x_pos[i] - ccd->start_x[i];
+        dy    = bodies->y_pos[i] - ccd->start_y[i];
+        reach = CCD_MOTION_THRESHOLD * bodystore_radius(bodies->width[i]);
+
+        if (dx * dx + dy * dy > reach * reach)
+        {
+            ccd_sweep(ccd, bodies, bp, props, i, half_w, half_h);
+            ccd->swept++;
+        }
+
+    }
+
+}
+
+// earliest fraction of the motion (dx, dy) at which a circle centered at (ax, ay) comes within
+// radius of the point (bx, by), found by conservative advancement. False if it never does, or if
+// they already overlap or are moving apart
+bool ccd_circle_toi(float ax, float ay, float dx, float dy, float bx, float by, float radius, float *toi)
+{
+
+    float length = sqrtf(dx * dx + dy * dy);
+    float cx, cy, distance;
+    float t = 0.0f;
+
+    if (length == 0.0f)
+    {
+        return false;
+    }
+
+    for (uint32_t k = 0; k < CCD_MAX_ITERATIONS; k++)
+    {
+
+        cx = ax + t * dx - bx;
+        cy = ay + t * dy - by;
+        distance = sqrtf(cx * cx + cy * cy) - radius;
+
+        // overlapping from the start is the discrete stage's business
+        if (distance < 0.0f && t == 0.0f)
+        {
+            return false;
+        }
+
+        if (distance <= CCD_SLOP)
+        {
+
+            if (cx * dx + cy * dy >= 0.0f)
+            {
+                return false;
+            }
+
+            *toi = t;
+            return true;
+
+        }
+
+        // the gap can't close faster than the body moves, so advancing by it never overshoots.
+        // Aim a little inside the slop so grazing approaches still terminate
+        t += (distance - 0.5f * CCD_SLOP) / length;
+
+        if (t > 1.0f)
+        {
+            return false;
+        }
+
+    }
+
+    return false;
+
+}
+
+// earliest fraction of the motion (dx, dy) at which the box [min, max] reaches a wall of the
+// border [-half, half], and the outward normal of that wall. Boxes already past a wall are left
+// to the discrete stage
+bool ccd_border_toi(float min_x, float min_y, float max_x, float max_y, float dx, float dy, float half_w, float half_h, float *toi, float *normal_x, float *normal_y)
+{
+
+    float t;
+    bool hit = false;
+
+    *toi = 1.0f;
+
+    if (dx > 0.0f && max_x <= half_w && max_x + dx > half_w - CCD_SLOP)
+    {
+        t = SDL_max((half_w - CCD_SLOP - max_x) / dx, 0.0f);
+        if (t < *toi) { *toi = t; *normal_x =  1.0f; *normal_y =  0.0f; hit = true; }
+    }
+
+    if (dx < 0.0f && min_x >= -half_w && min_x + dx < -half_w + CCD_SLOP)
+    {
+        t = SDL_max((-half_w + CCD_SLOP - min_x) / dx, 0.0f);
+        if (t < *toi) { *toi = t; *normal_x = -1.0f; *normal_y =  0.0f; hit = true; }
+    }
+
+    if (dy > 0.0f && max_y <= half_h && max_y + dy > half_h - CCD_SLOP)
+    {
+        t = SDL_max((half_h - CCD_SLOP - max_y) / dy, 0.0f);
+        if (t < *toi) { *toi = t; *normal_x =  0.0f; *normal_y =  1.0f; hit = true; }
+    }
+
+    if (dy < 0.0f && min_y >= -half_h && min_y + dy < -half_h + CCD_SLOP)
+    {
+        t = SDL_max((-half_h + CCD_SLOP - min_y) / dy, 0.0f);
+        if (t < *toi) { *toi = t; *normal_x =  0.0f; *normal_y = -1.0f; hit = true; }
+    }
+
+    return hit;
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+static bool ccd_collect(uint32_t index, void *context)
+{
+
+    ccd_t *ccd = context;
+
+    if (ccd->candidate_count >= ccd->candidate_capacity)
+    {
+        ccd->candidate_capacity = ccd->candidate_capacity ? ccd->candidate_capacity * 2 : CCD_MIN_CANDIDATES;
+        ccd->candidates = realloc(ccd->candidates, ccd->candidate_capacity * sizeof(uint32_t));
+    }
+
+    ccd->candidates[ccd->candidate_count++] = index;
+
+    return true;
+
+}
+
+// rewinds body i to its start and moves it along its motion one impact at a time. Each impact
+// stops the body just short of it, bounces it and continues with what's left of the
+// step. Motion left over after CCD_MAX_SUBSTEPS impacts is dropped
+static void ccd_sweep(ccd_t *ccd, bodystore_t *bodies, broadphase_t *bp, const fieldproperties_t *props, uint32_t i, float half_w, float half_h)
+{
+
+    const float w  = bodies->width[i];
+    const float h  = bodies->height[i];
+    const float r  = bodystore_radius(w);
+    const float dt = props->timestep;
+
+    float x  = ccd->start_x[i];
+    float y  = ccd->start_y[i];
+    float dx = bodies->x_pos[i] - x;
+    float dy = bodies->y_pos[i] - y;
+
+    float toi, t, nx, ny, length, vx, vy, vn, impulse, rj;
+    float normal_x = 0.0f, normal_y = 0.0f;
+    uint32_t hit, j, k, substep;
+
+    for (substep = 0; substep < CCD_MAX_SUBSTEPS; substep++)
+    {
+
+        toi = 1.0f;
+        hit = CCD_NO_HIT;
+
+        if (ccd_border_toi(x, y, x + w, y + h, dx, dy, half_w, half_h, &t, &nx, &ny) && t < toi)
+        {
+            toi = t;
+            hit = CCD_BORDER;
+            normal_x = nx;
+            normal_y = ny;
+        }
+
+        // every body the swept box passes over
+        ccd->candidate_count = 0;
+        broadphase_query(bp, bodies, SDL_min(x, x + dx), SDL_min(y, y + dy), SDL_max(x, x + dx) + w, SDL_max(y, y + dy) + h, ccd_collect, ccd);
+
+        for (k = 0; k < ccd->candidate_count; k++)
+        {
+
+            j  = ccd->candidates[k];
+            rj = bodystore_radius(bodies->width[j]);
+
+            if (j == i) continue;
+
+            if (ccd_circle_toi(bodystore_center(x, w), bodystore_center(y, w), dx, dy,
+                               bodystore_center(bodies->x_pos[j], bodies->width[j]), bodystore_center(bodies->y_pos[j], bodies->width[j]), r + rj, &t) && t < toi)
+            {
+                toi = t;
+                hit = j;
+            }
+
+        }
+
+        if (hit == CCD_NO_HIT)
+        {
+            x += dx;
+            y += dy;
+            break;
+        }
+
+        x += toi * dx;
+        y += toi * dy;
+
+        vx = bodies->x_vel[i];
+        vy = bodies->y_vel[i];
+
+        if (hit == CCD_BORDER)
+        {
+
+            // the border is immovable, reflect off the wall
+            vn = vx * normal_x + vy * normal_y;
+            bodies->x_vel[i] -= (1.0f + bodies->restitution[i]) * vn * normal_x;
+            bodies->y_vel[i] -= (1.0f + bodies->restitution[i]) * vn * normal_y;
+
+        }
+        else
+        {
+
+            normal_x = bodystore_center(bodies->x_pos[hit], bodies->width[hit]) - bodystore_center(x, w);
+            normal_y = bodystore_center(bodies->y_pos[hit], bodies->width[hit]) - bodystore_center(y, w);
+            length   = sqrtf(normal_x * normal_x + normal_y * normal_y);
+            normal_x /= length;
+            normal_y /= length;
+
+            // restitution impulse along the line between centers, mixed the way the solver mixes it
+            vn = (vx - bodies->x_vel[hit]) * normal_x + (vy - bodies->y_vel[hit]) * normal_y;
+
+            if (vn > 0.0f)
+            {
+                impulse = (1.0f + solver_mix_restitution(bodies->restitution[i], bodies->restitution[hit])) * vn / (1.0f / bodies->mass[i] + 1.0f / bodies->mass[hit]);
+
+                bodies->x_vel[i]   -= impulse / bodies->mass[i]   * normal_x;
+                bodies->y_vel[i]   -= impulse / bodies->mass[i]   * normal_y;
+                bodies->x_vel[hit] += impulse / bodies->mass[hit] * normal_x;
+                bodies->y_vel[hit] += impulse / bodies->mass[hit] * normal_y;
+            }
+
+        }
+
+        // the rest of the step, with the velocity change applied to it
+        dx = (1.0f - toi) * (dx + dt * (bodies->x_vel[i] - vx));
+        dy = (1.0f - toi) * (dy + dt * (bodies->y_vel[i] - vy));
+
+        ccd->substeps++;
+
+    }
+
+    bodies->x_pos[i] = x;
+    bodies->y_pos[i] = y;
+
+}
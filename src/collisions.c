@@ -8,15 +8,38 @@
 /* ---------------------------------------------------------------------------------------- */
 
 #include <float.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <math.h>
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define COLLISIONS_X86_SIMD 1
+#else
+#define COLLISIONS_X86_SIMD 0
+#endif
+
 #include "../inc/SDL2/SDL.h"
+#include "../inc/bodystore.h"
+#include "../inc/broadphase.h"
 #include "../inc/collisions.h"
 
 /* ---------------------------------------------------------------------------------------- */
 
+#define CONTACTLIST_MIN_CAPACITY 256                            // smallest capacity the contact list grows from
+
+/* ---------------------------------------------------------------------------------------- */
+
+static void detect_circle_emit(contactlist_t *contacts, uint32_t a, uint32_t b, float dx, float dy, float radii);
+
+#if (COLLISIONS_X86_SIMD)
+static uint32_t detect_circle_contacts_sse2(const bodystore_t *bodies, const broadphase_pairs_t *pairs, uint32_t begin, uint32_t end, contactlist_t *contacts);
+#endif
+
+/* ---------------------------------------------------------------------------------------- */
+
 // checks if rect1 is colliding with rect2, returns side of collision for each object
 uint8_t detect_object_collision(SDL_FRect rect1, SDL_FRect rect2)
 {
@@ -108,4 +131,201 @@ uint8_t detect_border_collision(SDL_FRect rect1, SDL_FRect border)
 
     return collision_detected;
 
-}
\ No newline at end of file
+}
+// appends a contact for every candidate pair whose circles (see bodystore_radius) overlap. The normal points from a's center to b's, depth is how far the circles overlap
+void detect_circle_contacts(const bodystore_t *bodies, const broadphase_pairs_t *pairs, contactlist_t *contacts)
+{
+    detect_circle_contacts_range(bodies, pairs, 0, pairs->count, contacts);
+}
+
+// same for candidate pairs [begin, end) only, so separate ranges can be tested in parallel
+void detect_circle_contacts_range(const bodystore_t *bodies, const broadphase_pairs_t *pairs, uint32_t begin, uint32_t end, contactlist_t *contacts)
+{
+
+    const float *x_pos = bodies->x_pos;
+    const float *y_pos = bodies->y_pos;
+    const float *width = bodies->width;
+
+    uint32_t k = begin;
+    uint32_t a, b;
+    float dx, dy, radii;
+
+    #if (COLLISIONS_X86_SIMD)
+    {
+        k = detect_circle_contacts_sse2(bodies, pairs, begin, end, contacts);
+    }
+    #endif
+
+    for (; k < end; k++)
+    {
+
+        a = pairs->pairs[k].a;
+        b = pairs->pairs[k].b;
+
+        dx    = bodystore_center(x_pos[b], width[b]) - bodystore_center(x_pos[a], width[a]);
+        dy    = bodystore_center(y_pos[b], width[b]) - bodystore_center(y_pos[a], width[a]);
+        radii = bodystore_radius(width[a]) + bodystore_radius(width[b]);
+
+        if (dx * dx + dy * dy < radii * radii)
+        {
+            detect_circle_emit(contacts, a, b, dx, dy, radii);
+        }
+
+    }
+
+}
+
+// fills in a border contact if rect1 sticks out of the border. The normal points out through the
+// wall it's deepest into
+bool detect_border_contact(SDL_FRect rect1, SDL_FRect border, contact_t *contact)
+{
+
+    float left, right, top, bottom;
+
+    contact->sides = detect_border_collision(rect1, border);
+
+    if (!contact->sides)
+    {
+        return false;
+    }
+
+    // how far past each wall the rectangle reaches, only the flagged walls count
+    left   = (contact->sides & 0x01) ? border.x - rect1.x : 0.0f;
+    right  = (contact->sides & 0x02) ? (rect1.x + rect1.w) - (border.x + border.w) : 0.0f;
+    top    = (contact->sides & 0x04) ? border.y - rect1.y : 0.0f;
+    bottom = (contact->sides & 0x08) ? (rect1.y + rect1.h) - (border.y + border.h) : 0.0f;
+
+    contact->type     = CONTACT_BORDER;
+    contact->b        = CONTACT_NO_BODY;
+    contact->normal_x = 0.0f;
+    contact->normal_y = 0.0f;
+    contact->depth    = 0.0f;
+
+    if (left   > contact->depth) { contact->depth = left;   contact->normal_x = -1.0f; contact->normal_y =  0.0f; }
+    if (right  > contact->depth) { contact->depth = right;  contact->normal_x =  1.0f; contact->normal_y =  0.0f; }
+    if (top    > contact->depth) { contact->depth = top;    contact->normal_x =  0.0f; contact->normal_y = -1.0f; }
+    if (bottom > contact->depth) { contact->depth = bottom; contact->normal_x =  0.0f; contact->normal_y =  1.0f; }
+
+    return true;
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+void contactlist_init(contactlist_t *list)
+{
+    memset(list, 0, sizeof(contactlist_t));
+}
+
+void contactlist_destroy(contactlist_t *list)
+{
+    free(list->contacts);
+    memset(list, 0, sizeof(contactlist_t));
+}
+
+// appends an uninitialized contact and returns it, doubling the list when it's full. The pointer
+// is invalidated by the next push
+contact_t* contactlist_push(contactlist_t *list)
+{
+
+    if (list->count >= list->capacity)
+    {
+        list->capacity = list->capacity ? list->capacity * 2 : CONTACTLIST_MIN_CAPACITY;
+        list->contacts = realloc(list->contacts, list->capacity * sizeof(contact_t));
+    }
+
+    return &list->contacts[list->count++];
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// appends the contact of two overlapping circles whose centers are (dx, dy) apart
+static void detect_circle_emit(contactlist_t *contacts, uint32_t a, uint32_t b, float dx, float dy, float radii)
+{
+
+    contact_t *contact = contactlist_push(contacts);
+    float distance = sqrtf(dx * dx + dy * dy);
+
+    contact->a    = a;
+    contact->b    = b;
+    contact->type = CONTACT_BODY;
+
+    // coincident centers have no direction, push them apart along x
+    if (distance > 0.0f)
+    {
+        contact->normal_x = dx / distance;
+        contact->normal_y = dy / distance;
+    }
+    else
+    {
+        contact->normal_x = 1.0f;
+        contact->normal_y = 0.0f;
+    }
+
+    contact->depth = radii - distance;
+
+    // same sides detect_object_collision would flag for a, from the direction b lies in
+    contact->sides = (contact->normal_x > 0.0f ? 0x01 : 0) | (contact->normal_x < 0.0f ? 0x02 : 0) |
+                     (contact->normal_y > 0.0f ? 0x04 : 0) | (contact->normal_y < 0.0f ? 0x08 : 0);
+
+    contact->normal_impulse  = 0.0f;
+    contact->tangent_impulse = 0.0f;
+
+}
+
+#if (COLLISIONS_X86_SIMD)
+
+// tests four candidate pairs at a time, only the overlapping ones are emitted. Returns where it stopped.
+// Every lane computes exactly what the scalar loop does, in the same order, so both find the same contacts
+__attribute__((target("sse2")))
+static uint32_t detect_circle_contacts_sse2(const bodystore_t *bodies, const broadphase_pairs_t *pairs, uint32_t begin, uint32_t end, contactlist_t *contacts)
+{
+
+    const float *x_pos = bodies->x_pos;
+    const float *y_pos = bodies->y_pos;
+    const float *width = bodies->width;
+    const broadphase_pair_t *p = pairs->pairs;
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    float dx[4], dy[4], radii[4];
+    __m128 ra, rb, cdx, cdy, r;
+    uint32_t k, lane;
+    int hits;
+
+    for (k = begin; k + 4 <= end; k += 4)
+    {
+
+        ra = _mm_mul_ps(_mm_setr_ps(width[p[k].a], width[p[k + 1].a], width[p[k + 2].a], width[p[k + 3].a]), half);
+        rb = _mm_mul_ps(_mm_setr_ps(width[p[k].b], width[p[k + 1].b], width[p[k + 2].b], width[p[k + 3].b]), half);
+
+        // center of b minus center of a, then the sum of the radii, as bodystore_center and bodystore_radius work them out
+        cdx = _mm_sub_ps(_mm_add_ps(_mm_setr_ps(x_pos[p[k].b], x_pos[p[k + 1].b], x_pos[p[k + 2].b], x_pos[p[k + 3].b]), rb),
+                         _mm_add_ps(_mm_setr_ps(x_pos[p[k].a], x_pos[p[k + 1].a], x_pos[p[k + 2].a], x_pos[p[k + 3].a]), ra));
+        cdy = _mm_sub_ps(_mm_add_ps(_mm_setr_ps(y_pos[p[k].b], y_pos[p[k + 1].b], y_pos[p[k + 2].b], y_pos[p[k + 3].b]), rb),
+                         _mm_add_ps(_mm_setr_ps(y_pos[p[k].a], y_pos[p[k + 1].a], y_pos[p[k + 2].a], y_pos[p[k + 3].a]), ra));
+        r   = _mm_add_ps(ra, rb);
+
+        hits = _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(_mm_mul_ps(cdx, cdx), _mm_mul_ps(cdy, cdy)), _mm_mul_ps(r, r)));
+
+        if (!hits) continue;
+
+        _mm_storeu_ps(dx, cdx);
+        _mm_storeu_ps(dy, cdy);
+        _mm_storeu_ps(radii, r);
+
+        for (lane = 0; lane < 4; lane++)
+        {
+            if (hits & (1 << lane))
+            {
+                detect_circle_emit(contacts, p[k + lane].a, p[k + lane].b, dx[lane], dy[lane], radii[lane]);
+            }
+        }
+
+    }
+
+    return k;
+
+}
+
+#endif
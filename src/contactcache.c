@@ -0,0 +1,176 @@
+/*
+ *  contactcache.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+
+#include "../inc/common.h"
+#include "../inc/bodystore.h"
+#include "../inc/broadphase.h"
+#include "../inc/collisions.h"
+#include "../inc/pairmap.h"
+#include "../inc/contactcache.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+static uint64_t contactcache_key(const bodystore_t *bodies, const contact_t *contact, uint32_t *generation_a, uint32_t *generation_b, float *sign);
+static bool contactcache_keep_touching(uint64_t key, void *value, void *context);
+
+/* ---------------------------------------------------------------------------------------- */
+
+void contactcache_init(contactcache_t *cache)
+{
+
+    memset(cache, 0, sizeof(contactcache_t));
+
+    pairmap_init(&cache->entries, sizeof(contactcache_entry_t), 0);
+
+}
+
+void contactcache_destroy(contactcache_t *cache)
+{
+
+    pairmap_destroy(&cache->entries);
+
+    memset(cache, 0, sizeof(contactcache_t));
+
+}
+
+// matches this frame's contacts against the cache: new pairs get an entry, persisting ones age
+// and hand their accumulated impulse to the contact as a warm start. Then evicts the slot pairs
+// the broadphase says stopped overlapping, or with ended NULL, every pair that isn't touching
+void contactcache_update(contactcache_t *cache, const bodystore_t *bodies, contactlist_t *contacts, const broadphase_pairs_t *ended)
+{
+
+    contactcache_entry_t *entry;
+    contact_t *contact;
+    uint32_t k, generation_a, generation_b;
+    uint64_t key;
+    float sign;
+    bool inserted;
+
+    cache->frame++;
+
+    for (k = 0; k < contacts->count; k++)
+    {
+
+        contact = &contacts->contacts[k];
+        key     = contactcache_key(bodies, contact, &generation_a, &generation_b, &sign);
+        entry   = pairmap_insert(&cache->entries, key, &inserted);
+
+        // a slot that was freed and reused since is a different body, and an entry that wasn't
+        // touching last frame is stale
+        if (!inserted && (entry->generation_a != generation_a || entry->generation_b != generation_b || entry->last_frame + 1 != cache->frame))
+        {
+            memset(entry, 0, sizeof(contactcache_entry_t));
+            inserted = true;
+        }
+
+        entry->generation_a = generation_a;
+        entry->generation_b = generation_b;
+        entry->last_frame   = cache->frame;
+        entry->age++;
+
+        // only reuse the impulse if it was built up along roughly the same normal
+        if (!inserted && sign * (entry->normal_x * contact->normal_x + entry->normal_y * contact->normal_y) >= CONTACTCACHE_NORMAL_TOLERANCE)
+        {
+            contact->normal_impulse  = entry->normal_impulse;
+            contact->tangent_impulse = entry->tangent_impulse;
+        }
+        else
+        {
+            contact->normal_impulse  = 0.0f;
+            contact->tangent_impulse = 0.0f;
+        }
+
+    }
+
+    if (!ended)
+    {
+        pairmap_retain(&cache->entries, contactcache_keep_touching, cache);
+        return;
+    }
+
+    for (k = 0; k < ended->count; k++)
+    {
+        pairmap_remove(&cache->entries, pairmap_key(ended->pairs[k].a, ended->pairs[k].b));
+    }
+
+}
+
+// cached state of a contact seen by the last update, NULL if it wasn't. Valid until the next update
+contactcache_entry_t* contactcache_find(const contactcache_t *cache, const bodystore_t *bodies, const contact_t *contact)
+{
+
+    contactcache_entry_t *entry;
+    uint32_t generation_a, generation_b;
+    float sign;
+
+    entry = pairmap_find(&cache->entries, contactcache_key(bodies, contact, &generation_a, &generation_b, &sign));
+
+    return entry && entry->last_frame == cache->frame ? entry : NULL;
+
+}
+
+// saves the impulses the response accumulated on each contact, for next frame's warm start
+void contactcache_store(contactcache_t *cache, const bodystore_t *bodies, const contactlist_t *contacts)
+{
+
+    contactcache_entry_t *entry;
+    const contact_t *contact;
+    uint32_t generation_a, generation_b;
+    float sign;
+
+    for (uint32_t k = 0; k < contacts->count; k++)
+    {
+
+        contact = &contacts->contacts[k];
+        entry   = pairmap_find(&cache->entries, contactcache_key(bodies, contact, &generation_a, &generation_b, &sign));
+
+        if (!entry) continue;
+
+        entry->normal_impulse  = contact->normal_impulse;
+        entry->tangent_impulse = contact->tangent_impulse;
+        entry->normal_x        = sign * contact->normal_x;
+        entry->normal_y        = sign * contact->normal_y;
+
+    }
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// key of a contact by body slot, and the generations of those slots. The border has no slot. Cached
+// normals point from the lower slot to the higher one, sign is -1 when the contact's a is the higher
+static uint64_t contactcache_key(const bodystore_t *bodies, const contact_t *contact, uint32_t *generation_a, uint32_t *generation_b, float *sign)
+{
+
+    uint32_t slot_a = bodies->slot[contact->a];
+    uint32_t slot_b = contact->type == CONTACT_BORDER ? CONTACT_NO_BODY : bodies->slot[contact->b];
+
+    // generations follow the key's order, so they match whichever body the contact lists first
+    *sign         = slot_a < slot_b ? 1.0f : -1.0f;
+    *generation_a = bodies->slot_generation[slot_a < slot_b ? slot_a : slot_b];
+    *generation_b = contact->type == CONTACT_BORDER ? 0 : bodies->slot_generation[slot_a < slot_b ? slot_b : slot_a];
+
+    return pairmap_key(slot_a, slot_b);
+
+}
+
+// keeps only the pairs touched by this frame's update
+static bool contactcache_keep_touching(uint64_t key, void *value, void *context)
+{
+
+    const contactcache_t *cache = context;
+    const contactcache_entry_t *entry = value;
+
+    (void)key;
+
+    return entry->last_frame == cache->frame;
+
+}
@@ -30,6 +30,18 @@ void evt_sdl_keydown_handler(SDL_Event *event, simulation_t *sim)
             sim->userinteractions->escape_pressed = true;
             break;
 
+        case SDL_SCANCODE_EQUALS:
+            sim->userinteractions->plus_pressed = true;
+            break;
+
+        case SDL_SCANCODE_MINUS:
+            sim->userinteractions->minus_pressed = true;
+            break;
+
+        case SDL_SCANCODE_C:
+            sim->userinteractions->c_pressed = true;
+            break;
+
         default:
             break;
     }
@@ -47,9 +59,53 @@ void evt_sdl_keyup_handler(SDL_Event *event, simulation_t *sim)
 
         case SDL_SCANCODE_ESCAPE:
             sim->userinteractions->escape_pressed = false;
+            break;
+
+        case SDL_SCANCODE_EQUALS:
+            sim->userinteractions->plus_pressed = false;
+            break;
+
+        case SDL_SCANCODE_MINUS:
+            sim->userinteractions->minus_pressed = false;
+            break;
+
+        case SDL_SCANCODE_C:
+            sim->userinteractions->c_pressed = false;
+            break;
 
         default:
             break;
     }
 
+}
+
+// tracks the left and right buttons, and where the cursor was when one went down or up
+void evt_sdl_mousebutton_handler(SDL_Event *event, simulation_t *sim)
+{
+
+    bool pressed = event->button.state == SDL_PRESSED;
+
+    switch (event->button.button)
+    {
+        case SDL_BUTTON_LEFT:
+            sim->userinteractions->left_pressed = pressed;
+            break;
+
+        case SDL_BUTTON_RIGHT:
+            sim->userinteractions->right_pressed = pressed;
+            break;
+
+        default:
+            break;
+    }
+
+    sim->userinteractions->mouse_x = event->button.x;
+    sim->userinteractions->mouse_y = event->button.y;
+
+}
+
+void evt_sdl_mousemotion_handler(SDL_Event *event, simulation_t *sim)
+{
+    sim->userinteractions->mouse_x = event->motion.x;
+    sim->userinteractions->mouse_y = event->motion.y;
 }
\ No newline at end of file
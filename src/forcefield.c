@@ -0,0 +1,576 @@
+/*
+ *  forcefield.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define FORCEFIELD_X86_SIMD 1
+#else
+#define FORCEFIELD_X86_SIMD 0
+#endif
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/bodystore.h"
+#include "../inc/workers.h"
+#include "../inc/forcefield.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// what a range of the sampling pass needs, handed to the workers
+typedef struct forcefield_job_t
+{
+
+    const forcefield_t  *field;
+    bodystore_t         *bodies;
+
+} forcefield_job_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+static bool forcefield_span(float low, float high, float min, float inv, uint32_t count, uint32_t *first, uint32_t *last);
+static bool forcefield_read_token(FILE *file, char *token, size_t size);
+static bool forcefield_read_float(FILE *file, float *value);
+static void forcefield_apply_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+
+static void forcefield_select_sampler(forcefield_t *field);
+static uint32_t forcefield_sample_none(const forcefield_t *field, bodystore_t *bodies, uint32_t begin, uint32_t end);
+
+#if (FORCEFIELD_X86_SIMD)
+static uint32_t forcefield_sample_sse2(const forcefield_t *field, bodystore_t *bodies, uint32_t begin, uint32_t end);
+static uint32_t forcefield_sample_avx2(const forcefield_t *field, bodystore_t *bodies, uint32_t begin, uint32_t end);
+#endif
+
+/* ---------------------------------------------------------------------------------------- */
+
+// lays an empty columns by rows grid over [min_x, max_x] x [min_y, max_y]. workers may be NULL,
+// bodies are then sampled on the calling thread
+void forcefield_init(forcefield_t *field, float min_x, float min_y, float max_x, float max_y, uint32_t columns, uint32_t rows, workers_t *workers)
+{
+
+    memset(field, 0, sizeof(forcefield_t));
+
+    field->workers = workers;
+    field->min_x   = min_x;
+    field->min_y   = min_y;
+    field->max_x   = max_x;
+    field->max_y   = max_y;
+
+    forcefield_resize(field, columns, rows);
+    forcefield_select_sampler(field);
+
+}
+
+void forcefield_destroy(forcefield_t *field)
+{
+
+    free(field->x_acc);
+    free(field->y_acc);
+
+    memset(field, 0, sizeof(forcefield_t));
+
+}
+
+// changes the grid's resolution over the same area and clears it
+void forcefield_resize(forcefield_t *field, uint32_t columns, uint32_t rows)
+{
+
+    field->columns = SDL_max(columns, FORCEFIELD_MIN_POINTS);
+    field->rows    = SDL_max(rows,    FORCEFIELD_MIN_POINTS);
+    field->inv_dx  = (field->columns - 1) / SDL_max(field->max_x - field->min_x, 1.0f);
+    field->inv_dy  = (field->rows    - 1) / SDL_max(field->max_y - field->min_y, 1.0f);
+    field->x_acc   = realloc(field->x_acc, field->columns * field->rows * sizeof(float));
+    field->y_acc   = realloc(field->y_acc, field->columns * field->rows * sizeof(float));
+
+    forcefield_clear(field);
+
+}
+
+void forcefield_clear(forcefield_t *field)
+{
+
+    memset(field->x_acc, 0, field->columns * field->rows * sizeof(float));
+    memset(field->y_acc, 0, field->columns * field->rows * sizeof(float));
+
+    field->enabled = false;
+
+}
+
+// sets the acceleration at one grid point
+void forcefield_set(forcefield_t *field, uint32_t column, uint32_t row, float ax, float ay)
+{
+
+    if (column >= field->columns || row >= field->rows)
+    {
+        return;
+    }
+
+    field->x_acc[row * field->columns + column] = ax;
+    field->y_acc[row * field->columns + column] = ay;
+    field->enabled = true;
+
+}
+
+// adds the same acceleration everywhere
+void forcefield_add_wind(forcefield_t *field, float ax, float ay)
+{
+
+    for (uint32_t k = 0; k < field->columns * field->rows; k++)
+    {
+        field->x_acc[k] += ax;
+        field->y_acc[k] += ay;
+    }
+
+    field->enabled = true;
+
+}
+
+// adds a swirl around (x, y), strongest at the center and fading out at radius. A positive
+// strength turns counterclockwise with y pointing up
+void forcefield_add_vortex(forcefield_t *field, float x, float y, float radius, float strength)
+{
+
+    uint32_t first_i, last_i, first_j, last_j, k;
+    float dx, dy, d, s;
+
+    if (!forcefield_span(x - radius, x + radius, field->min_x, field->inv_dx, field->columns, &first_i, &last_i) ||
+        !forcefield_span(y - radius, y + radius, field->min_y, field->inv_dy, field->rows,    &first_j, &last_j))
+    {
+        return;
+    }
+
+    for (uint32_t j = first_j; j <= last_j; j++)
+    {
+        for (uint32_t i = first_i; i <= last_i; i++)
+        {
+
+            dx = field->min_x + i / field->inv_dx - x;
+            dy = field->min_y + j / field->inv_dy - y;
+            d  = sqrtf(dx * dx + dy * dy);
+
+            if (d >= radius || d == 0.0f)
+            {
+                continue;
+            }
+
+            s = strength * (1.0f - d / radius) / d;
+            k = j * field->columns + i;
+
+            field->x_acc[k] -= dy * s;
+            field->y_acc[k] += dx * s;
+
+        }
+    }
+
+    field->enabled = true;
+
+}
+
+// adds a pull toward (x, y), strongest at the center and fading out at radius. A negative
+// strength pushes away instead
+void forcefield_add_attractor(forcefield_t *field, float x, float y, float radius, float strength)
+{
+
+    uint32_t first_i, last_i, first_j, last_j, k;
+    float dx, dy, d, s;
+
+    if (!forcefield_span(x - radius, x + radius, field->min_x, field->inv_dx, field->columns, &first_i, &last_i) ||
+        !forcefield_span(y - radius, y + radius, field->min_y, field->inv_dy, field->rows,    &first_j, &last_j))
+    {
+        return;
+    }
+
+    for (uint32_t j = first_j; j <= last_j; j++)
+    {
+        for (uint32_t i = first_i; i <= last_i; i++)
+        {
+
+            dx = field->min_x + i / field->inv_dx - x;
+            dy = field->min_y + j / field->inv_dy - y;
+            d  = sqrtf(dx * dx + dy * dy);
+
+            if (d >= radius || d == 0.0f)
+            {
+                continue;
+            }
+
+            s = strength * (1.0f - d / radius) / d;
+            k = j * field->columns + i;
+
+            field->x_acc[k] -= dx * s;
+            field->y_acc[k] -= dy * s;
+
+        }
+    }
+
+    field->enabled = true;
+
+}
+
+// replaces the grid with one read from a file, see forcefield.h for the format. Returns false and
+// leaves the field as it was if the file can't be read or is malformed
+bool forcefield_load(forcefield_t *field, const char *path)
+{
+
+    FILE *file = fopen(path, "r");
+    float columns, rows, *x_acc, *y_acc;
+    uint32_t count, k;
+    bool ok = true;
+
+    if (!file)
+    {
+        return false;
+    }
+
+    if (!forcefield_read_float(file, &columns) || !forcefield_read_float(file, &rows) ||
+        columns < FORCEFIELD_MIN_POINTS || rows < FORCEFIELD_MIN_POINTS || columns * rows > (float)(1 << 24) ||
+        columns != floorf(columns) || rows != floorf(rows))
+    {
+        fclose(file);
+        return false;
+    }
+
+    count = (uint32_t)columns * (uint32_t)rows;
+    x_acc = malloc(count * sizeof(float));
+    y_acc = malloc(count * sizeof(float));
+
+    for (k = 0; k < count && ok; k++)
+    {
+        ok = forcefield_read_float(file, &x_acc[k]) && forcefield_read_float(file, &y_acc[k]);
+    }
+
+    fclose(file);
+
+    if (ok)
+    {
+        forcefield_resize(field, (uint32_t)columns, (uint32_t)rows);
+
+        memcpy(field->x_acc, x_acc, count * sizeof(float));
+        memcpy(field->y_acc, y_acc, count * sizeof(float));
+
+        field->enabled = true;
+    }
+
+    free(x_acc);
+    free(y_acc);
+
+    return ok;
+
+}
+
+// the field at (x, y), interpolated between the four grid points around it. The reference the
+// batch samplers must match bit for bit
+void forcefield_sample(const forcefield_t *field, float x, float y, float *ax, float *ay)
+{
+
+    // grid coordinates, held to the grid and then to the cell whose corner they're past
+    float u  = SDL_max(SDL_min((x - field->min_x) * field->inv_dx, (float)(field->columns - 1)), 0.0f);
+    float v  = SDL_max(SDL_min((y - field->min_y) * field->inv_dy, (float)(field->rows    - 1)), 0.0f);
+    float cu = (float)(int32_t)SDL_min(u, (float)(field->columns - 2));
+    float cv = (float)(int32_t)SDL_min(v, (float)(field->rows    - 2));
+    float fu = u - cu;
+    float fv = v - cv;
+
+    uint32_t k = (uint32_t)(int32_t)(cv * (float)field->columns + cu);
+    uint32_t w = field->columns;
+    float bottom, top;
+
+    bottom = field->x_acc[k]     + (field->x_acc[k + 1]     - field->x_acc[k])     * fu;
+    top    = field->x_acc[k + w] + (field->x_acc[k + w + 1] - field->x_acc[k + w]) * fu;
+    *ax    = bottom + (top - bottom) * fv;
+
+    bottom = field->y_acc[k]     + (field->y_acc[k + 1]     - field->y_acc[k])     * fu;
+    top    = field->y_acc[k + w] + (field->y_acc[k + w + 1] - field->y_acc[k + w]) * fu;
+    *ay    = bottom + (top - bottom) * fv;
+
+}
+
+// adds the field to the external acceleration of every awake body, across the workers. Does
+// nothing while the field is empty
+void forcefield_apply(forcefield_t *field, bodystore_t *bodies)
+{
+
+    forcefield_job_t job = { field, bodies };
+
+    if (!field->enabled)
+    {
+        return;
+    }
+
+    if (field->workers)
+    {
+        workers_parallel_for(field->workers, bodies->awake_count, FORCEFIELD_GRAIN, forcefield_apply_job, &job);
+    }
+    else
+    {
+        forcefield_apply_range(field, bodies, 0, bodies->awake_count);
+    }
+
+}
+
+// adds the field to the external acceleration of bodies [begin, end), in batches as wide as the
+// CPU allows and the rest one by one
+void forcefield_apply_range(const forcefield_t *field, bodystore_t *bodies, uint32_t begin, uint32_t end)
+{
+
+    float ax, ay;
+
+    for (uint32_t i = field->sampler(field, bodies, begin, end); i < end; i++)
+    {
+        forcefield_sample(field, bodystore_center(bodies->x_pos[i], bodies->width[i]), bodystore_center(bodies->y_pos[i], bodies->width[i]), &ax, &ay);
+        bodies->ext_x_acc[i] += ax;
+        bodies->ext_y_acc[i] += ay;
+    }
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// grid points along one axis that lie within [low, high], false if there are none
+static bool forcefield_span(float low, float high, float min, float inv, uint32_t count, uint32_t *first, uint32_t *last)
+{
+
+    float f = SDL_max(ceilf((low - min) * inv), 0.0f);
+    float l = SDL_min(floorf((high - min) * inv), (float)(count - 1));
+
+    if (!(f <= l))
+    {
+        return false;
+    }
+
+    *first = (uint32_t)f;
+    *last  = (uint32_t)l;
+
+    return true;
+
+}
+
+// next whitespace separated token of a field file, skipping comments. Returns false at the end of
+// the file
+static bool forcefield_read_token(FILE *file, char *token, size_t size)
+{
+
+    size_t n = 0;
+    int c;
+
+    while ((c = fgetc(file)) != EOF)
+    {
+
+        if (c == '#')
+        {
+            while ((c = fgetc(file)) != EOF && c != '\n');
+            continue;
+        }
+
+        if (!isspace(c))
+        {
+            break;
+        }
+
+    }
+
+    while (c != EOF && !isspace(c) && c != '#')
+    {
+
+        if (n + 1 < size)
+        {
+            token[n++] = (char)c;
+        }
+
+        c = fgetc(file);
+
+    }
+
+    if (c == '#')
+    {
+        ungetc(c, file);
+    }
+
+    token[n] = '\0';
+
+    return n > 0;
+
+}
+
+static bool forcefield_read_float(FILE *file, float *value)
+{
+
+    char token[64], *end;
+
+    if (!forcefield_read_token(file, token, sizeof(token)))
+    {
+        return false;
+    }
+
+    *value = strtof(token, &end);
+
+    return *end == '\0' && isfinite(*value);
+
+}
+
+static void forcefield_apply_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+    forcefield_job_t *job = context;
+    forcefield_apply_range(job->field, job->bodies, begin, end);
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// picks the widest batch sampler this CPU can run
+static void forcefield_select_sampler(forcefield_t *field)
+{
+
+    #if (FORCEFIELD_X86_SIMD)
+    {
+        if (SDL_HasAVX2())
+        {
+            field->sampler      = forcefield_sample_avx2;
+            field->sampler_name = "avx2";
+            return;
+        }
+
+        if (SDL_HasSSE2())
+        {
+            field->sampler      = forcefield_sample_sse2;
+            field->sampler_name = "sse2";
+            return;
+        }
+    }
+    #endif
+
+    field->sampler      = forcefield_sample_none;
+    field->sampler_name = "scalar";
+
+}
+
+// leaves every body to forcefield_sample
+static uint32_t forcefield_sample_none(const forcefield_t *field, bodystore_t *bodies, uint32_t begin, uint32_t end)
+{
+    return begin;
+}
+
+#if (FORCEFIELD_X86_SIMD)
+
+/*
+ *  The batch samplers work out the grid coordinates and weights of a group of bodies at once.
+ *  SSE2 has no gather, so it reads the corners one lane at a time; AVX2 gathers them. Every
+ *  operation mirrors forcefield_sample in the same order, with no FMA, so the results match it.
+ */
+
+__attribute__((target("sse2")))
+static uint32_t forcefield_sample_sse2(const forcefield_t *field, bodystore_t *bodies, uint32_t begin, uint32_t end)
+{
+
+    const __m128 min_x  = _mm_set1_ps(field->min_x), inv_dx = _mm_set1_ps(field->inv_dx);
+    const __m128 min_y  = _mm_set1_ps(field->min_y), inv_dy = _mm_set1_ps(field->inv_dy);
+    const __m128 max_u  = _mm_set1_ps((float)(field->columns - 1)), last_u = _mm_set1_ps((float)(field->columns - 2));
+    const __m128 max_v  = _mm_set1_ps((float)(field->rows    - 1)), last_v = _mm_set1_ps((float)(field->rows    - 2));
+    const __m128 width  = _mm_set1_ps((float)field->columns);
+    const __m128 zero   = _mm_setzero_ps();
+    const __m128 half   = _mm_set1_ps(0.5f);
+    const uint32_t w    = field->columns;
+    const float *xa = field->x_acc, *ya = field->y_acc;
+
+    uint32_t i, k[4];
+    __m128 r, u, v, cu, cv, fu, fv, a00, a10, a01, a11, bottom, top;
+
+    for (i = begin; i + 4 <= end; i += 4)
+    {
+
+        // sampled at the center, bodystore_center in lanes
+        r  = _mm_mul_ps(_mm_loadu_ps(&bodies->width[i]), half);
+        u  = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_loadu_ps(&bodies->x_pos[i]), r), min_x), inv_dx), max_u), zero);
+        v  = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_loadu_ps(&bodies->y_pos[i]), r), min_y), inv_dy), max_v), zero);
+        cu = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_min_ps(u, last_u)));
+        cv = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_min_ps(v, last_v)));
+        fu = _mm_sub_ps(u, cu);
+        fv = _mm_sub_ps(v, cv);
+
+        _mm_storeu_si128((__m128i*)k, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(cv, width), cu)));
+
+        a00    = _mm_setr_ps(xa[k[0]],         xa[k[1]],         xa[k[2]],         xa[k[3]]);
+        a10    = _mm_setr_ps(xa[k[0] + 1],     xa[k[1] + 1],     xa[k[2] + 1],     xa[k[3] + 1]);
+        a01    = _mm_setr_ps(xa[k[0] + w],     xa[k[1] + w],     xa[k[2] + w],     xa[k[3] + w]);
+        a11    = _mm_setr_ps(xa[k[0] + w + 1], xa[k[1] + w + 1], xa[k[2] + w + 1], xa[k[3] + w + 1]);
+        bottom = _mm_add_ps(a00, _mm_mul_ps(_mm_sub_ps(a10, a00), fu));
+        top    = _mm_add_ps(a01, _mm_mul_ps(_mm_sub_ps(a11, a01), fu));
+        _mm_storeu_ps(&bodies->ext_x_acc[i], _mm_add_ps(_mm_loadu_ps(&bodies->ext_x_acc[i]), _mm_add_ps(bottom, _mm_mul_ps(_mm_sub_ps(top, bottom), fv))));
+
+        a00    = _mm_setr_ps(ya[k[0]],         ya[k[1]],         ya[k[2]],         ya[k[3]]);
+        a10    = _mm_setr_ps(ya[k[0] + 1],     ya[k[1] + 1],     ya[k[2] + 1],     ya[k[3] + 1]);
+        a01    = _mm_setr_ps(ya[k[0] + w],     ya[k[1] + w],     ya[k[2] + w],     ya[k[3] + w]);
+        a11    = _mm_setr_ps(ya[k[0] + w + 1], ya[k[1] + w + 1], ya[k[2] + w + 1], ya[k[3] + w + 1]);
+        bottom = _mm_add_ps(a00, _mm_mul_ps(_mm_sub_ps(a10, a00), fu));
+        top    = _mm_add_ps(a01, _mm_mul_ps(_mm_sub_ps(a11, a01), fu));
+        _mm_storeu_ps(&bodies->ext_y_acc[i], _mm_add_ps(_mm_loadu_ps(&bodies->ext_y_acc[i]), _mm_add_ps(bottom, _mm_mul_ps(_mm_sub_ps(top, bottom), fv))));
+
+    }
+
+    return i;
+
+}
+
+__attribute__((target("avx2")))
+static uint32_t forcefield_sample_avx2(const forcefield_t *field, bodystore_t *bodies, uint32_t begin, uint32_t end)
+{
+
+    const __m256 min_x  = _mm256_set1_ps(field->min_x), inv_dx = _mm256_set1_ps(field->inv_dx);
+    const __m256 min_y  = _mm256_set1_ps(field->min_y), inv_dy = _mm256_set1_ps(field->inv_dy);
+    const __m256 max_u  = _mm256_set1_ps((float)(field->columns - 1)), last_u = _mm256_set1_ps((float)(field->columns - 2));
+    const __m256 max_v  = _mm256_set1_ps((float)(field->rows    - 1)), last_v = _mm256_set1_ps((float)(field->rows    - 2));
+    const __m256 width  = _mm256_set1_ps((float)field->columns);
+    const __m256 zero   = _mm256_setzero_ps();
+    const __m256 half   = _mm256_set1_ps(0.5f);
+    const __m256i one   = _mm256_set1_epi32(1);
+    const __m256i row   = _mm256_set1_epi32((int)field->columns);
+    const float *xa = field->x_acc, *ya = field->y_acc;
+
+    uint32_t i;
+    __m256 r, u, v, cu, cv, fu, fv, bottom, top;
+    __m256i k00, k10, k01, k11;
+
+    for (i = begin; i + 8 <= end; i += 8)
+    {
+
+        r  = _mm256_mul_ps(_mm256_loadu_ps(&bodies->width[i]), half);
+        u  = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(&bodies->x_pos[i]), r), min_x), inv_dx), max_u), zero);
+        v  = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(&bodies->y_pos[i]), r), min_y), inv_dy), max_v), zero);
+        cu = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_min_ps(u, last_u)));
+        cv = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_min_ps(v, last_v)));
+        fu = _mm256_sub_ps(u, cu);
+        fv = _mm256_sub_ps(v, cv);
+
+        k00 = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(cv, width), cu));
+        k10 = _mm256_add_epi32(k00, one);
+        k01 = _mm256_add_epi32(k00, row);
+        k11 = _mm256_add_epi32(k01, one);
+
+        bottom = _mm256_i32gather_ps(xa, k00, 4);
+        bottom = _mm256_add_ps(bottom, _mm256_mul_ps(_mm256_sub_ps(_mm256_i32gather_ps(xa, k10, 4), bottom), fu));
+        top    = _mm256_i32gather_ps(xa, k01, 4);
+        top    = _mm256_add_ps(top, _mm256_mul_ps(_mm256_sub_ps(_mm256_i32gather_ps(xa, k11, 4), top), fu));
+        _mm256_storeu_ps(&bodies->ext_x_acc[i], _mm256_add_ps(_mm256_loadu_ps(&bodies->ext_x_acc[i]), _mm256_add_ps(bottom, _mm256_mul_ps(_mm256_sub_ps(top, bottom), fv))));
+
+        bottom = _mm256_i32gather_ps(ya, k00, 4);
+        bottom = _mm256_add_ps(bottom, _mm256_mul_ps(_mm256_sub_ps(_mm256_i32gather_ps(ya, k10, 4), bottom), fu));
+        top    = _mm256_i32gather_ps(ya, k01, 4);
+        top    = _mm256_add_ps(top, _mm256_mul_ps(_mm256_sub_ps(_mm256_i32gather_ps(ya, k11, 4), top), fu));
+        _mm256_storeu_ps(&bodies->ext_y_acc[i], _mm256_add_ps(_mm256_loadu_ps(&bodies->ext_y_acc[i]), _mm256_add_ps(bottom, _mm256_mul_ps(_mm256_sub_ps(top, bottom), fv))));
+
+    }
+
+    return i;
+
+}
+
+#endif
@@ -0,0 +1,805 @@
+/*
+ *  gravity.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/bodystore.h"
+#include "../inc/workers.h"
+#include "../inc/gravity.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// what a range of a gravity pass needs, handed to the workers
+typedef struct gravity_job_t
+{
+
+    gravity_t           *gravity;
+    bodystore_t         *bodies;
+    uint32_t            shift;                                  // radix passes: where the digit being sorted sits in the key
+    const uint64_t      *src;                                   // radix passes: keys being sorted
+    uint64_t            *dst;                                   // radix scatter: where they go
+
+} gravity_job_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+static void gravity_reserve(gravity_t *gravity, const bodystore_t *bodies);
+static void gravity_run(gravity_t *gravity, uint32_t total, uint32_t grain, workers_range_t job, gravity_job_t *context);
+static void gravity_bound(gravity_t *gravity, gravity_job_t *job, uint32_t count);
+static void gravity_sort(gravity_t *gravity, gravity_job_t *job, uint32_t count);
+static void gravity_build_tree(gravity_t *gravity, gravity_job_t *job, uint32_t count);
+static void gravity_build(gravity_t *gravity, gravity_subtree_t *subtree, gravity_node_t *node, uint32_t first, uint32_t count, uint32_t depth);
+static void gravity_sum_children(gravity_node_t *node, const gravity_node_t *children);
+static uint32_t gravity_lower_bound(const uint64_t *keys, uint32_t first, uint32_t end, uint64_t key);
+static void gravity_walk(const gravity_t *gravity, uint32_t k, float *ax, float *ay);
+static uint32_t gravity_spread_bits(uint32_t v);
+
+static void gravity_bound_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void gravity_encode_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void gravity_histogram_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void gravity_scatter_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void gravity_gather_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void gravity_subtree_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void gravity_place_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void gravity_walk_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void gravity_direct_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+
+/* ---------------------------------------------------------------------------------------- */
+
+// the pull of a point mass at (x, y) on a body at (px, py), added to (ax, ay) without the constant
+static inline void gravity_accumulate(float px, float py, float x, float y, float mass, float *ax, float *ay)
+{
+
+    float dx = x - px;
+    float dy = y - py;
+    float r2 = dx * dx + dy * dy + GRAVITY_SOFTENING * GRAVITY_SOFTENING;
+    float s  = mass / (r2 * sqrtf(r2));
+
+    *ax += dx * s;
+    *ay += dy * s;
+
+}
+
+// index of the first node of a top level
+static inline uint32_t gravity_level_start(uint32_t level)
+{
+    return ((1u << (2 * level)) - 1) / 3;
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// workers may be NULL, every pass then runs on the calling thread
+void gravity_init(gravity_t *gravity, gravity_mode_t mode, float theta, workers_t *workers)
+{
+
+    memset(gravity, 0, sizeof(gravity_t));
+
+    gravity->mode    = mode;
+    gravity->theta   = theta;
+    gravity->workers = workers;
+
+}
+
+void gravity_destroy(gravity_t *gravity)
+{
+
+    free(gravity->keys);
+    free(gravity->scratch);
+    free(gravity->x);
+    free(gravity->y);
+    free(gravity->mass);
+    free(gravity->histograms);
+    free(gravity->chunk_bounds);
+    free(gravity->nodes);
+
+    for (uint32_t c = 0; c < GRAVITY_TOP_CELLS; c++)
+    {
+        free(gravity->subtrees[c].nodes);
+    }
+
+    memset(gravity, 0, sizeof(gravity_t));
+
+}
+
+// adds the pull of every body on each awake body to its external acceleration, which the
+// integrator adds to its velocity. Does nothing when gravity is off
+void gravity_apply(gravity_t *gravity, bodystore_t *bodies)
+{
+
+    gravity_job_t job = { gravity, bodies, 0, NULL, NULL };
+    const uint32_t count = bodies->count;
+
+    if (gravity->mode == GRAVITY_OFF || bodies->awake_count == 0)
+    {
+        return;
+    }
+
+    if (gravity->mode == GRAVITY_DIRECT)
+    {
+        gravity_run(gravity, bodies->awake_count, GRAVITY_WALK_GRAIN, gravity_direct_job, &job);
+        return;
+    }
+
+    gravity_reserve(gravity, bodies);
+
+    gravity_bound(gravity, &job, count);
+    gravity_sort(gravity, &job, count);
+    gravity_run(gravity, count, GRAVITY_GRAIN, gravity_gather_job, &job);
+    gravity_build_tree(gravity, &job, count);
+
+    // walking in sorted order keeps neighbouring bodies, which open the same nodes, on one thread
+    gravity_run(gravity, count, GRAVITY_WALK_GRAIN, gravity_walk_job, &job);
+
+}
+
+const char* gravity_mode_name(gravity_mode_t mode)
+{
+
+    switch (mode)
+    {
+        case GRAVITY_OFF:           return "off";
+        case GRAVITY_BARNES_HUT:    return "barnes-hut";
+        case GRAVITY_DIRECT:        return "direct";
+        default:                    return "unknown";
+    }
+
+}
+
+// looks up a gravity mode by the name gravity_mode_name gives it, returns false if there's no match
+bool gravity_parse_mode(const char *name, gravity_mode_t *mode)
+{
+
+    for (gravity_mode_t m = GRAVITY_OFF; m <= GRAVITY_DIRECT; m++)
+    {
+        if (!strcmp(name, gravity_mode_name(m)))
+        {
+            *mode = m;
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// grows the per-body and per-chunk arrays to fit every body in the store
+static void gravity_reserve(gravity_t *gravity, const bodystore_t *bodies)
+{
+
+    uint32_t chunks;
+
+    if (bodies->count > gravity->capacity)
+    {
+        gravity->capacity = bodies->capacity;
+        gravity->keys     = realloc(gravity->keys,    gravity->capacity * sizeof(uint64_t));
+        gravity->scratch  = realloc(gravity->scratch, gravity->capacity * sizeof(uint64_t));
+        gravity->x        = realloc(gravity->x,       gravity->capacity * sizeof(float));
+        gravity->y        = realloc(gravity->y,       gravity->capacity * sizeof(float));
+        gravity->mass     = realloc(gravity->mass,    gravity->capacity * sizeof(float));
+    }
+
+    chunks = (bodies->count + GRAVITY_GRAIN - 1) / GRAVITY_GRAIN;
+
+    if (chunks > gravity->chunk_capacity)
+    {
+        gravity->chunk_capacity = chunks;
+        gravity->histograms     = realloc(gravity->histograms,   chunks * GRAVITY_RADIX_SIZE * sizeof(uint32_t));
+        gravity->chunk_bounds   = realloc(gravity->chunk_bounds, chunks * 4 * sizeof(float));
+    }
+
+}
+
+// runs a pass across the workers, or on the calling thread without them
+static void gravity_run(gravity_t *gravity, uint32_t total, uint32_t grain, workers_range_t job, gravity_job_t *context)
+{
+
+    if (gravity->workers)
+    {
+        workers_parallel_for(gravity->workers, total, grain, job, context);
+    }
+    else
+    {
+        job(0, total, 0, context);
+    }
+
+}
+
+// finds the square root cell around every body, each chunk bounds its bodies and the chunks are
+// merged after
+static void gravity_bound(gravity_t *gravity, gravity_job_t *job, uint32_t count)
+{
+
+    const uint32_t chunks = (count + GRAVITY_GRAIN - 1) / GRAVITY_GRAIN;
+    const float *b;
+    float min_x = FLT_MAX, min_y = FLT_MAX, max_x = -FLT_MAX, max_y = -FLT_MAX;
+
+    gravity_run(gravity, count, GRAVITY_GRAIN, gravity_bound_job, job);
+
+    for (uint32_t c = 0; c < chunks; c++)
+    {
+        b = &gravity->chunk_bounds[c * 4];
+        min_x = SDL_min(min_x, b[0]);
+        min_y = SDL_min(min_y, b[1]);
+        max_x = SDL_max(max_x, b[2]);
+        max_y = SDL_max(max_y, b[3]);
+    }
+
+    gravity->min_x = min_x;
+    gravity->min_y = min_y;
+    gravity->size  = SDL_max(SDL_max(max_x - min_x, max_y - min_y), 1.0f);
+
+}
+
+// gives every body its Morton code and sorts them by it, a least significant digit first radix
+// sort over the code's bytes. Each chunk counts its digits, the counts are turned into where each
+// chunk scatters each digit, and each chunk scatters in order, so the sort is stable and the same
+// on any number of threads
+static void gravity_sort(gravity_t *gravity, gravity_job_t *job, uint32_t count)
+{
+
+    const uint32_t chunks = (count + GRAVITY_GRAIN - 1) / GRAVITY_GRAIN;
+    uint64_t *src = gravity->keys, *dst = gravity->scratch, *t;
+    uint32_t *h, total, start, d, c;
+    bool uniform;
+
+    gravity_run(gravity, count, GRAVITY_GRAIN, gravity_encode_job, job);
+
+    for (uint32_t shift = 32; shift < 64; shift += GRAVITY_RADIX_BITS)
+    {
+
+        job->shift = shift;
+        job->src   = src;
+        job->dst   = dst;
+
+        gravity_run(gravity, count, GRAVITY_GRAIN, gravity_histogram_job, job);
+
+        start   = 0;
+        uniform = false;
+
+        for (d = 0; d < GRAVITY_RADIX_SIZE; d++)
+        {
+
+            for (total = 0, c = 0; c < chunks; c++)
+            {
+                h = &gravity->histograms[c * GRAVITY_RADIX_SIZE + d];
+                total += *h;
+                *h = start + total - *h;
+            }
+
+            uniform |= total == count;
+            start   += total;
+
+        }
+
+        // every key has the same digit, which happens to the top bytes of a small or tight scene
+        if (uniform)
+        {
+            continue;
+        }
+
+        gravity_run(gravity, count, GRAVITY_GRAIN, gravity_scatter_job, job);
+
+        t   = src;
+        src = dst;
+        dst = t;
+
+    }
+
+    gravity->keys    = src;
+    gravity->scratch = dst;
+
+}
+
+// builds the quadtree over the sorted bodies. The top levels are always split, so the bodies of
+// each top cell are a range of the sorted order found by its code prefix, and the cells build
+// their subtrees side by side. The subtrees are then copied in behind the top levels, which are
+// summed up from the cells last
+static void gravity_build_tree(gravity_t *gravity, gravity_job_t *job, uint32_t count)
+{
+
+    const uint32_t top_shift = 64 - 2 * GRAVITY_TOP_LEVELS;
+    uint32_t bounds[GRAVITY_TOP_CELLS + 1];
+    uint32_t c, level, j, start, below;
+    gravity_node_t *node;
+
+    for (c = 0; c < GRAVITY_TOP_CELLS; c++)
+    {
+        bounds[c] = gravity_lower_bound(gravity->keys, 0, count, (uint64_t)c << top_shift);
+    }
+
+    bounds[GRAVITY_TOP_CELLS] = count;
+
+    for (c = 0; c < GRAVITY_TOP_CELLS; c++)
+    {
+        gravity->subtrees[c].root.first = bounds[c];
+        gravity->subtrees[c].root.count = bounds[c + 1] - bounds[c];
+    }
+
+    gravity_run(gravity, GRAVITY_TOP_CELLS, 1, gravity_subtree_job, job);
+
+    gravity->node_count = GRAVITY_TOP_NODES;
+
+    for (c = 0; c < GRAVITY_TOP_CELLS; c++)
+    {
+        gravity->subtrees[c].offset = gravity->node_count;
+        gravity->node_count += gravity->subtrees[c].count;
+    }
+
+    if (gravity->node_count > gravity->node_capacity)
+    {
+        gravity->node_capacity = SDL_max(gravity->node_count, gravity->node_capacity * 2);
+        gravity->nodes         = realloc(gravity->nodes, gravity->node_capacity * sizeof(gravity_node_t));
+    }
+
+    gravity_run(gravity, GRAVITY_TOP_CELLS, 1, gravity_place_job, job);
+
+    // node j of a top level holds the cells whose codes start with j, its children are 4j to 4j + 3
+    // of the level below
+    for (level = GRAVITY_TOP_LEVELS; level-- > 0;)
+    {
+
+        start = gravity_level_start(level);
+        below = gravity_level_start(level + 1);
+
+        for (j = 0; j < (1u << (2 * level)); j++)
+        {
+
+            node = &gravity->nodes[start + j];
+
+            node->child = below + 4 * j;
+            node->size  = gravity->size / (float)(1u << level);
+            node->first = gravity->nodes[node->child].first;
+            node->count = 0;
+
+            gravity_sum_children(node, &gravity->nodes[node->child]);
+
+        }
+
+    }
+
+}
+
+// fills in the node for sorted bodies [first, first + count), a cell depth levels down. Cells with
+// few enough bodies, or as deep as codes go, are leaves; others get four children from subtree,
+// each holding the bodies whose codes continue with its quadrant
+static void gravity_build(gravity_t *gravity, gravity_subtree_t *subtree, gravity_node_t *node, uint32_t first, uint32_t count, uint32_t depth)
+{
+
+    const uint32_t shift = 62 - 2 * depth;
+    const uint64_t prefix = count ? gravity->keys[first] >> (shift + 2) << (shift + 2) : 0;
+    uint32_t split[5], child, j;
+    gravity_node_t children[4];
+
+    node->first = first;
+    node->count = count;
+    node->size  = gravity->size / (float)(1u << depth);
+
+    if (count <= GRAVITY_LEAF_SIZE || depth == GRAVITY_MAX_DEPTH)
+    {
+
+        node->child = GRAVITY_LEAF;
+        node->mass  = 0.0f;
+        node->x     = 0.0f;
+        node->y     = 0.0f;
+
+        for (j = first; j < first + count; j++)
+        {
+            node->mass += gravity->mass[j];
+            node->x    += gravity->mass[j] * gravity->x[j];
+            node->y    += gravity->mass[j] * gravity->y[j];
+        }
+
+        if (node->mass > 0.0f)
+        {
+            node->x /= node->mass;
+            node->y /= node->mass;
+        }
+
+        return;
+
+    }
+
+    split[0] = first;
+    split[4] = first + count;
+
+    for (j = 1; j < 4; j++)
+    {
+        split[j] = gravity_lower_bound(gravity->keys, split[j - 1], split[4], prefix | ((uint64_t)j << shift));
+    }
+
+    if (subtree->count + 4 > subtree->capacity)
+    {
+        subtree->capacity = SDL_max(subtree->capacity * 2, 64);
+        subtree->nodes    = realloc(subtree->nodes, subtree->capacity * sizeof(gravity_node_t));
+    }
+
+    child = subtree->count;
+    subtree->count += 4;
+
+    // the children's own children go in behind them, which may move the array
+    for (j = 0; j < 4; j++)
+    {
+        gravity_build(gravity, subtree, &children[j], split[j], split[j + 1] - split[j], depth + 1);
+    }
+
+    memcpy(&subtree->nodes[child], children, sizeof(children));
+
+    node->child = child;
+    node->count = 0;
+
+    gravity_sum_children(node, children);
+
+}
+
+// a node's mass, center of mass and body count from its four children
+static void gravity_sum_children(gravity_node_t *node, const gravity_node_t *children)
+{
+
+    node->mass = 0.0f;
+    node->x    = 0.0f;
+    node->y    = 0.0f;
+
+    for (uint32_t q = 0; q < 4; q++)
+    {
+        node->count += children[q].count;
+        node->mass  += children[q].mass;
+        node->x     += children[q].mass * children[q].x;
+        node->y     += children[q].mass * children[q].y;
+    }
+
+    if (node->mass > 0.0f)
+    {
+        node->x /= node->mass;
+        node->y /= node->mass;
+    }
+
+}
+
+// first of the sorted keys [first, end) that isn't below key
+static uint32_t gravity_lower_bound(const uint64_t *keys, uint32_t first, uint32_t end, uint64_t key)
+{
+
+    uint32_t middle;
+
+    while (first < end)
+    {
+
+        middle = first + (end - first) / 2;
+
+        if (keys[middle] < key)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            end = middle;
+        }
+
+    }
+
+    return first;
+
+}
+
+// the pull of every body on sorted body k. Nodes far enough away for their size are taken whole,
+// the rest are opened, children in quadrant order so every body sums in a fixed order
+static void gravity_walk(const gravity_t *gravity, uint32_t k, float *ax, float *ay)
+{
+
+    const float px = gravity->x[k];
+    const float py = gravity->y[k];
+    const float theta2 = gravity->theta * gravity->theta;
+    const gravity_node_t *node;
+    uint32_t stack[GRAVITY_STACK], top = 0, j;
+    float dx, dy;
+
+    *ax = 0.0f;
+    *ay = 0.0f;
+
+    stack[top++] = 0;
+
+    while (top)
+    {
+
+        node = &gravity->nodes[stack[--top]];
+
+        if (node->count == 0)
+        {
+            continue;
+        }
+
+        if (node->child == GRAVITY_LEAF)
+        {
+
+            for (j = node->first; j < node->first + node->count; j++)
+            {
+                if (j != k)
+                {
+                    gravity_accumulate(px, py, gravity->x[j], gravity->y[j], gravity->mass[j], ax, ay);
+                }
+            }
+
+            continue;
+
+        }
+
+        dx = node->x - px;
+        dy = node->y - py;
+
+        if (node->size * node->size < theta2 * (dx * dx + dy * dy))
+        {
+            gravity_accumulate(px, py, node->x, node->y, node->mass, ax, ay);
+            continue;
+        }
+
+        for (j = 4; j-- > 0;)
+        {
+            stack[top++] = node->child + j;
+        }
+
+    }
+
+    *ax *= GRAVITY_CONSTANT;
+    *ay *= GRAVITY_CONSTANT;
+
+}
+
+// spreads the low 16 bits of v out to the even bits
+static uint32_t gravity_spread_bits(uint32_t v)
+{
+
+    v &= 0x0000FFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+
+    return v;
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// passes over the bodies, a range can span several chunks when it isn't split
+
+static void gravity_bound_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    gravity_job_t *job = context;
+    const bodystore_t *bodies = job->bodies;
+    uint32_t chunk_end;
+    float *b, x, y;
+
+    for (; begin < end; begin = chunk_end)
+    {
+
+        chunk_end = SDL_min(begin + GRAVITY_GRAIN, end);
+        b = &job->gravity->chunk_bounds[(begin / GRAVITY_GRAIN) * 4];
+
+        b[0] = b[1] =  FLT_MAX;
+        b[2] = b[3] = -FLT_MAX;
+
+        for (uint32_t i = begin; i < chunk_end; i++)
+        {
+            x    = bodystore_center(bodies->x_pos[i], bodies->width[i]);
+            y    = bodystore_center(bodies->y_pos[i], bodies->width[i]);
+            b[0] = SDL_min(b[0], x);
+            b[1] = SDL_min(b[1], y);
+            b[2] = SDL_max(b[2], x);
+            b[3] = SDL_max(b[3], y);
+        }
+
+    }
+
+}
+
+// 16 bits of each axis across the root cell, interleaved x first
+static void gravity_encode_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    gravity_job_t *job = context;
+    const gravity_t *gravity = job->gravity;
+    const bodystore_t *bodies = job->bodies;
+    const float scale = 65536.0f / gravity->size;
+    uint32_t qx, qy;
+
+    for (uint32_t i = begin; i < end; i++)
+    {
+
+        qx = (uint32_t)SDL_min((bodystore_center(bodies->x_pos[i], bodies->width[i]) - gravity->min_x) * scale, 65535.0f);
+        qy = (uint32_t)SDL_min((bodystore_center(bodies->y_pos[i], bodies->width[i]) - gravity->min_y) * scale, 65535.0f);
+
+        gravity->keys[i] = (uint64_t)(gravity_spread_bits(qx) << 1 | gravity_spread_bits(qy)) << 32 | i;
+
+    }
+
+}
+
+static void gravity_histogram_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    gravity_job_t *job = context;
+    uint32_t chunk_end, *h;
+
+    for (; begin < end; begin = chunk_end)
+    {
+
+        chunk_end = SDL_min(begin + GRAVITY_GRAIN, end);
+        h = &job->gravity->histograms[(begin / GRAVITY_GRAIN) * GRAVITY_RADIX_SIZE];
+
+        memset(h, 0, GRAVITY_RADIX_SIZE * sizeof(uint32_t));
+
+        for (uint32_t i = begin; i < chunk_end; i++)
+        {
+            h[(job->src[i] >> job->shift) & (GRAVITY_RADIX_SIZE - 1)]++;
+        }
+
+    }
+
+}
+
+static void gravity_scatter_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    gravity_job_t *job = context;
+    uint32_t chunk_end, *h;
+    uint64_t key;
+
+    for (; begin < end; begin = chunk_end)
+    {
+
+        chunk_end = SDL_min(begin + GRAVITY_GRAIN, end);
+        h = &job->gravity->histograms[(begin / GRAVITY_GRAIN) * GRAVITY_RADIX_SIZE];
+
+        for (uint32_t i = begin; i < chunk_end; i++)
+        {
+            key = job->src[i];
+            job->dst[h[(key >> job->shift) & (GRAVITY_RADIX_SIZE - 1)]++] = key;
+        }
+
+    }
+
+}
+
+// copies each body's center and mass into sorted order, so leaves read them in a row
+static void gravity_gather_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    gravity_job_t *job = context;
+    gravity_t *gravity = job->gravity;
+    const bodystore_t *bodies = job->bodies;
+    uint32_t i;
+
+    for (uint32_t k = begin; k < end; k++)
+    {
+        i = (uint32_t)gravity->keys[k];
+        gravity->x[k]    = bodystore_center(bodies->x_pos[i], bodies->width[i]);
+        gravity->y[k]    = bodystore_center(bodies->y_pos[i], bodies->width[i]);
+        gravity->mass[k] = bodies->mass[i];
+    }
+
+}
+
+// passes over the top cells
+
+static void gravity_subtree_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    gravity_job_t *job = context;
+    gravity_subtree_t *subtree;
+
+    for (uint32_t c = begin; c < end; c++)
+    {
+        subtree = &job->gravity->subtrees[c];
+        subtree->count = 0;
+        gravity_build(job->gravity, subtree, &subtree->root, subtree->root.first, subtree->root.count, GRAVITY_TOP_LEVELS);
+    }
+
+}
+
+// copies a subtree in behind the top levels, moving its child indices along with it
+static void gravity_place_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    gravity_job_t *job = context;
+    gravity_t *gravity = job->gravity;
+    const gravity_subtree_t *subtree;
+    gravity_node_t *nodes;
+
+    for (uint32_t c = begin; c < end; c++)
+    {
+
+        subtree = &gravity->subtrees[c];
+        nodes   = &gravity->nodes[subtree->offset];
+
+        gravity->nodes[gravity_level_start(GRAVITY_TOP_LEVELS) + c] = subtree->root;
+
+        if (subtree->root.child != GRAVITY_LEAF)
+        {
+            gravity->nodes[gravity_level_start(GRAVITY_TOP_LEVELS) + c].child += subtree->offset;
+        }
+
+        memcpy(nodes, subtree->nodes, subtree->count * sizeof(gravity_node_t));
+
+        for (uint32_t n = 0; n < subtree->count; n++)
+        {
+            if (nodes[n].child != GRAVITY_LEAF)
+            {
+                nodes[n].child += subtree->offset;
+            }
+        }
+
+    }
+
+}
+
+// passes over the sorted bodies, sleeping ones feel nothing
+
+static void gravity_walk_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    gravity_job_t *job = context;
+    const gravity_t *gravity = job->gravity;
+    bodystore_t *bodies = job->bodies;
+    uint32_t i;
+    float ax, ay;
+
+    for (uint32_t k = begin; k < end; k++)
+    {
+
+        i = (uint32_t)gravity->keys[k];
+
+        if (i < bodies->awake_count)
+        {
+            gravity_walk(gravity, k, &ax, &ay);
+            bodies->ext_x_acc[i] += ax;
+            bodies->ext_y_acc[i] += ay;
+        }
+
+    }
+
+}
+
+// passes over the awake bodies
+
+static void gravity_direct_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    gravity_job_t *job = context;
+    bodystore_t *bodies = job->bodies;
+    float ax, ay, x, y;
+
+    for (uint32_t i = begin; i < end; i++)
+    {
+
+        ax = 0.0f;
+        ay = 0.0f;
+        x  = bodystore_center(bodies->x_pos[i], bodies->width[i]);
+        y  = bodystore_center(bodies->y_pos[i], bodies->width[i]);
+
+        for (uint32_t j = 0; j < bodies->count; j++)
+        {
+            if (j != i)
+            {
+                gravity_accumulate(x, y, bodystore_center(bodies->x_pos[j], bodies->width[j]), bodystore_center(bodies->y_pos[j], bodies->width[j]), bodies->mass[j], &ax, &ay);
+            }
+        }
+
+        bodies->ext_x_acc[i] += ax * GRAVITY_CONSTANT;
+        bodies->ext_y_acc[i] += ay * GRAVITY_CONSTANT;
+
+    }
+
+}
@@ -0,0 +1,205 @@
+/*
+ *  islands.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/bodystore.h"
+#include "../inc/collisions.h"
+#include "../inc/islands.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+static uint32_t islands_find(islands_t *islands, uint32_t i);
+static void islands_union(islands_t *islands, uint32_t i, uint32_t j);
+
+/* ---------------------------------------------------------------------------------------- */
+
+void islands_init(islands_t *islands)
+{
+    memset(islands, 0, sizeof(islands_t));
+}
+
+void islands_destroy(islands_t *islands)
+{
+
+    free(islands->parent);
+    free(islands->rested);
+    free(islands->waking);
+    free(islands->sleeping);
+
+    memset(islands, 0, sizeof(islands_t));
+
+}
+
+// call after the solver. Counts how long each awake body has been resting, joins touching bodies
+// into islands, puts islands that have all rested long enough to sleep and wakes sleeping bodies
+// that were touched or pushed. Dense indices change, so the contact list is stale afterwards
+void islands_update(islands_t *islands, bodystore_t *bodies, const contactlist_t *contacts)
+{
+
+    const uint32_t awake = bodies->awake_count;
+    const contact_t *contact;
+    uint32_t i, k, root, wake_count = 0, sleep_count = 0;
+    float vx, vy;
+
+    if (bodies->count > islands->capacity)
+    {
+        islands->capacity = bodies->capacity;
+        islands->parent   = realloc(islands->parent,   islands->capacity * sizeof(uint32_t));
+        islands->rested   = realloc(islands->rested,   islands->capacity * sizeof(uint32_t));
+        islands->waking   = realloc(islands->waking,   islands->capacity * sizeof(uint32_t));
+        islands->sleeping = realloc(islands->sleeping, islands->capacity * sizeof(uint32_t));
+    }
+
+    for (i = 0; i < awake; i++)
+    {
+
+        vx = bodies->x_vel[i];
+        vy = bodies->y_vel[i];
+
+        if (vx * vx + vy * vy < ISLANDS_SLEEP_VELOCITY * ISLANDS_SLEEP_VELOCITY)
+        {
+            bodies->sleep_frames[i]++;
+        }
+        else
+        {
+            bodies->sleep_frames[i] = 0;
+        }
+
+        islands->parent[i] = i;
+        islands->rested[i] = bodies->sleep_frames[i];
+
+    }
+
+    // sleeping bodies only show up in contacts when an awake body touches them. The awake side's
+    // island can't sleep on a body that's about to wake
+    for (k = 0; k < contacts->count; k++)
+    {
+
+        contact = &contacts->contacts[k];
+
+        if (contact->type == CONTACT_BORDER)
+        {
+            continue;
+        }
+
+        if (contact->a >= awake || contact->b >= awake)
+        {
+
+            i = contact->a >= awake ? contact->a : contact->b;
+
+            // a sleeper's rest count is cleared once it's listed, so it's only listed once
+            if (bodies->sleep_frames[i])
+            {
+                bodies->sleep_frames[i] = 0;
+                islands->waking[wake_count++] = bodies->slot[i];
+            }
+
+            if (contact->a < awake) islands->rested[islands_find(islands, contact->a)] = 0;
+            if (contact->b < awake) islands->rested[islands_find(islands, contact->b)] = 0;
+
+            continue;
+
+        }
+
+        islands_union(islands, contact->a, contact->b);
+
+    }
+
+    // so can a sleeping body that something (the continuous collision stage) gave velocity to
+    for (i = awake; i < bodies->count; i++)
+    {
+        if (bodies->sleep_frames[i] && (bodies->x_vel[i] != 0.0f || bodies->y_vel[i] != 0.0f))
+        {
+            bodies->sleep_frames[i] = 0;
+            islands->waking[wake_count++] = bodies->slot[i];
+        }
+    }
+
+    islands->island_count = 0;
+
+    for (i = 0; i < awake; i++)
+    {
+
+        root = islands_find(islands, i);
+
+        if (root == i)
+        {
+            islands->island_count++;
+        }
+
+        if (islands->rested[root] >= ISLANDS_SLEEP_FRAMES)
+        {
+            islands->sleeping[sleep_count++] = bodies->slot[i];
+        }
+
+    }
+
+    // moving bodies between the awake and sleeping ranges reorders them, so go by slot
+    for (k = 0; k < sleep_count; k++)
+    {
+        bodystore_sleep(bodies, bodies->slot_index[islands->sleeping[k]]);
+    }
+
+    for (k = 0; k < wake_count; k++)
+    {
+        bodystore_wake(bodies, bodies->slot_index[islands->waking[k]]);
+    }
+
+    islands->slept = sleep_count;
+    islands->woken = wake_count;
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// root of body i's island, halving the path on the way up
+static uint32_t islands_find(islands_t *islands, uint32_t i)
+{
+
+    uint32_t *parent = islands->parent;
+
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+
+    return i;
+
+}
+
+// joins the islands of bodies i and j, the merged island has rested as long as its least rested body
+static void islands_union(islands_t *islands, uint32_t i, uint32_t j)
+{
+
+    uint32_t t;
+
+    i = islands_find(islands, i);
+    j = islands_find(islands, j);
+
+    if (i == j)
+    {
+        return;
+    }
+
+    // the lower index becomes the root, which keeps trees shallow enough without ranks
+    if (j < i)
+    {
+        t = i;
+        i = j;
+        j = t;
+    }
+
+    islands->parent[j] = i;
+    islands->rested[i] = SDL_min(islands->rested[i], islands->rested[j]);
+
+}
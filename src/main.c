@@ -9,6 +9,7 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "../inc/SDL2/SDL.h"
 #include "../inc/main.h"
@@ -17,6 +18,10 @@
 
 /* ---------------------------------------------------------------------------------------- */
 
+static void main_parse_args(simsettings_t *settings, int argc, char **argv);
+
+/* ---------------------------------------------------------------------------------------- */
+
 int main(int argc, char **argv)
 {   
 
@@ -26,11 +31,15 @@ int main(int argc, char **argv)
     setbuf(stdout, NULL);
 
     simulation_t *simulation;
+    simsettings_t settings;
 
     simulation = malloc(sizeof(simulation_t));
 
+    simulation_default_settings(&settings);
+    main_parse_args(&settings, argc, argv);
+
     printf("initializing...\n");
-    simulation_init(simulation);
+    simulation_init(simulation, &settings);
 
     printf("starting sim...\n");
     simulation_start(simulation);
@@ -43,3 +52,85 @@ int main(int argc, char **argv)
 
 }
 
+/* ---------------------------------------------------------------------------------------- */
+
+// overrides the default settings with any command line options
+//   -n <count>     number of bodies spawned at startup
+//   -b <name>      collision broadphase (brute, grid, sap, bvh)
+//   -i <count>     most contact solver iterations per step
+//   -s <name>      contact solver mode (sequential, colored, jacobi)
+//   -t <count>     worker threads including the main one, 0 for one per CPU
+//   -g <name>      mutual gravitation (off, barnes-hut, direct)
+//   -a <theta>     barnes-hut opening angle, 0 is exact
+//   -f <path>      force field file to load, see forcefield.h for the format
+//   -d <seed>      deterministic run from seed, printing a hash of the body state after every step
+//   -r             draw frames on the CPU and upload them as one texture, no GPU needed
+//   -w <count>     threads the CPU renderer draws with including the main one, 0 for one per CPU
+static void main_parse_args(simsettings_t *settings, int argc, char **argv)
+{
+
+    for (int i = 1; i < argc; i++)
+    {
+
+        if (!strcmp(argv[i], "-n") && (i + 1) < argc)
+        {
+            settings->num_objects = strtoul(argv[++i], NULL, 10);
+        }
+        else if (!strcmp(argv[i], "-b") && (i + 1) < argc)
+        {
+            if (!broadphase_parse_type(argv[++i], &settings->broadphase))
+            {
+                printf("unknown broadphase '%s', using %s\n", argv[i], broadphase_name(settings->broadphase));
+            }
+        }
+        else if (!strcmp(argv[i], "-i") && (i + 1) < argc)
+        {
+            settings->solver_iterations = strtoul(argv[++i], NULL, 10);
+        }
+        else if (!strcmp(argv[i], "-s") && (i + 1) < argc)
+        {
+            if (!solver_parse_mode(argv[++i], &settings->solver_mode))
+            {
+                printf("unknown solver mode '%s', using %s\n", argv[i], solver_mode_name(settings->solver_mode));
+            }
+        }
+        else if (!strcmp(argv[i], "-t") && (i + 1) < argc)
+        {
+            settings->threads = strtoul(argv[++i], NULL, 10);
+        }
+        else if (!strcmp(argv[i], "-g") && (i + 1) < argc)
+        {
+            if (!gravity_parse_mode(argv[++i], &settings->gravity_mode))
+            {
+                printf("unknown gravity mode '%s', using %s\n", argv[i], gravity_mode_name(settings->gravity_mode));
+            }
+        }
+        else if (!strcmp(argv[i], "-a") && (i + 1) < argc)
+        {
+            settings->gravity_theta = strtof(argv[++i], NULL);
+        }
+        else if (!strcmp(argv[i], "-f") && (i + 1) < argc)
+        {
+            settings->field_path = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-d") && (i + 1) < argc)
+        {
+            settings->seed = strtoull(argv[++i], NULL, 10);
+            settings->deterministic = true;
+        }
+        else if (!strcmp(argv[i], "-r"))
+        {
+            settings->software_render = true;
+        }
+        else if (!strcmp(argv[i], "-w") && (i + 1) < argc)
+        {
+            settings->render_threads = strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            printf("ignoring unknown argument '%s'\n", argv[i]);
+        }
+
+    }
+
+}
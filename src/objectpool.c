@@ -0,0 +1,207 @@
+/*
+ *  objectpool.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <stddef.h>
+
+#include "../inc/common.h"
+#include "../inc/objectpool.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// header at the front of every slab allocation, the blocks follow on the next cache line
+struct objectpool_slab_t
+{
+
+    objectpool_slab_t   *next;                                  // next (older) slab
+    void                *raw;                                   // pointer malloc returned, for free
+
+};
+
+/* ---------------------------------------------------------------------------------------- */
+
+static void objectpool_new_slab(objectpool_t *pool, uint32_t blocks);
+static void objectpool_retire_bump(objectpool_t *pool);
+
+/* ---------------------------------------------------------------------------------------- */
+
+// sets up an empty pool handing out blocks of block_size bytes
+void objectpool_init(objectpool_t *pool, size_t block_size)
+{
+
+    memset(pool, 0, sizeof(objectpool_t));
+
+    // freed blocks hold the free list link, keep them pointer sized and aligned
+    if (block_size < sizeof(void *)) block_size = sizeof(void *);
+    pool->block_size = (block_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+}
+
+// frees every slab, invalidating all blocks the pool ever handed out
+void objectpool_destroy(objectpool_t *pool)
+{
+
+    objectpool_slab_t *slab = pool->slabs;
+    objectpool_slab_t *next;
+
+    while (slab)
+    {
+        next = slab->next;
+        free(slab->raw);
+        slab = next;
+    }
+
+    objectpool_init(pool, pool->block_size);
+
+}
+
+// makes sure the next count single-block allocations are served without touching the heap
+void objectpool_reserve(objectpool_t *pool, uint32_t count)
+{
+
+    uint32_t available = (uint32_t)((pool->bump_end - pool->bump) / pool->block_size);
+    void *block;
+
+    for (block = pool->free_list; block && available < count; block = *(void **)block)
+    {
+        available++;
+    }
+
+    if (available < count)
+    {
+        objectpool_retire_bump(pool);
+        objectpool_new_slab(pool, count - available);
+    }
+
+}
+
+// hands out one block, reusing freed blocks first
+void* objectpool_alloc(objectpool_t *pool)
+{
+
+    void *block = pool->free_list;
+
+    if (block)
+    {
+        pool->free_list = *(void **)block;
+    }
+    else
+    {
+        if (pool->bump == pool->bump_end)
+        {
+            objectpool_new_slab(pool, OBJECTPOOL_SLAB_BLOCKS);
+        }
+
+        block = pool->bump;
+        pool->bump += pool->block_size;
+    }
+
+    pool->live++;
+
+    return block;
+
+}
+
+// hands out count blocks laid out back to back, so they can be walked as an array
+void* objectpool_alloc_many(objectpool_t *pool, uint32_t count)
+{
+
+    void *blocks;
+
+    if (count == 0)
+    {
+        return NULL;
+    }
+
+    if ((size_t)(pool->bump_end - pool->bump) < (size_t)count * pool->block_size)
+    {
+        objectpool_retire_bump(pool);
+        objectpool_new_slab(pool, count > OBJECTPOOL_SLAB_BLOCKS ? count : OBJECTPOOL_SLAB_BLOCKS);
+    }
+
+    blocks = pool->bump;
+    pool->bump += (size_t)count * pool->block_size;
+    pool->live += count;
+
+    return blocks;
+
+}
+
+// returns one block to the pool
+void objectpool_free(objectpool_t *pool, void *block)
+{
+
+    if (!block)
+    {
+        return;
+    }
+
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->live--;
+
+}
+
+// returns a run of count blocks from objectpool_alloc_many to the pool
+void objectpool_free_many(objectpool_t *pool, void *blocks, uint32_t count)
+{
+
+    uint8_t *block = blocks;
+
+    // pushed back to front so the run is handed out again in address order
+    for (uint32_t i = count; i > 0; i--)
+    {
+        objectpool_free(pool, block + (size_t)(i - 1) * pool->block_size);
+    }
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// allocates a cache-line-aligned slab with room for blocks blocks and makes it the bump region
+static void objectpool_new_slab(objectpool_t *pool, uint32_t blocks)
+{
+
+    size_t bytes = (size_t)blocks * pool->block_size;
+    uint8_t *raw = malloc(sizeof(objectpool_slab_t) + OBJECTPOOL_CACHE_LINE + bytes);
+    uint8_t *data;
+    objectpool_slab_t *slab;
+
+    if (!raw)
+    {
+        printf("objectpool: out of memory allocating %u blocks\n", blocks);
+        exit(1);
+    }
+
+    data = (uint8_t *)(((uintptr_t)raw + sizeof(objectpool_slab_t) + OBJECTPOOL_CACHE_LINE - 1) & ~(uintptr_t)(OBJECTPOOL_CACHE_LINE - 1));
+
+    slab = (objectpool_slab_t *)(data - sizeof(objectpool_slab_t));
+    slab->raw  = raw;
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+
+    pool->bump     = data;
+    pool->bump_end = data + bytes;
+
+}
+
+// moves whatever is left of the current bump region onto the free list so it isn't stranded
+static void objectpool_retire_bump(objectpool_t *pool)
+{
+
+    while (pool->bump_end - pool->bump >= (ptrdiff_t)pool->block_size)
+    {
+        pool->bump_end -= pool->block_size;
+        *(void **)pool->bump_end = pool->free_list;
+        pool->free_list = pool->bump_end;
+    }
+
+    pool->bump = pool->bump_end = NULL;
+
+}
@@ -0,0 +1,249 @@
+/*
+ *  pairmap.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+
+#include "../inc/common.h"
+#include "../inc/pairmap.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+static void pairmap_allocate(pairmap_t *map, uint32_t capacity);
+static void pairmap_grow(pairmap_t *map);
+static uint32_t pairmap_home(const pairmap_t *map, uint64_t key);
+
+/* ---------------------------------------------------------------------------------------- */
+
+// sets up an empty map sized to hold at least capacity entries without growing
+void pairmap_init(pairmap_t *map, size_t value_size, uint32_t capacity)
+{
+
+    uint32_t slots = PAIRMAP_MIN_CAPACITY;
+
+    memset(map, 0, sizeof(pairmap_t));
+    map->value_size = value_size;
+
+    while (slots / 2 < capacity) slots <<= 1;
+
+    pairmap_allocate(map, slots);
+
+}
+
+void pairmap_destroy(pairmap_t *map)
+{
+
+    free(map->keys);
+    free(map->values);
+
+    memset(map, 0, sizeof(pairmap_t));
+
+}
+
+// removes every entry, keeping the table
+void pairmap_clear(pairmap_t *map)
+{
+
+    memset(map->keys, 0xFF, map->capacity * sizeof(uint64_t));
+    map->count = 0;
+
+}
+
+// value stored under key, or NULL if the key isn't in the map
+void* pairmap_find(const pairmap_t *map, uint64_t key)
+{
+
+    uint32_t mask = map->capacity - 1;
+    uint32_t i;
+
+    for (i = pairmap_home(map, key); map->keys[i] != PAIRMAP_EMPTY; i = (i + 1) & mask)
+    {
+        if (map->keys[i] == key)
+        {
+            return pairmap_value_at(map, i);
+        }
+    }
+
+    return NULL;
+
+}
+
+// value stored under key, adding a zeroed one if the key is new. Pointers are invalidated by any insert or remove
+void* pairmap_insert(pairmap_t *map, uint64_t key, bool *inserted)
+{
+
+    uint32_t mask;
+    uint32_t i;
+    void *value;
+
+    // keep the load factor at or below one half
+    if ((map->count + 1) * 2 > map->capacity)
+    {
+        pairmap_grow(map);
+    }
+
+    mask = map->capacity - 1;
+
+    for (i = pairmap_home(map, key); map->keys[i] != PAIRMAP_EMPTY; i = (i + 1) & mask)
+    {
+        if (map->keys[i] == key)
+        {
+            if (inserted) *inserted = false;
+            return pairmap_value_at(map, i);
+        }
+    }
+
+    map->keys[i] = key;
+    map->count++;
+
+    value = pairmap_value_at(map, i);
+    memset(value, 0, map->value_size);
+
+    if (inserted) *inserted = true;
+
+    return value;
+
+}
+
+// removes key from the map, returns false if it wasn't there
+bool pairmap_remove(pairmap_t *map, uint64_t key)
+{
+
+    uint32_t mask = map->capacity - 1;
+    uint32_t i;
+
+    for (i = pairmap_home(map, key); map->keys[i] != PAIRMAP_EMPTY; i = (i + 1) & mask)
+    {
+        if (map->keys[i] == key)
+        {
+            pairmap_remove_at(map, i);
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+// empties table slot index and shifts the rest of its probe run back. Returns true if another entry
+// was moved into index. Use pairmap_retain to remove entries while walking the table
+bool pairmap_remove_at(pairmap_t *map, uint32_t index)
+{
+
+    uint32_t mask = map->capacity - 1;
+    uint32_t hole = index;
+    uint32_t i, home;
+    bool refilled = false;
+
+    for (i = (hole + 1) & mask; map->keys[i] != PAIRMAP_EMPTY; i = (i + 1) & mask)
+    {
+
+        home = pairmap_home(map, map->keys[i]);
+
+        // the entry at i can fill the hole only if its home isn't cyclically inside (hole, i]
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+
+            map->keys[hole] = map->keys[i];
+            memcpy(pairmap_value_at(map, hole), pairmap_value_at(map, i), map->value_size);
+
+            refilled |= (hole == index);
+            hole = i;
+
+        }
+
+    }
+
+    map->keys[hole] = PAIRMAP_EMPTY;
+    map->count--;
+
+    return refilled;
+
+}
+
+// calls keep on every entry exactly once, removing the entries it returns false for
+void pairmap_retain(pairmap_t *map, pairmap_filter_t keep, void *context)
+{
+
+    uint32_t mask = map->capacity - 1;
+    uint32_t start, k;
+
+    // start from an empty slot so no probe run wraps past the start and gets shifted back over it
+    for (start = 0; map->keys[start] != PAIRMAP_EMPTY; start++);
+
+    k = start;
+
+    do
+    {
+
+        k = (k + 1) & mask;
+
+        while (map->keys[k] != PAIRMAP_EMPTY && !keep(map->keys[k], pairmap_value_at(map, k), context))
+        {
+            if (!pairmap_remove_at(map, k)) break;
+        }
+
+    } while (k != start);
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+static void pairmap_allocate(pairmap_t *map, uint32_t capacity)
+{
+
+    map->capacity = capacity;
+    map->shift    = 64;
+
+    while (capacity > 1)
+    {
+        capacity >>= 1;
+        map->shift--;
+    }
+
+    map->keys   = malloc(map->capacity * sizeof(uint64_t));
+    map->values = malloc(map->capacity * map->value_size);
+
+    memset(map->keys, 0xFF, map->capacity * sizeof(uint64_t));
+
+}
+
+// doubles the table and re-inserts every entry
+static void pairmap_grow(pairmap_t *map)
+{
+
+    uint64_t *old_keys   = map->keys;
+    uint8_t  *old_values = map->values;
+    uint32_t old_capacity = map->capacity;
+    uint32_t mask, i, j;
+
+    pairmap_allocate(map, old_capacity * 2);
+    mask = map->capacity - 1;
+
+    for (i = 0; i < old_capacity; i++)
+    {
+
+        if (old_keys[i] == PAIRMAP_EMPTY) continue;
+
+        for (j = pairmap_home(map, old_keys[i]); map->keys[j] != PAIRMAP_EMPTY; j = (j + 1) & mask);
+
+        map->keys[j] = old_keys[i];
+        memcpy(pairmap_value_at(map, j), old_values + (size_t)i * map->value_size, map->value_size);
+
+    }
+
+    free(old_keys);
+    free(old_values);
+
+}
+
+// fibonacci hash of the key into the table
+static uint32_t pairmap_home(const pairmap_t *map, uint64_t key)
+{
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> map->shift);
+}
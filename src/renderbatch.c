@@ -0,0 +1,189 @@
+/*
+ *  renderbatch.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <math.h>
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/renderbatch.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+static void renderbatch_reserve(renderbatch_t *batch, uint32_t vertices, uint32_t indices);
+
+/* ---------------------------------------------------------------------------------------- */
+
+void renderbatch_init(renderbatch_t *batch)
+{
+
+    uint32_t n, k, total = 0;
+    float angle;
+
+    memset(batch, 0, sizeof(renderbatch_t));
+
+    for (n = RENDERBATCH_MIN_SEGMENTS; n <= RENDERBATCH_MAX_SEGMENTS; n++)
+    {
+        batch->unit_start[n] = total;
+        total += n;
+    }
+
+    batch->unit_x = malloc(total * sizeof(float));
+    batch->unit_y = malloc(total * sizeof(float));
+
+    for (n = RENDERBATCH_MIN_SEGMENTS; n <= RENDERBATCH_MAX_SEGMENTS; n++)
+    {
+        for (k = 0; k < n; k++)
+        {
+            angle = 2.0f * (float)M_PI * k / n;
+            batch->unit_x[batch->unit_start[n] + k] = cosf(angle);
+            batch->unit_y[batch->unit_start[n] + k] = sinf(angle);
+        }
+    }
+
+}
+
+void renderbatch_destroy(renderbatch_t *batch)
+{
+
+    free(batch->vertices);
+    free(batch->indices);
+    free(batch->unit_x);
+    free(batch->unit_y);
+
+    memset(batch, 0, sizeof(renderbatch_t));
+
+}
+
+// empties the batch for the next frame, keeping its buffers
+void renderbatch_clear(renderbatch_t *batch)
+{
+    batch->vertex_count = 0;
+    batch->index_count  = 0;
+}
+
+// adds a filled ellipse centered on (x, y) in window coordinates, color is packed 0xRRGGBBAA
+void renderbatch_add_ellipse(renderbatch_t *batch, float x, float y, float rx, float ry, uint32_t color)
+{
+
+    const uint32_t n = renderbatch_segments(SDL_max(rx, ry));
+    const float *unit_x = &batch->unit_x[batch->unit_start[n]];
+    const float *unit_y = &batch->unit_y[batch->unit_start[n]];
+    const SDL_Color c = { color >> 24, (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF };
+    const int center = (int)batch->vertex_count;
+    SDL_Vertex *v;
+    int *t;
+
+    renderbatch_reserve(batch, n + 1, 3 * n);
+
+    v = &batch->vertices[batch->vertex_count];
+    t = &batch->indices[batch->index_count];
+
+    v[0] = (SDL_Vertex){ { x, y }, c, { 0.0f, 0.0f } };
+
+    for (uint32_t k = 0; k < n; k++)
+    {
+
+        v[k + 1] = (SDL_Vertex){ { x + rx * unit_x[k], y + ry * unit_y[k] }, c, { 0.0f, 0.0f } };
+
+        // the last triangle closes the fan back onto the first outline point
+        t[3 * k + 0] = center;
+        t[3 * k + 1] = center + 1 + (int)k;
+        t[3 * k + 2] = center + 1 + (int)((k + 1) % n);
+
+    }
+
+    batch->vertex_count += n + 1;
+    batch->index_count  += 3 * n;
+
+}
+
+// adds a rectangle in window coordinates showing the given part of the texture, tinted by the
+// color, packed 0xRRGGBBAA
+void renderbatch_add_quad(renderbatch_t *batch, const SDL_FRect *rect, const SDL_FRect *uv, uint32_t color)
+{
+
+    const SDL_Color c = { color >> 24, (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF };
+    const int first = (int)batch->vertex_count;
+    SDL_Vertex *v;
+    int *t;
+
+    renderbatch_reserve(batch, 4, 6);
+
+    v = &batch->vertices[batch->vertex_count];
+    t = &batch->indices[batch->index_count];
+
+    v[0] = (SDL_Vertex){ { rect->x,           rect->y           }, c, { uv->x,         uv->y         } };
+    v[1] = (SDL_Vertex){ { rect->x + rect->w, rect->y           }, c, { uv->x + uv->w, uv->y         } };
+    v[2] = (SDL_Vertex){ { rect->x + rect->w, rect->y + rect->h }, c, { uv->x + uv->w, uv->y + uv->h } };
+    v[3] = (SDL_Vertex){ { rect->x,           rect->y + rect->h }, c, { uv->x,         uv->y + uv->h } };
+
+    t[0] = first;
+    t[1] = first + 1;
+    t[2] = first + 2;
+    t[3] = first;
+    t[4] = first + 2;
+    t[5] = first + 3;
+
+    batch->vertex_count += 4;
+    batch->index_count  += 6;
+
+}
+
+// draws everything in the batch with a single SDL_RenderGeometry call, returns what it returns.
+// The texture is NULL for a batch of ellipses
+int renderbatch_submit(renderbatch_t *batch, SDL_Renderer *renderer, SDL_Texture *texture)
+{
+
+    if (batch->index_count == 0)
+    {
+        return 0;
+    }
+
+    return SDL_RenderGeometry(renderer, texture, batch->vertices, (int)batch->vertex_count, batch->indices, (int)batch->index_count);
+
+}
+
+// segments an outline of the given radius needs to stay within the tolerance. An edge spanning
+// angle a strays r * (1 - cos(a / 2)) from the curve
+uint32_t renderbatch_segments(float radius)
+{
+
+    float segments;
+
+    if (radius <= RENDERBATCH_TOLERANCE)
+    {
+        return RENDERBATCH_MIN_SEGMENTS;
+    }
+
+    segments = ceilf((float)M_PI / acosf(1.0f - RENDERBATCH_TOLERANCE / radius));
+
+    return (uint32_t)SDL_clamp(segments, (float)RENDERBATCH_MIN_SEGMENTS, (float)RENDERBATCH_MAX_SEGMENTS);
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// makes room for this many more vertices and indices
+static void renderbatch_reserve(renderbatch_t *batch, uint32_t vertices, uint32_t indices)
+{
+
+    if (batch->vertex_count + vertices > batch->vertex_capacity)
+    {
+        batch->vertex_capacity = SDL_max(batch->vertex_count + vertices, SDL_max(batch->vertex_capacity * 2, RENDERBATCH_MIN_VERTICES));
+        batch->vertices        = realloc(batch->vertices, batch->vertex_capacity * sizeof(SDL_Vertex));
+    }
+
+    if (batch->index_count + indices > batch->index_capacity)
+    {
+        batch->index_capacity = SDL_max(batch->index_count + indices, SDL_max(batch->index_capacity * 2, 3 * RENDERBATCH_MIN_VERTICES));
+        batch->indices        = realloc(batch->indices, batch->index_capacity * sizeof(int));
+    }
+
+}
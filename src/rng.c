@@ -0,0 +1,54 @@
+/*
+ *  rng.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include "../inc/common.h"
+#include "../inc/rng.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+static uint64_t rng_mix(uint64_t z);
+
+/* ---------------------------------------------------------------------------------------- */
+
+void rng_init(rng_t *rng, uint64_t seed, uint64_t stream)
+{
+    rng->seed    = seed;
+    rng->stream  = stream;
+    rng->counter = 0;
+}
+
+// the counter-th number of a stream
+uint64_t rng_at(uint64_t seed, uint64_t stream, uint64_t counter)
+{
+    return rng_mix(rng_mix(seed ^ (stream * 0xD1B54A32D192ED03ull)) + counter * 0x9E3779B97F4A7C15ull);
+}
+
+uint32_t rng_next(rng_t *rng)
+{
+    return (uint32_t)(rng_at(rng->seed, rng->stream, rng->counter++) >> 32);
+}
+
+// a number in [0, bound), scaled rather than taken modulo so the low bits don't decide it
+uint32_t rng_below(rng_t *rng, uint32_t bound)
+{
+    return (uint32_t)(((uint64_t)rng_next(rng) * bound) >> 32);
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// splitmix64's finalizer, every input bit reaches every output bit
+static uint64_t rng_mix(uint64_t z)
+{
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return z ^ (z >> 31);
+
+}
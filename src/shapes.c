@@ -13,31 +13,26 @@
 #include "../inc/simulation.h"
 #include "../inc/shapes.h"
 
-uint8_t shapes_render_circle(simulation_t *sim, simobject_t *obj)
+uint8_t shapes_render_circle(simulation_t *sim, float x_pos, float y_pos, float width, float height, uint32_t color)
 {
 
     // retrieve the x and y origins in window space
     float window_x_origin = sim->properties->border.x + (sim->properties->border.w / 2.0f);
     float window_y_origin = sim->properties->border.y + (sim->properties->border.h / 2.0f);
 
-    // convert object's x-y coordinates to window coordinates
-    float window_x_pos = window_x_origin + obj->x_pos;
-    float window_y_pos = window_y_origin + obj->y_pos;
-
-    // create rectangle from the object's current state
-    SDL_FRect rect = { window_x_pos, window_y_pos, obj->height, obj->width };
-
-    // create the object color word
-    uint32_t obj_color = ((obj->color_r << 24) | (obj->color_g << 16) | (obj->color_b << 8) | 0xFF);
+    // the body's circle, see bodystore_radius, in window coordinates
+    float window_x_pos = window_x_origin + bodystore_center(x_pos, width);
+    float window_y_pos = window_y_origin + bodystore_center(y_pos, width);
+    float radius       = bodystore_radius(width);
 
     return filledEllipseColor
     (
         sim->sdl->renderer, 
-        rect.x,
-        rect.y,
-        rect.w/1.25,
-        rect.h/1.25,
-        obj_color
+        window_x_pos,
+        window_y_pos,
+        radius,
+        radius,
+        color
     );
 
 }
\ No newline at end of file
@@ -8,19 +8,58 @@
 /* ---------------------------------------------------------------------------------------- */
 
 #include <stdio.h>
+#include <string.h>
 #include <float.h>
 #include <math.h>
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define SIMOBJECT_X86_SIMD 1
+#else
+#define SIMOBJECT_X86_SIMD 0
+#endif
+
 #include "../inc/common.h"
 #include "../inc/simulation.h"
 #include "../inc/simobject.h"
+#include "../inc/bodystore.h"
+#include "../inc/objectpool.h"
+#include "../inc/rng.h"
 
 /* ---------------------------------------------------------------------------------------- */
 
-static void simobject_update_acceleration(simobject_t *obj, fieldproperties_t props);
-static void simobject_update_velocity(simobject_t *obj, fieldproperties_t props);
-static void simobject_update_momentum(simobject_t *obj, fieldproperties_t props);
-static void simobject_update_position(simobject_t *obj, fieldproperties_t props);
+static simobject_t* simobject_pool_alloc(uint32_t count);
+static void simobject_init
+(
+    simobject_t *obj,
+    float mass, float x_pos, float y_pos, float x_vel, float y_vel, float x_acc, float y_acc,
+    float intr_x_vel, float intr_y_vel, float intr_x_acc, float intr_y_acc
+);
+
+static void simobject_update_acceleration(bodystore_t *bodies, uint32_t i, const fieldproperties_t *props);
+static void simobject_update_velocity(bodystore_t *bodies, uint32_t i, const fieldproperties_t *props);
+static void simobject_update_momentum(bodystore_t *bodies, uint32_t i, const fieldproperties_t *props);
+static void simobject_update_position(bodystore_t *bodies, uint32_t i, const fieldproperties_t *props);
+
+// batch integrators advance [begin, end) and return where they stopped, the scalar path finishes the tail
+typedef uint32_t (*simobject_integrator_t)(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props);
+
+static simobject_integrator_t simobject_select_integrator(void);
+static float simobject_check_value(rng_t *rng);
+static bool simobject_check_equal(const float *a, const float *b, uint32_t count);
+static uint32_t simobject_integrate_none(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props);
+
+#if (SIMOBJECT_X86_SIMD)
+static uint32_t simobject_integrate_sse2(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props);
+static uint32_t simobject_integrate_avx2(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props);
+static uint32_t simobject_integrate_avx512(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props);
+#endif
+
+static objectpool_t simobject_pool;                             // every simobject_t is carved out of this pool
+static rng_t simobject_colors;                                  // stream new objects draw their colors from
+
+static simobject_integrator_t simobject_integrator;
+static const char *simobject_integrator_label = "scalar";
 
 /* ---------------------------------------------------------------------------------------- */
 
@@ -33,163 +72,581 @@ simobject_t * createObject
 )
 {
 
-    simobject_t *obj = malloc(sizeof(simobject_t));
+    simobject_t *obj = simobject_pool_alloc(1);
 
-    obj->mass = mass;
+    simobject_init(obj, mass, x_pos, y_pos, x_vel, y_vel, x_acc, y_acc, intr_x_vel, intr_y_vel, intr_x_acc, intr_y_acc);
 
-    obj->width = mass * 0.5f;
-    obj->height = mass * 0.5f;
+    return obj;
 
-    obj->x_pos = x_pos;
-    obj->y_pos = y_pos;
-    obj->x_vel = x_vel;
-    obj->y_vel = y_vel;
-    obj->x_acc = x_acc;
-    obj->y_acc = y_acc;
+}
 
-    obj->intr_x_vel = intr_x_vel;
-    obj->intr_y_vel = intr_y_vel;
-    obj->intr_x_acc = intr_x_acc;
-    obj->intr_y_acc = intr_y_acc;
+// creates count objects back to back in one pool run, each starting from the same state
+simobject_t * createObjects
+(
+    uint32_t count,
+    float mass, float x_pos, float y_pos, float x_vel, float y_vel, float x_acc, float y_acc,
+    float intr_x_vel, float intr_y_vel, float intr_x_acc, float intr_y_acc
+)
+{
 
-    obj->color_r = rand() % 150 + 50;
-    obj->color_g = rand() % 150 + 50;
-    obj->color_b = rand() % 150 + 50;
+    simobject_t *objs = simobject_pool_alloc(count);
 
-    return obj;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        simobject_init(&objs[i], mass, x_pos, y_pos, x_vel, y_vel, x_acc, y_acc, intr_x_vel, intr_y_vel, intr_x_acc, intr_y_acc);
+    }
+
+    return objs;
 
 }
 
 void destroyObject(simobject_t *obj)
 {
-    free(obj);
+    objectpool_free(&simobject_pool, obj);
+}
+
+// releases a run returned by createObjects
+void destroyObjects(simobject_t *objs, uint32_t count)
+{
+    objectpool_free_many(&simobject_pool, objs, count);
 }
 
-void simobject_update_state(simobject_t *obj, fieldproperties_t props)
+// sets an object's mass along with the extents that are derived from it
+void simobject_set_mass(simobject_t *obj, float mass)
 {
 
-    simobject_update_acceleration(obj, props);
-    simobject_update_velocity(obj, props);
-    simobject_update_momentum(obj, props);
-    simobject_update_position(obj, props);
+    obj->mass = mass;
+
+    obj->width = mass * 0.5f;
+    obj->height = mass * 0.5f;
 
 }
 
-// note: referenced from object 1's perspective
-void simobject_collision(simobject_t *obj1, simobject_t *obj2, uint8_t collision_type, fieldproperties_t props)
+// restarts the color stream from seed, objects created afterwards get the same colors every run
+void simobject_seed(uint64_t seed)
 {
+    rng_init(&simobject_colors, seed, RNG_STREAM_COLOR);
+}
 
-    #if (SIMULATION_PERFECTLY_ELASTIC)
+// pre-sizes the object pool so the next count createObject calls don't touch the heap
+void simobject_pool_reserve(uint32_t count)
+{
+
+    if (!simobject_pool.block_size)
     {
+        objectpool_init(&simobject_pool, sizeof(simobject_t));
+    }
 
-        // right/left collision
-        if (collision_type & 0x01 || collision_type & 0x02)
-        {
-            obj1->x_vel -= obj1->x_vel*2;
-            obj2->x_vel -= obj1->x_vel*2;
+    objectpool_reserve(&simobject_pool, count);
 
-            printf("right/left!!\n");
+}
 
-            return;
+// frees every slab the object pool owns, all outstanding objects become invalid
+void simobject_pool_release(void)
+{
 
-        }
+    if (simobject_pool.live)
+    {
+        printf("simobject pool released with %u live objects\n", simobject_pool.live);
+    }
 
-        // top/bottom collision
-        if (collision_type & 0x04 || collision_type & 0x08)
-        {
-            printf("top/bottom!\n");
-            obj1->y_vel -= obj1->y_vel*2;
-            obj2->y_vel -= obj2->y_vel*2;
-        }
+    objectpool_destroy(&simobject_pool);
+
+}
 
+// advances every awake body in the store by one timestep, sleeping bodies stay put
+void simobject_update_states(bodystore_t *bodies, const fieldproperties_t *props)
+{
+    simobject_update_states_range(bodies, 0, bodies->awake_count, props);
+}
+
+// advances bodies [begin, end) using the widest batch integrator the CPU supports
+void simobject_update_states_range(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props)
+{
+
+    if (!simobject_integrator)
+    {
+        simobject_integrator = simobject_select_integrator();
     }
-    #else
+
+    begin = simobject_integrator(bodies, begin, end, props);
+
+    simobject_update_states_scalar(bodies, begin, end, props);
+
+}
+
+// reference integrator, the batch integrators must match it bit for bit
+void simobject_update_states_scalar(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props)
+{
+
+    for (uint32_t i = begin; i < end; i++)
     {
+        simobject_update_acceleration(bodies, i, props);
+        simobject_update_velocity(bodies, i, props);
+        simobject_update_momentum(bodies, i, props);
+        simobject_update_position(bodies, i, props);
+    }
 
+}
+
+// name of the integrator simobject_update_states dispatches to
+const char* simobject_integrator_name(void)
+{
+
+    if (!simobject_integrator)
+    {
+        simobject_integrator = simobject_select_integrator();
     }
-    #endif
+
+    return simobject_integrator_label;
+
+}
+
+// runs the batch integrator and the scalar reference over the same bodies, limits, NaNs and
+// infinities included, and returns whether every value they write came out bit for bit the same
+bool simobject_check_integrator(const fieldproperties_t *props)
+{
+
+    bodystore_t batch, scalar;
+    rng_t rng;
+    bool equal;
+
+    bodystore_init(&batch, SIMOBJECT_CHECK_BODIES);
+    bodystore_init(&scalar, SIMOBJECT_CHECK_BODIES);
+    rng_init(&rng, 0, RNG_STREAM_CHECK);
+
+    batch.count = batch.awake_count = SIMOBJECT_CHECK_BODIES;
+
+    for (uint32_t i = 0; i < SIMOBJECT_CHECK_BODIES; i++)
+    {
+        batch.x_pos[i]      = simobject_check_value(&rng);
+        batch.y_pos[i]      = simobject_check_value(&rng);
+        batch.x_vel[i]      = simobject_check_value(&rng);
+        batch.y_vel[i]      = simobject_check_value(&rng);
+        batch.x_acc[i]      = simobject_check_value(&rng);
+        batch.y_acc[i]      = simobject_check_value(&rng);
+        batch.intr_x_acc[i] = simobject_check_value(&rng);
+        batch.intr_y_acc[i] = simobject_check_value(&rng);
+        batch.ext_x_acc[i]  = simobject_check_value(&rng);
+        batch.ext_y_acc[i]  = simobject_check_value(&rng);
+        batch.mass[i]       = simobject_check_value(&rng);
+    }
+
+    scalar.count = scalar.awake_count = SIMOBJECT_CHECK_BODIES;
+
+    memcpy(scalar.x_pos,      batch.x_pos,      SIMOBJECT_CHECK_BODIES * sizeof(float));
+    memcpy(scalar.y_pos,      batch.y_pos,      SIMOBJECT_CHECK_BODIES * sizeof(float));
+    memcpy(scalar.x_vel,      batch.x_vel,      SIMOBJECT_CHECK_BODIES * sizeof(float));
+    memcpy(scalar.y_vel,      batch.y_vel,      SIMOBJECT_CHECK_BODIES * sizeof(float));
+    memcpy(scalar.x_acc,      batch.x_acc,      SIMOBJECT_CHECK_BODIES * sizeof(float));
+    memcpy(scalar.y_acc,      batch.y_acc,      SIMOBJECT_CHECK_BODIES * sizeof(float));
+    memcpy(scalar.intr_x_acc, batch.intr_x_acc, SIMOBJECT_CHECK_BODIES * sizeof(float));
+    memcpy(scalar.intr_y_acc, batch.intr_y_acc, SIMOBJECT_CHECK_BODIES * sizeof(float));
+    memcpy(scalar.ext_x_acc,  batch.ext_x_acc,  SIMOBJECT_CHECK_BODIES * sizeof(float));
+    memcpy(scalar.ext_y_acc,  batch.ext_y_acc,  SIMOBJECT_CHECK_BODIES * sizeof(float));
+    memcpy(scalar.mass,       batch.mass,       SIMOBJECT_CHECK_BODIES * sizeof(float));
+
+    simobject_update_states(&batch, props);
+    simobject_update_states_scalar(&scalar, 0, SIMOBJECT_CHECK_BODIES, props);
+
+    equal = simobject_check_equal(batch.x_pos,    scalar.x_pos,    SIMOBJECT_CHECK_BODIES) &&
+            simobject_check_equal(batch.y_pos,    scalar.y_pos,    SIMOBJECT_CHECK_BODIES) &&
+            simobject_check_equal(batch.x_vel,    scalar.x_vel,    SIMOBJECT_CHECK_BODIES) &&
+            simobject_check_equal(batch.y_vel,    scalar.y_vel,    SIMOBJECT_CHECK_BODIES) &&
+            simobject_check_equal(batch.x_acc,    scalar.x_acc,    SIMOBJECT_CHECK_BODIES) &&
+            simobject_check_equal(batch.y_acc,    scalar.y_acc,    SIMOBJECT_CHECK_BODIES) &&
+            simobject_check_equal(batch.momentum, scalar.momentum, SIMOBJECT_CHECK_BODIES);
+
+    bodystore_destroy(&batch);
+    bodystore_destroy(&scalar);
+
+    return equal;
 
 }
 
 /* ---------------------------------------------------------------------------------------- */
 
-static void simobject_update_acceleration(simobject_t *obj, fieldproperties_t props)
+// takes count consecutive objects from the pool, setting the pool up on first use
+static simobject_t* simobject_pool_alloc(uint32_t count)
+{
+
+    if (!simobject_pool.block_size)
+    {
+        objectpool_init(&simobject_pool, sizeof(simobject_t));
+    }
+
+    return count == 1 ? objectpool_alloc(&simobject_pool) : objectpool_alloc_many(&simobject_pool, count);
+
+}
+
+static void simobject_init
+(
+    simobject_t *obj,
+    float mass, float x_pos, float y_pos, float x_vel, float y_vel, float x_acc, float y_acc,
+    float intr_x_vel, float intr_y_vel, float intr_x_acc, float intr_y_acc
+)
+{
+
+    simobject_set_mass(obj, mass);
+
+    obj->x_pos = x_pos;
+    obj->y_pos = y_pos;
+    obj->x_vel = x_vel;
+    obj->y_vel = y_vel;
+    obj->x_acc = x_acc;
+    obj->y_acc = y_acc;
+
+    obj->intr_x_vel = intr_x_vel;
+    obj->intr_y_vel = intr_y_vel;
+    obj->intr_x_acc = intr_x_acc;
+    obj->intr_y_acc = intr_y_acc;
+
+    obj->momentum = 0.0f;
+
+    obj->friction    = SIMULATION_FRICTION;
+    obj->restitution = SIMULATION_PERFECTLY_ELASTIC ? 1.0f : SIMULATION_RESTITUTION;
+
+    obj->color_r = rng_below(&simobject_colors, 150) + 50;
+    obj->color_g = rng_below(&simobject_colors, 150) + 50;
+    obj->color_b = rng_below(&simobject_colors, 150) + 50;
+
+}
+
+static void simobject_update_acceleration(bodystore_t *bodies, uint32_t i, const fieldproperties_t *props)
 {
 
     #if (SIMULATION_CONSTANT_ACCELERATION)
     {
-        obj->x_acc = props.xacc_constant;
-        obj->y_acc = props.yacc_constant;
+        bodies->x_acc[i] = props->xacc_constant;
+        bodies->y_acc[i] = props->yacc_constant;
     }
     #endif
 
     // bounding
-    if (obj->x_vel >  props.max_x_acc) obj->x_vel =  props.max_x_acc;
-    if (obj->x_vel < -props.max_x_acc) obj->x_vel = -props.max_x_acc;
-    if (obj->y_vel >  props.max_y_acc) obj->y_vel =  props.max_y_acc;
-    if (obj->y_vel < -props.max_y_acc) obj->y_vel = -props.max_y_acc;
+    if (bodies->x_vel[i] >  props->max_x_acc) bodies->x_vel[i] =  props->max_x_acc;
+    if (bodies->x_vel[i] < -props->max_x_acc) bodies->x_vel[i] = -props->max_x_acc;
+    if (bodies->y_vel[i] >  props->max_y_acc) bodies->y_vel[i] =  props->max_y_acc;
+    if (bodies->y_vel[i] < -props->max_y_acc) bodies->y_vel[i] = -props->max_y_acc;
 
 }
 
-static void simobject_update_velocity(simobject_t *obj, fieldproperties_t props)
+static void simobject_update_velocity(bodystore_t *bodies, uint32_t i, const fieldproperties_t *props)
 {
 
-    float dt = props.timestep;
+    float dt = props->timestep;
 
     #if (SIMULATION_CONSTANT_ACCELERATION)
     {
         // dv = int(adt) ... a == constant so... dv = at
-        obj->x_vel += props.xvel_constant + (obj->x_acc * dt) + (obj->intr_x_acc * dt);
-        obj->y_vel += props.yvel_constant + (obj->y_acc * dt) + (obj->intr_y_acc * dt);
+        bodies->x_vel[i] += props->xvel_constant + (bodies->x_acc[i] * dt) + (bodies->intr_x_acc[i] * dt) + (bodies->ext_x_acc[i] * dt);
+        bodies->y_vel[i] += props->yvel_constant + (bodies->y_acc[i] * dt) + (bodies->intr_y_acc[i] * dt) + (bodies->ext_y_acc[i] * dt);
     }
     #endif
 
     // bounding
-    if (obj->x_vel >  props.max_x_vel) obj->x_vel =  props.max_x_vel;
-    if (obj->x_vel < -props.max_x_vel) obj->x_vel = -props.max_x_vel;
-    if (obj->y_vel >  props.max_y_vel) obj->y_vel =  props.max_y_vel;
-    if (obj->y_vel < -props.max_y_vel) obj->y_vel = -props.max_y_vel;
+    if (bodies->x_vel[i] >  props->max_x_vel) bodies->x_vel[i] =  props->max_x_vel;
+    if (bodies->x_vel[i] < -props->max_x_vel) bodies->x_vel[i] = -props->max_x_vel;
+    if (bodies->y_vel[i] >  props->max_y_vel) bodies->y_vel[i] =  props->max_y_vel;
+    if (bodies->y_vel[i] < -props->max_y_vel) bodies->y_vel[i] = -props->max_y_vel;
 
 }
 
-static void simobject_update_momentum(simobject_t *obj, fieldproperties_t props)
+static void simobject_update_momentum(bodystore_t *bodies, uint32_t i, const fieldproperties_t *props)
 {
 
-    float dt = props.timestep;
-    float px, py;
-
     #if (SIMULATION_CONSTANT_ACCELERATION)
     {
         // p = m||v||
+        float vx = bodies->x_vel[i];
+        float vy = bodies->y_vel[i];
 
-        //px = (obj->mass * obj->x_vel);
-        //py = (obj->mass * obj->y_vel);
-
-        obj->momentum = obj->mass * sqrt( (obj->x_vel * obj->x_vel) + (obj->y_vel * obj->y_vel) );
-
-        
+        bodies->momentum[i] = bodies->mass[i] * sqrtf( (vx * vx) + (vy * vy) );
     }
     #endif
 
 }
 
-static void simobject_update_position(simobject_t *obj, fieldproperties_t props)
+static void simobject_update_position(bodystore_t *bodies, uint32_t i, const fieldproperties_t *props)
 {
 
-    float dt = props.timestep;
+    float dt = props->timestep;
 
     #if (SIMULATION_CONSTANT_ACCELERATION)
     {
         // dx = int(vdt)
-        obj->x_pos += (obj->x_vel * dt) + ( 0.5f * (obj->x_acc * dt) );
-        obj->y_pos += (obj->y_vel * dt) + ( 0.5f * (obj->y_acc * dt) );
+        bodies->x_pos[i] += (bodies->x_vel[i] * dt) + ( 0.5f * (bodies->x_acc[i] * dt) );
+        bodies->y_pos[i] += (bodies->y_vel[i] * dt) + ( 0.5f * (bodies->y_acc[i] * dt) );
     }
     #endif
 
     // bounding
-    if (obj->x_pos >  props.max_x_pos) obj->x_pos =  props.max_x_pos;
-    if (obj->x_pos < -props.max_x_pos) obj->x_pos = -props.max_x_pos;
-    if (obj->y_pos >  props.max_y_pos) obj->y_pos =  props.max_y_pos;
-    if (obj->y_pos < -props.max_y_pos) obj->y_pos = -props.max_y_pos;
+    if (bodies->x_pos[i] >  props->max_x_pos) bodies->x_pos[i] =  props->max_x_pos;
+    if (bodies->x_pos[i] < -props->max_x_pos) bodies->x_pos[i] = -props->max_x_pos;
+    if (bodies->y_pos[i] >  props->max_y_pos) bodies->y_pos[i] =  props->max_y_pos;
+    if (bodies->y_pos[i] < -props->max_y_pos) bodies->y_pos[i] = -props->max_y_pos;
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// an input for the integrator check, mostly ordinary values either side of the limits and now
+// and then one of the values clamps are easiest to get wrong on
+static float simobject_check_value(rng_t *rng)
+{
+
+    static const float special[] =
+    {
+        NAN, -NAN, INFINITY, -INFINITY, 0.0f, -0.0f, FLT_MIN / 4.0f, FLT_MAX, -FLT_MAX,
+        20.0f, -20.0f, 100.0f, -100.0f, 10000.0f, -10000.0f
+    };
+
+    if (rng_below(rng, 4) == 0)
+    {
+        return special[rng_below(rng, sizeof(special) / sizeof(special[0]))];
+    }
+
+    return ((float)rng_below(rng, 2000001) - 1000000.0f) / 64.0f;
+
+}
+
+// whether two arrays hold the same bits, counting any two NaNs as equal since which NaN an
+// operation returns depends on the order the compiler put its operands in
+static bool simobject_check_equal(const float *a, const float *b, uint32_t count)
+{
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (memcmp(&a[i], &b[i], sizeof(float)) && !(isnan(a[i]) && isnan(b[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+// picks the widest batch integrator this CPU can run
+static simobject_integrator_t simobject_select_integrator(void)
+{
+
+    #if (SIMULATION_SIMD_INTEGRATOR && SIMULATION_CONSTANT_ACCELERATION && SIMOBJECT_X86_SIMD)
+    {
+        if (SDL_HasAVX512F())
+        {
+            simobject_integrator_label = "avx512";
+            return simobject_integrate_avx512;
+        }
+
+        if (SDL_HasAVX2())
+        {
+            simobject_integrator_label = "avx2";
+            return simobject_integrate_avx2;
+        }
+
+        if (SDL_HasSSE2())
+        {
+            simobject_integrator_label = "sse2";
+            return simobject_integrate_sse2;
+        }
+    }
+    #endif
+
+    simobject_integrator_label = "scalar";
+    return simobject_integrate_none;
+
+}
 
+// leaves every body to the scalar reference path
+static uint32_t simobject_integrate_none(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props)
+{
+    return begin;
 }
+
+#if (SIMOBJECT_X86_SIMD)
+
+/*
+ *  The batch integrators fuse acceleration, velocity, momentum and position into one pass per
+ *  group of bodies. Every operation mirrors the scalar path in the same order (no FMA, clamps
+ *  as min-then-max) so the results are bit-identical to simobject_update_states_scalar.
+ *
+ *  min(limit, v) is (limit < v) ? limit : v and max(-limit, v) is (-limit > v) ? -limit : v,
+ *  the same comparisons as the scalar ifs, so a NaN fails both and passes through untouched.
+ *  The operands must stay in that order, min(v, limit) would turn a NaN into the limit.
+ */
+
+__attribute__((target("sse2")))
+static uint32_t simobject_integrate_sse2(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props)
+{
+
+    const __m128 dt       = _mm_set1_ps(props->timestep);
+    const __m128 half     = _mm_set1_ps(0.5f);
+    const __m128 x_acc    = _mm_set1_ps(props->xacc_constant);
+    const __m128 y_acc    = _mm_set1_ps(props->yacc_constant);
+    const __m128 x_vel_c  = _mm_set1_ps(props->xvel_constant);
+    const __m128 y_vel_c  = _mm_set1_ps(props->yvel_constant);
+    const __m128 x_dv_acc = _mm_add_ps(x_vel_c, _mm_mul_ps(x_acc, dt));
+    const __m128 y_dv_acc = _mm_add_ps(y_vel_c, _mm_mul_ps(y_acc, dt));
+    const __m128 x_dp_acc = _mm_mul_ps(half, _mm_mul_ps(x_acc, dt));
+    const __m128 y_dp_acc = _mm_mul_ps(half, _mm_mul_ps(y_acc, dt));
+
+    const __m128 max_x_acc = _mm_set1_ps(props->max_x_acc), min_x_acc = _mm_set1_ps(-props->max_x_acc);
+    const __m128 max_y_acc = _mm_set1_ps(props->max_y_acc), min_y_acc = _mm_set1_ps(-props->max_y_acc);
+    const __m128 max_x_vel = _mm_set1_ps(props->max_x_vel), min_x_vel = _mm_set1_ps(-props->max_x_vel);
+    const __m128 max_y_vel = _mm_set1_ps(props->max_y_vel), min_y_vel = _mm_set1_ps(-props->max_y_vel);
+    const __m128 max_x_pos = _mm_set1_ps(props->max_x_pos), min_x_pos = _mm_set1_ps(-props->max_x_pos);
+    const __m128 max_y_pos = _mm_set1_ps(props->max_y_pos), min_y_pos = _mm_set1_ps(-props->max_y_pos);
+
+    uint32_t i;
+    __m128 vx, vy, px, py;
+
+    for (i = begin; i + 4 <= end; i += 4)
+    {
+
+        _mm_storeu_ps(&bodies->x_acc[i], x_acc);
+        _mm_storeu_ps(&bodies->y_acc[i], y_acc);
+
+        // velocity, bounded by the acceleration limits first then the velocity limits
+        vx = _mm_loadu_ps(&bodies->x_vel[i]);
+        vy = _mm_loadu_ps(&bodies->y_vel[i]);
+        vx = _mm_max_ps(min_x_acc, _mm_min_ps(max_x_acc, vx));
+        vy = _mm_max_ps(min_y_acc, _mm_min_ps(max_y_acc, vy));
+        vx = _mm_add_ps(vx, _mm_add_ps(_mm_add_ps(x_dv_acc, _mm_mul_ps(_mm_loadu_ps(&bodies->intr_x_acc[i]), dt)), _mm_mul_ps(_mm_loadu_ps(&bodies->ext_x_acc[i]), dt)));
+        vy = _mm_add_ps(vy, _mm_add_ps(_mm_add_ps(y_dv_acc, _mm_mul_ps(_mm_loadu_ps(&bodies->intr_y_acc[i]), dt)), _mm_mul_ps(_mm_loadu_ps(&bodies->ext_y_acc[i]), dt)));
+        vx = _mm_max_ps(min_x_vel, _mm_min_ps(max_x_vel, vx));
+        vy = _mm_max_ps(min_y_vel, _mm_min_ps(max_y_vel, vy));
+        _mm_storeu_ps(&bodies->x_vel[i], vx);
+        _mm_storeu_ps(&bodies->y_vel[i], vy);
+
+        // momentum
+        _mm_storeu_ps(&bodies->momentum[i], _mm_mul_ps(_mm_loadu_ps(&bodies->mass[i]), _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)))));
+
+        // position
+        px = _mm_add_ps(_mm_loadu_ps(&bodies->x_pos[i]), _mm_add_ps(_mm_mul_ps(vx, dt), x_dp_acc));
+        py = _mm_add_ps(_mm_loadu_ps(&bodies->y_pos[i]), _mm_add_ps(_mm_mul_ps(vy, dt), y_dp_acc));
+        _mm_storeu_ps(&bodies->x_pos[i], _mm_max_ps(min_x_pos, _mm_min_ps(max_x_pos, px)));
+        _mm_storeu_ps(&bodies->y_pos[i], _mm_max_ps(min_y_pos, _mm_min_ps(max_y_pos, py)));
+
+    }
+
+    return i;
+
+}
+
+__attribute__((target("avx2")))
+static uint32_t simobject_integrate_avx2(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props)
+{
+
+    const __m256 dt       = _mm256_set1_ps(props->timestep);
+    const __m256 half     = _mm256_set1_ps(0.5f);
+    const __m256 x_acc    = _mm256_set1_ps(props->xacc_constant);
+    const __m256 y_acc    = _mm256_set1_ps(props->yacc_constant);
+    const __m256 x_vel_c  = _mm256_set1_ps(props->xvel_constant);
+    const __m256 y_vel_c  = _mm256_set1_ps(props->yvel_constant);
+    const __m256 x_dv_acc = _mm256_add_ps(x_vel_c, _mm256_mul_ps(x_acc, dt));
+    const __m256 y_dv_acc = _mm256_add_ps(y_vel_c, _mm256_mul_ps(y_acc, dt));
+    const __m256 x_dp_acc = _mm256_mul_ps(half, _mm256_mul_ps(x_acc, dt));
+    const __m256 y_dp_acc = _mm256_mul_ps(half, _mm256_mul_ps(y_acc, dt));
+
+    const __m256 max_x_acc = _mm256_set1_ps(props->max_x_acc), min_x_acc = _mm256_set1_ps(-props->max_x_acc);
+    const __m256 max_y_acc = _mm256_set1_ps(props->max_y_acc), min_y_acc = _mm256_set1_ps(-props->max_y_acc);
+    const __m256 max_x_vel = _mm256_set1_ps(props->max_x_vel), min_x_vel = _mm256_set1_ps(-props->max_x_vel);
+    const __m256 max_y_vel = _mm256_set1_ps(props->max_y_vel), min_y_vel = _mm256_set1_ps(-props->max_y_vel);
+    const __m256 max_x_pos = _mm256_set1_ps(props->max_x_pos), min_x_pos = _mm256_set1_ps(-props->max_x_pos);
+    const __m256 max_y_pos = _mm256_set1_ps(props->max_y_pos), min_y_pos = _mm256_set1_ps(-props->max_y_pos);
+
+    uint32_t i;
+    __m256 vx, vy, px, py;
+
+    for (i = begin; i + 8 <= end; i += 8)
+    {
+
+        _mm256_storeu_ps(&bodies->x_acc[i], x_acc);
+        _mm256_storeu_ps(&bodies->y_acc[i], y_acc);
+
+        // velocity, bounded by the acceleration limits first then the velocity limits
+        vx = _mm256_loadu_ps(&bodies->x_vel[i]);
+        vy = _mm256_loadu_ps(&bodies->y_vel[i]);
+        vx = _mm256_max_ps(min_x_acc, _mm256_min_ps(max_x_acc, vx));
+        vy = _mm256_max_ps(min_y_acc, _mm256_min_ps(max_y_acc, vy));
+        vx = _mm256_add_ps(vx, _mm256_add_ps(_mm256_add_ps(x_dv_acc, _mm256_mul_ps(_mm256_loadu_ps(&bodies->intr_x_acc[i]), dt)), _mm256_mul_ps(_mm256_loadu_ps(&bodies->ext_x_acc[i]), dt)));
+        vy = _mm256_add_ps(vy, _mm256_add_ps(_mm256_add_ps(y_dv_acc, _mm256_mul_ps(_mm256_loadu_ps(&bodies->intr_y_acc[i]), dt)), _mm256_mul_ps(_mm256_loadu_ps(&bodies->ext_y_acc[i]), dt)));
+        vx = _mm256_max_ps(min_x_vel, _mm256_min_ps(max_x_vel, vx));
+        vy = _mm256_max_ps(min_y_vel, _mm256_min_ps(max_y_vel, vy));
+        _mm256_storeu_ps(&bodies->x_vel[i], vx);
+        _mm256_storeu_ps(&bodies->y_vel[i], vy);
+
+        // momentum
+        _mm256_storeu_ps(&bodies->momentum[i], _mm256_mul_ps(_mm256_loadu_ps(&bodies->mass[i]), _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)))));
+
+        // position
+        px = _mm256_add_ps(_mm256_loadu_ps(&bodies->x_pos[i]), _mm256_add_ps(_mm256_mul_ps(vx, dt), x_dp_acc));
+        py = _mm256_add_ps(_mm256_loadu_ps(&bodies->y_pos[i]), _mm256_add_ps(_mm256_mul_ps(vy, dt), y_dp_acc));
+        _mm256_storeu_ps(&bodies->x_pos[i], _mm256_max_ps(min_x_pos, _mm256_min_ps(max_x_pos, px)));
+        _mm256_storeu_ps(&bodies->y_pos[i], _mm256_max_ps(min_y_pos, _mm256_min_ps(max_y_pos, py)));
+
+    }
+
+    return i;
+
+}
+
+__attribute__((target("avx512f")))
+static uint32_t simobject_integrate_avx512(bodystore_t *bodies, uint32_t begin, uint32_t end, const fieldproperties_t *props)
+{
+
+    const __m512 dt       = _mm512_set1_ps(props->timestep);
+    const __m512 half     = _mm512_set1_ps(0.5f);
+    const __m512 x_acc    = _mm512_set1_ps(props->xacc_constant);
+    const __m512 y_acc    = _mm512_set1_ps(props->yacc_constant);
+    const __m512 x_vel_c  = _mm512_set1_ps(props->xvel_constant);
+    const __m512 y_vel_c  = _mm512_set1_ps(props->yvel_constant);
+    const __m512 x_dv_acc = _mm512_add_ps(x_vel_c, _mm512_mul_ps(x_acc, dt));
+    const __m512 y_dv_acc = _mm512_add_ps(y_vel_c, _mm512_mul_ps(y_acc, dt));
+    const __m512 x_dp_acc = _mm512_mul_ps(half, _mm512_mul_ps(x_acc, dt));
+    const __m512 y_dp_acc = _mm512_mul_ps(half, _mm512_mul_ps(y_acc, dt));
+
+    const __m512 max_x_acc = _mm512_set1_ps(props->max_x_acc), min_x_acc = _mm512_set1_ps(-props->max_x_acc);
+    const __m512 max_y_acc = _mm512_set1_ps(props->max_y_acc), min_y_acc = _mm512_set1_ps(-props->max_y_acc);
+    const __m512 max_x_vel = _mm512_set1_ps(props->max_x_vel), min_x_vel = _mm512_set1_ps(-props->max_x_vel);
+    const __m512 max_y_vel = _mm512_set1_ps(props->max_y_vel), min_y_vel = _mm512_set1_ps(-props->max_y_vel);
+    const __m512 max_x_pos = _mm512_set1_ps(props->max_x_pos), min_x_pos = _mm512_set1_ps(-props->max_x_pos);
+    const __m512 max_y_pos = _mm512_set1_ps(props->max_y_pos), min_y_pos = _mm512_set1_ps(-props->max_y_pos);
+
+    uint32_t i;
+    __m512 vx, vy, px, py;
+
+    for (i = begin; i + 16 <= end; i += 16)
+    {
+
+        _mm512_storeu_ps(&bodies->x_acc[i], x_acc);
+        _mm512_storeu_ps(&bodies->y_acc[i], y_acc);
+
+        // velocity, bounded by the acceleration limits first then the velocity limits
+        vx = _mm512_loadu_ps(&bodies->x_vel[i]);
+        vy = _mm512_loadu_ps(&bodies->y_vel[i]);
+        vx = _mm512_max_ps(min_x_acc, _mm512_min_ps(max_x_acc, vx));
+        vy = _mm512_max_ps(min_y_acc, _mm512_min_ps(max_y_acc, vy));
+        vx = _mm512_add_ps(vx, _mm512_add_ps(_mm512_add_ps(x_dv_acc, _mm512_mul_ps(_mm512_loadu_ps(&bodies->intr_x_acc[i]), dt)), _mm512_mul_ps(_mm512_loadu_ps(&bodies->ext_x_acc[i]), dt)));
+        vy = _mm512_add_ps(vy, _mm512_add_ps(_mm512_add_ps(y_dv_acc, _mm512_mul_ps(_mm512_loadu_ps(&bodies->intr_y_acc[i]), dt)), _mm512_mul_ps(_mm512_loadu_ps(&bodies->ext_y_acc[i]), dt)));
+        vx = _mm512_max_ps(min_x_vel, _mm512_min_ps(max_x_vel, vx));
+        vy = _mm512_max_ps(min_y_vel, _mm512_min_ps(max_y_vel, vy));
+        _mm512_storeu_ps(&bodies->x_vel[i], vx);
+        _mm512_storeu_ps(&bodies->y_vel[i], vy);
+
+        // momentum
+        _mm512_storeu_ps(&bodies->momentum[i], _mm512_mul_ps(_mm512_loadu_ps(&bodies->mass[i]), _mm512_sqrt_ps(_mm512_add_ps(_mm512_mul_ps(vx, vx), _mm512_mul_ps(vy, vy)))));
+
+        // position
+        px = _mm512_add_ps(_mm512_loadu_ps(&bodies->x_pos[i]), _mm512_add_ps(_mm512_mul_ps(vx, dt), x_dp_acc));
+        py = _mm512_add_ps(_mm512_loadu_ps(&bodies->y_pos[i]), _mm512_add_ps(_mm512_mul_ps(vy, dt), y_dp_acc));
+        _mm512_storeu_ps(&bodies->x_pos[i], _mm512_max_ps(min_x_pos, _mm512_min_ps(max_x_pos, px)));
+        _mm512_storeu_ps(&bodies->y_pos[i], _mm512_max_ps(min_y_pos, _mm512_min_ps(max_y_pos, py)));
+
+    }
+
+    return i;
+
+}
+
+#endif
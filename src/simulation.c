@@ -12,6 +12,7 @@
 /* ---------------------------------------------------------------------------------------- */
 
 #include <time.h>
+#include <string.h>
 #include <float.h>
 #include <stdbool.h>
 
@@ -22,6 +23,7 @@
 
 #include "../inc/common.h"
 #include "../inc/shapes.h"
+#include "../inc/gfx-primitives/primitives.h"
 #include "../inc/eventhandler.h"
 #include "../inc/simobject.h"
 #include "../inc/simulation.h"
@@ -30,14 +32,34 @@
 /* ---------------------------------------------------------------------------------------- */
 
 static void simulation_add_objects(simulation_t *sim);
+static body_handle_t simulation_spawn_object(simulation_t *sim);
+static float simulation_random_mass(simulation_t *sim);
+static float simulation_random_offset(simulation_t *sim);
 static void simulation_render_objects(simulation_t *sim);
+static void simulation_rasterize_objects(simulation_t *sim, const snapshot_t *snapshot, float alpha);
+static void simulation_publish_snapshot(simulation_t *sim);
+static void simulation_publish_snapshot_range(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static int simulation_physics_main(void *data);
+static void simulation_apply_requests(simulation_t *sim);
+static void simulation_request_field_edit(simulation_t *sim);
+static void simulation_edit_field(simulation_t *sim, int request);
+static void simulation_step(simulation_t *sim);
 static void simulation_update_object_states(simulation_t *sim);
+static void simulation_init_step(simulation_t *sim);
 static void simulation_init_background(simulation_t *sim);
 static void simulation_init_border(simulation_t *sim);
 
 //!
-static uint8_t* simulation_check_collisions(simulation_t *sim, simobject_t* obj[SIMULATION_NUM_OBJECTS]);
-static void simulation_handle_collisions(simobject_t *obj[SIMULATION_NUM_OBJECTS], uint8_t *collision_matrix_unwrapped, fieldproperties_t props);
+static void simulation_task_border(uint32_t worker, void *context);
+static void simulation_task_broadphase(uint32_t worker, void *context);
+static void simulation_task_forces(uint32_t worker, void *context);
+static void simulation_task_narrowphase(uint32_t worker, void *context);
+static void simulation_narrowphase_range(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void simulation_task_solve(uint32_t worker, void *context);
+static void simulation_task_integrate(uint32_t worker, void *context);
+static void simulation_integrate_range(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void simulation_task_render_prep(uint32_t worker, void *context);
+static void simulation_handle_collisions(bodystore_t *bodies, const broadphase_t *broadphase, contactlist_t *contacts, contactcache_t *cache, solver_t *solver);
 //!
 
 static void sdl_initialize(simulation_t *sim);
@@ -48,7 +70,24 @@ static void sdl_report_error(void);
 
 /* ---------------------------------------------------------------------------------------- */
 
-void simulation_init(simulation_t *sim)
+// fills in the settings used when nothing is overridden on the command line
+void simulation_default_settings(simsettings_t *settings)
+{
+    settings->num_objects = SIMULATION_NUM_OBJECTS;
+    settings->broadphase  = SIMULATION_BROADPHASE;
+    settings->solver_iterations = SIMULATION_SOLVER_ITERATIONS;
+    settings->solver_mode = SIMULATION_SOLVER;
+    settings->threads     = SIMULATION_THREADS;
+    settings->gravity_mode  = SIMULATION_GRAVITY;
+    settings->gravity_theta = SIMULATION_GRAVITY_THETA;
+    settings->field_path    = NULL;
+    settings->seed        = SIMULATION_SEED;
+    settings->deterministic = false;
+    settings->software_render = false;
+    settings->render_threads  = SIMULATION_RENDER_THREADS;
+}
+
+void simulation_init(simulation_t *sim, const simsettings_t *settings)
 {
 
     // allocate memory for all simulation structures
@@ -56,11 +95,75 @@ void simulation_init(simulation_t *sim)
     sim->properties       = malloc(sizeof(simproperties_t));
     sim->userinteractions = malloc(sizeof(simproperties_t));
     sim->fieldproperties  = malloc(sizeof(fieldproperties_t));
-    sim->objects          = malloc(sizeof(simobject_t) * SIMULATION_NUM_OBJECTS);
+    sim->bodies           = malloc(sizeof(bodystore_t));
+    sim->broadphase       = malloc(sizeof(broadphase_t));
+    sim->pairs            = malloc(sizeof(broadphase_pairs_t));
+    sim->contacts         = malloc(sizeof(contactlist_t));
+    sim->contact_cache    = malloc(sizeof(contactcache_t));
+    sim->ccd              = malloc(sizeof(ccd_t));
+    sim->solver           = malloc(sizeof(solver_t));
+    sim->gravity          = malloc(sizeof(gravity_t));
+    sim->field            = malloc(sizeof(forcefield_t));
+    sim->islands          = malloc(sizeof(islands_t));
+    sim->workers          = malloc(sizeof(workers_t));
+    sim->step             = malloc(sizeof(simstep_t));
+    sim->snapshots        = malloc(sizeof(snapshots_t));
+    sim->batch            = malloc(sizeof(renderbatch_t));
+    sim->atlas            = calloc(1, sizeof(spriteatlas_t));
+    sim->raster           = calloc(1, sizeof(softraster_t));
+
+    // nothing runs on the physics thread until simulation_start, and it starts unpaused with no requests
+    sim->physics = NULL;
+    SDL_AtomicSet(&sim->stepping, 0);
+    SDL_AtomicSet(&sim->paused, 0);
+    SDL_AtomicSet(&sim->spawns, 0);
+    SDL_AtomicSet(&sim->despawns, 0);
+    SDL_AtomicSet(&sim->field_edit, 0);
+
+    // start the worker threads before anything that hands them work
+    workers_init(sim->workers, settings->threads);
+
+    // allocate the body store, and the pool the startup bodies are created in, at their full size
+    bodystore_init(sim->bodies, settings->num_objects);
+    simobject_pool_reserve(settings->num_objects);
+
+    // set up the collision broadphase
+    broadphase_init(sim->broadphase, settings->broadphase);
+    broadphase_pairs_init(sim->pairs);
+    contactlist_init(sim->contacts);
+    contactcache_init(sim->contact_cache);
+    ccd_init(sim->ccd);
+    solver_init(sim->solver, settings->solver_iterations, settings->solver_mode, sim->workers);
+    gravity_init(sim->gravity, settings->gravity_mode, settings->gravity_theta, sim->workers);
+    islands_init(sim->islands);
+
+    // lay the step out as a task graph
+    simulation_init_step(sim);
+    snapshots_init(sim->snapshots);
+    renderbatch_init(sim->batch);
 
     // set up SDL2
     sdl_initialize(sim);
 
+    // rasterize the body sprites once, without them bodies are tessellated instead
+    #if (SIMULATION_SPRITE_RENDER)
+    if (!spriteatlas_init(sim->atlas, sim->sdl->renderer))
+    {
+        sdl_report_error();
+    }
+    #endif
+
+    // the CPU frame buffer matches the texture it's uploaded to. The physics thread hands work to
+    // the simulation's pool, so the render thread draws with a pool of its own
+    sim->render_workers = NULL;
+
+    if (settings->software_render)
+    {
+        sim->render_workers = malloc(sizeof(workers_t));
+        workers_init(sim->render_workers, settings->render_threads);
+        softraster_init(sim->raster, WINDOW_WIDTH * TEXTURE_SCALING_FACTOR, WINDOW_HEIGHT * TEXTURE_SCALING_FACTOR, TEXTURE_SCALING_FACTOR, sim->render_workers);
+    }
+
     // set simulation properties
     SDL_GetWindowSize(sim->sdl->window, &sim->properties->windowLength, &sim->properties->windowHeight);
     SDL_GetWindowPosition(sim->sdl->window, &sim->properties->windowPos_x, &sim->properties->windowPos_y);
@@ -71,11 +174,26 @@ void simulation_init(simulation_t *sim)
     //^
 
     sim->properties->fps = SIMULATION_FPS;
+    sim->properties->num_objects = settings->num_objects;
+    sim->properties->deterministic = settings->deterministic;
+    sim->properties->software_render = settings->software_render;
     sim->properties->running = true;
 
+    // every random number comes from a stream of the one seed, so the same seed spawns the same bodies
+    rng_init(&sim->spawn_rng, settings->seed, RNG_STREAM_SPAWN);
+    rng_init(&sim->despawn_rng, settings->seed, RNG_STREAM_DESPAWN);
+    simobject_seed(settings->seed);
+
     // set user interaction default states
     sim->userinteractions->space_pressed = false;
     sim->userinteractions->escape_pressed = false;
+    sim->userinteractions->plus_pressed = false;
+    sim->userinteractions->minus_pressed = false;
+    sim->userinteractions->c_pressed = false;
+    sim->userinteractions->left_pressed = false;
+    sim->userinteractions->right_pressed = false;
+    sim->userinteractions->mouse_x = 0;
+    sim->userinteractions->mouse_y = 0;
 
     // set field properties
     sim->fieldproperties->timestep = 0.12;
@@ -102,22 +220,56 @@ void simulation_init(simulation_t *sim)
     printf("negative x boundary = %f\n", sim->fieldproperties->negative_x_boundary);
     printf("positive y boundary = %f\n", sim->fieldproperties->positive_y_boundary);
     printf("negative y boundary = %f\n", sim->fieldproperties->negative_y_boundary);
+    printf("integrator = %s%s\n", simobject_integrator_name(), simobject_check_integrator(sim->fieldproperties) ? "" : " (doesn't match scalar)");
+    printf("broadphase = %s\n", broadphase_name(sim->broadphase->type));
+    printf("solver = %s, %u threads\n", solver_mode_name(sim->solver->mode), sim->workers->count);
+    printf("gravity = %s, theta %.2f\n", gravity_mode_name(sim->gravity->mode), sim->gravity->theta);
+    printf("seed = %llu%s\n", (unsigned long long)settings->seed, settings->deterministic ? ", deterministic" : "");
+    if (settings->software_render) printf("renderer = software, %s, %u threads\n", sim->raster->fill_name, sim->render_workers->count);
+    else                           printf("renderer = sdl\n");
     //^
 
     // initialize the background & border for the simulation
     simulation_init_background(sim);
     simulation_init_border(sim);
 
+    // lay the force field over the border, bodies live in its frame centered on the origin
+    forcefield_init
+    (
+        sim->field,
+        -sim->properties->border.w / 2.0f, -sim->properties->border.h / 2.0f,
+         sim->properties->border.w / 2.0f,  sim->properties->border.h / 2.0f,
+        SIMULATION_FIELD_COLUMNS, SIMULATION_FIELD_ROWS, sim->workers
+    );
+
+    if (settings->field_path && !forcefield_load(sim->field, settings->field_path))
+    {
+        printf("couldn't load force field '%s'\n", settings->field_path);
+    }
+
+    printf("field = %ux%u%s, %s sampler\n", sim->field->columns, sim->field->rows, sim->field->enabled ? "" : " (empty)", sim->field->sampler_name);
+
     //! add an object to the simulation
     simulation_add_objects(sim);
 
 }
 
-// starts and maintains the simulation (window, renderer, objects)
+// starts and maintains the simulation (window, renderer, objects). Physics steps on its own thread
+// while this one handles events and renders, so a slow present never holds physics up and a slow
+// step never holds up a frame. The two only meet in the snapshot triple buffer and a few atomics
 void simulation_start(simulation_t *sim)
 {
 
-    static uint32_t counter;
+    SDL_AtomicSet(&sim->stepping, 1);
+    sim->physics = SDL_CreateThread(simulation_physics_main, "physics", sim);
+
+    // without a physics thread there's nothing to render, leave it to simulation_kill to clean up
+    if (!sim->physics)
+    {
+        sdl_report_error();
+        SDL_AtomicSet(&sim->stepping, 0);
+        return;
+    }
 
     while(sim->properties->running)
     {
@@ -125,56 +277,112 @@ void simulation_start(simulation_t *sim)
         sdl_process_events(sim);                    // process SDL2-related events
 
         // dead-simple pausing feature
-        if (sim->userinteractions->space_pressed == false)
-        {
-            simulation_update_object_states(sim);       // update state of each object in the simulation
+        SDL_AtomicSet(&sim->paused, sim->userinteractions->space_pressed);
 
-            simulation_render_objects(sim);             // update the render
+        simulation_render_objects(sim);
 
-            if (counter > sim->properties->fps * 5)
-            {
-                sim->fieldproperties->yacc_constant = -0.1;
-                sim->fieldproperties->xacc_constant = -0.5;
-                counter = 0;
-            }
-            else
-            {
-                counter++;
-            }
+        // spawn / despawn a body every frame while + or - is held, the physics thread does the work
+        if (sim->userinteractions->plus_pressed)
+        {
+            SDL_AtomicIncRef(&sim->spawns);
+        }
 
-            SDL_Delay(1000/sim->properties->fps);       // wait for 1 frame before looping again so we can achieve 60 FPS
+        if (sim->userinteractions->minus_pressed)
+        {
+            SDL_AtomicIncRef(&sim->despawns);
+        }
 
-            // quit out if space is pressed
-            if (sim->userinteractions->escape_pressed)
-            {
-                sim->properties->running = false;
-            }
+        // brush the force field under the cursor every frame a mouse button is held, or empty it on c
+        simulation_request_field_edit(sim);
+
+        // quit out if escape is pressed
+        if (sim->userinteractions->escape_pressed)
+        {
+            sim->properties->running = false;
         }
 
     }
 
+    SDL_AtomicSet(&sim->stepping, 0);
+    SDL_WaitThread(sim->physics, NULL);
+
 }
 
 // destroys all SDL objects, frees all dynamically allocated memory, then quits
 void simulation_kill(simulation_t *sim)
 {
 
-    uint16_t i = 0;
+    // the atlas texture belongs to the renderer, so it goes first
+    spriteatlas_destroy(sim->atlas);
+    free(sim->atlas);
+
+    softraster_destroy(sim->raster);
+    free(sim->raster);
+
+    if (sim->render_workers)
+    {
+        workers_destroy(sim->render_workers);
+        free(sim->render_workers);
+    }
+
+    gfxPrimitivesFreeBatch();
 
-    if (sim->sdl->window)   SDL_DestroyWindow(sim->sdl->window);
-    if (sim->sdl->renderer) SDL_DestroyRenderer(sim->sdl->renderer);
     if (sim->sdl->texture)  SDL_DestroyTexture(sim->sdl->texture);
+    if (sim->sdl->renderer) SDL_DestroyRenderer(sim->sdl->renderer);
+    if (sim->sdl->window)   SDL_DestroyWindow(sim->sdl->window);
 
     free(sim->sdl);
     free(sim->properties);
     free(sim->userinteractions);
     free(sim->fieldproperties);
-    
-    for (i = 0; i < SIMULATION_NUM_OBJECTS; i++)
+
+    bodystore_destroy(sim->bodies);
+    free(sim->bodies);
+
+    broadphase_destroy(sim->broadphase);
+    broadphase_pairs_destroy(sim->pairs);
+    free(sim->broadphase);
+    free(sim->pairs);
+
+    contactlist_destroy(sim->contacts);
+    contactcache_destroy(sim->contact_cache);
+    free(sim->contacts);
+    free(sim->contact_cache);
+
+    ccd_destroy(sim->ccd);
+    free(sim->ccd);
+
+    solver_destroy(sim->solver);
+    free(sim->solver);
+
+    gravity_destroy(sim->gravity);
+    free(sim->gravity);
+
+    forcefield_destroy(sim->field);
+    free(sim->field);
+
+    islands_destroy(sim->islands);
+    free(sim->islands);
+
+    for (uint32_t c = 0; c < sim->step->chunk_capacity; c++)
     {
-        free(sim->objects[i]);
+        contactlist_destroy(&sim->step->chunk_contacts[c]);
     }
-    
+
+    free(sim->step->chunk_contacts);
+    free(sim->step);
+
+    snapshots_destroy(sim->snapshots);
+    free(sim->snapshots);
+
+    renderbatch_destroy(sim->batch);
+    free(sim->batch);
+
+    workers_destroy(sim->workers);
+    free(sim->workers);
+
+    simobject_pool_release();
+
     free(sim);
 
     SDL_Quit();
@@ -183,264 +391,490 @@ void simulation_kill(simulation_t *sim)
 
 //! /* ---------------------------------------------------------------------------------------- */  //!
 
-static void simulation_add_objects(simulation_t *sim)
+// steps the simulation until it's stopped. Physics advances in fixed steps of 1/fps seconds, as
+// many as the elapsed time calls for, and the last step of each batch publishes a snapshot
+static int simulation_physics_main(void *data)
 {
 
-    float default_mass = 50;
+    simulation_t *sim = data;
+    const double step_time = 1.0 / sim->properties->fps;
+    const double frequency = (double)SDL_GetPerformanceFrequency();
+    uint64_t now, last;
+    double accumulator = 0.0;
+    uint32_t steps;
 
-    float min_x_spawn = sim->fieldproperties->negative_x_boundary + 50;
-    float max_x_spawn = sim->fieldproperties->positive_x_boundary - 50;
-    float min_y_spawn = sim->fieldproperties->negative_y_boundary + 50;
-    float max_y_spawn = sim->fieldproperties->positive_y_boundary - 50;
+    last = SDL_GetPerformanceCounter();
 
-    float x = min_x_spawn;
-    float y = min_y_spawn;
+    while (SDL_AtomicGet(&sim->stepping))
+    {
 
-/*
-    for (uint8_t i = 0; i < SIMULATION_NUM_OBJECTS; i++)
-    {
-        sim->objects[i] = createObject
-        (
-            default_mass,                           // mass
-            x,                                      // x pos initial
-            y,                                      // y pos initial
-            0,                                      // x vel initial
-            0,                                      // y vel initial
-            0,                                      // x acc initial
-            0,                                      // y acc initial
-            (rand() % 2) - 1,                       // x vel intrinsic
-            (rand() % 2) - 1,                       // y vel intrinsic
-            0,                                      // x acc intrinsic
-            0                                       // y acc intrinsic
-        );
-
-        // make sure they don't overlap (not robust at all)  
-        if (x + ( (default_mass/2) + 2 ) >= max_x_spawn)
+        now = SDL_GetPerformanceCounter();
+
+        // time spent paused isn't caught up on
+        if (SDL_AtomicGet(&sim->paused))
+        {
+            last = now;
+            SDL_Delay(1);
+            continue;
+        }
+
+        accumulator += (now - last) / frequency;
+        last = now;
+
+        // run the steps that are due, giving up on the rest if we've fallen too far behind
+        steps = (uint32_t)SDL_min(accumulator / step_time, (double)SIMULATION_MAX_STEPS_PER_FRAME);
+        accumulator = SDL_min(accumulator - steps * step_time, step_time);
+
+        // the render draws the bodies this far from the batch's last step towards the next one
+        sim->step->alpha = (float)(accumulator / step_time);
+
+        simulation_apply_requests(sim);
+
+        for (uint32_t s = 0; s < steps; s++)
         {
-            x = min_x_spawn;
-            y = min_y_spawn + ( (default_mass/2) + 2 );
+
+            // a snapshot carries the positions its step started from, for the render to interpolate
+            sim->step->render_prep = (s == steps - 1);
+
+            if (sim->step->render_prep)
+            {
+                bodystore_save_positions(sim->bodies);
+            }
+
+            simulation_step(sim);                       // update state of each object in the simulation
+
         }
-        else
+
+        // nothing due yet, give the core up until the next step is
+        if (steps == 0)
         {
-            x += ( (default_mass/2) + 2 );
-            y += ( (default_mass/2) + 2 );
+            SDL_Delay(0);
         }
-        
+
     }
-*/
 
-    // * there is an issue with the "intrinsic velocity" that is causing simulation border problems
+    return 0;
 
-/*
-    sim->objects[0] = createObject(30, 300, -100, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[1] = createObject(24, -100, -33, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[2] = createObject(30, -150, 0, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[3] = createObject(40, 200, 120, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[4] = createObject(32, -210, -120, 0, 0, 0, 0, 0, 0, 0, 0);
-    
-    sim->objects[5] = createObject(35, -84, 30, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[6] = createObject(38, 200, -183, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[7] = createObject(39, -215, -33, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[8] = createObject(29, -120, 121, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[9] = createObject(28, 200, 84, 235, 0, 0, 0, 0, 0, 0, 0);
-*/
-
-    sim->objects[0] = createObject(30, -rand() % 200, -rand() % 200, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[1] = createObject(24, -rand() % 200, -rand() % 200, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[2] = createObject(30, -rand() % 200,  rand() % 200, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[3] = createObject(40,  rand() % 200, -rand() % 200, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[4] = createObject(32,  rand() % 200, -rand() % 200, 0, 0, 0, 0, 0, 0, 0, 0);
-
-    sim->objects[5] = createObject(35,  rand() % 200,  rand() % 200, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[6] = createObject(38, -rand() % 200, -rand() % 200, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[7] = createObject(39, -rand() % 200,  rand() % 200, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[8] = createObject(29,  rand() % 200, -rand() % 200, 0, 0, 0, 0, 0, 0, 0, 0);
-    sim->objects[9] = createObject(28, -rand() % 200,  rand() % 200, 0, 0, 0, 0, 0, 0, 0, 0);
-
-}
-
-// detects which objects have interecting locations (O(N^2)). Treats objects as rectangles
-static uint8_t* simulation_check_collisions(simulation_t *sim, simobject_t* obj[SIMULATION_NUM_OBJECTS])
-{
-
-    uint8_t collision_matrix[SIMULATION_NUM_OBJECTS][SIMULATION_NUM_OBJECTS] = {0};
-    uint8_t *collision_matrix_unwrapped;
-    uint16_t row_index, col_index;
-    uint16_t i, j, k;
-    uint16_t nrows, ncols;
-    simobject_t obj1, obj2;
-    SDL_FRect rect1, rect2, border;
+}
+
+// adds and removes the bodies the render thread asked for. Only the physics thread touches the
+// bodies while it runs
+static void simulation_apply_requests(simulation_t *sim)
+{
+
+    int spawns   = SDL_AtomicSet(&sim->spawns, 0);
+    int despawns = SDL_AtomicSet(&sim->despawns, 0);
+
+    for (; spawns > 0; spawns--)
+    {
+        simulation_spawn_object(sim);
+    }
+
+    for (; despawns > 0 && sim->bodies->count > 0; despawns--)
+    {
+        simulation_remove_object(sim, bodystore_handle(sim->bodies, rng_below(&sim->despawn_rng, sim->bodies->count)));
+    }
+
+    simulation_edit_field(sim, SDL_AtomicSet(&sim->field_edit, 0));
+
+}
+
+// packs the field edit the user is asking for, if any, into one word for the physics thread. Only
+// the latest one counts, like a held key, so one the physics thread hasn't got to yet is replaced
+static void simulation_request_field_edit(simulation_t *sim)
+{
+
+    const userinteractions_t *input = sim->userinteractions;
+    simfield_edit_t edit;
+
+    if      (input->c_pressed)     edit = SIMULATION_FIELD_CLEAR;
+    else if (input->left_pressed)  edit = SIMULATION_FIELD_ATTRACT;
+    else if (input->right_pressed) edit = SIMULATION_FIELD_SWIRL;
+    else                           return;
+
+    SDL_AtomicSet(&sim->field_edit, edit << 24 | SDL_clamp(input->mouse_y, 0, 0xFFF) << 12 | SDL_clamp(input->mouse_x, 0, 0xFFF));
+
+}
+
+// applies a packed field edit from simulation_request_field_edit. The brushes only touch the grid
+// points within their radius of the cursor. Sleeping bodies are resting under the old field, so
+// wake everyone
+static void simulation_edit_field(simulation_t *sim, int request)
+{
+
+    const simfield_edit_t edit = (simfield_edit_t)(request >> 24);
+    const float x = (request & 0xFFF) - (sim->properties->border.x + sim->properties->border.w / 2.0f);
+    const float y = ((request >> 12) & 0xFFF) - (sim->properties->border.y + sim->properties->border.h / 2.0f);
+
+    switch (edit)
+    {
+
+        case SIMULATION_FIELD_ATTRACT:
+            forcefield_add_attractor(sim->field, x, y, SIMULATION_FIELD_BRUSH_RADIUS, SIMULATION_FIELD_BRUSH_STRENGTH);
+            break;
+
+        case SIMULATION_FIELD_SWIRL:
+            forcefield_add_vortex(sim->field, x, y, SIMULATION_FIELD_BRUSH_RADIUS, SIMULATION_FIELD_BRUSH_STRENGTH);
+            break;
+
+        case SIMULATION_FIELD_CLEAR:
+            forcefield_clear(sim->field);
+            break;
+
+        default:
+            return;
+
+    }
+
+    bodystore_wake_all(sim->bodies);
+
+}
+
+// spawns the initial set of bodies in one pooled batch
+static void simulation_add_objects(simulation_t *sim)
+{
+
+    uint32_t count = sim->properties->num_objects;
+    simobject_t *objs = createObjects(count, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        simobject_set_mass(&objs[i], simulation_random_mass(sim));
+        objs[i].x_pos = simulation_random_offset(sim);
+        objs[i].y_pos = simulation_random_offset(sim);
+    }
+
+    bodystore_insert_many(sim->bodies, objs, count, NULL);
+
+    destroyObjects(objs, count);
+
+}
+
+// adds one body with a random mass somewhere near the center of the border
+static body_handle_t simulation_spawn_object(simulation_t *sim)
+{
+
+    float mass  = simulation_random_mass(sim);
+    float x_pos = simulation_random_offset(sim);
+    float y_pos = simulation_random_offset(sim);
+
+    return simulation_add_object(sim, createObject(mass, x_pos, y_pos, 0, 0, 0, 0, 0, 0, 0, 0));
+
+}
+
+// a spawned body's mass, 24 to 40
+static float simulation_random_mass(simulation_t *sim)
+{
+    return 24 + rng_below(&sim->spawn_rng, 17);
+}
+
+// a spawned body's offset from the center along one axis, within 200 either way. The sign and the
+// size are drawn as separate statements so the order they're drawn in is fixed
+static float simulation_random_offset(simulation_t *sim)
+{
+
+    float sign = rng_below(&sim->spawn_rng, 2) ? 1.0f : -1.0f;
+
+    return sign * rng_below(&sim->spawn_rng, 200);
+
+}
+
+// copies a freshly created object into the body store, then releases it. Once the simulation has
+// started, only the physics thread may add bodies
+body_handle_t simulation_add_object(simulation_t *sim, simobject_t *obj)
+{
+
+    body_handle_t handle = bodystore_insert(sim->bodies, obj);
+
+    destroyObject(obj);
+
+    return handle;
+
+}
+
+// removes a body from the simulation, returns false if the handle is stale. Once the simulation has
+// started, only the physics thread may remove bodies. Whatever was resting
+// on it has lost its support, and nothing touches a sleeping body to tell it so, so wake everyone
+bool simulation_remove_object(simulation_t *sim, body_handle_t handle)
+{
+
+    if (!bodystore_remove(sim->bodies, handle))
+    {
+        return false;
+    }
+
+    bodystore_wake_all(sim->bodies);
+
+    return true;
+
+}
+
+// detects which awake objects stick out of the border and records each as a contact. Starts this
+// step's contact list, so the narrowphase waits on it. Sleeping bodies haven't moved since they last
+// touched the border
+static void simulation_task_border(uint32_t worker, void *context)
+{
+
+    simulation_t *sim = context;
+    bodystore_t *bodies = sim->bodies;
+    contactlist_t *contacts = sim->contacts;
+
+    uint32_t i, n;
+    SDL_FRect rect1, border;
+    contact_t contact;
     float window_x_origin, window_y_origin;
 
-    nrows  = SIMULATION_NUM_OBJECTS;
-    ncols  = SIMULATION_NUM_OBJECTS;
+    const float *x_pos  = bodies->x_pos;
+    const float *y_pos  = bodies->y_pos;
+    const float *width  = bodies->width;
+    const float *height = bodies->height;
+
+    n      = bodies->awake_count;
     border = sim->properties->border;
 
     // retrieve the objects x and y origins in window space
     window_x_origin = sim->properties->border.x + (sim->properties->border.w / 2.0f);
     window_y_origin = sim->properties->border.y + (sim->properties->border.h / 2.0f);
 
-    // malloc the return array and set to 0
-    collision_matrix_unwrapped = malloc(nrows * ncols);
-    for (i = 0; i < nrows; i++) collision_matrix_unwrapped[i] = 0;
+    contacts->count = 0;
 
-    // detect collisions with border
-    for (i = 0; i < nrows; i++)
+    for (i = 0; i < n; i++)
     {
 
-        obj1 = *obj[i];
-
         // convert object's x-y coordinates to window coordinates
-        rect1.x = window_x_origin + obj1.x_pos;
-        rect1.y = window_y_origin + obj1.y_pos; 
-        rect1.w = obj1.width;
-        rect1.h = obj1.height;
+        rect1.x = window_x_origin + x_pos[i];
+        rect1.y = window_y_origin + y_pos[i];
+        rect1.w = width[i];
+        rect1.h = height[i];
 
         //^
         //printf("rect1: (%f) (%f)\n", rect1.x, rect1.y);
         //^
 
-        collision_matrix[i][i] = detect_border_collision(rect1, border);
+        if (detect_border_contact(rect1, border, &contact))
+        {
+            contact.a = i;
+            *contactlist_push(contacts) = contact;
+        }
 
     }
 
-    // detect collisions with other objects
-    for (i = 0; i < nrows; i++)
-    {
+}
 
-        obj1 = *obj[i];
+// finds the pairs of objects whose bounding boxes overlap and at least one of which is awake.
+// Pairs are ordered by dense index, so b sleeping is enough
+static void simulation_task_broadphase(uint32_t worker, void *context)
+{
 
-        // convert object's x-y coordinates to window coordinates
-        rect1.x = window_x_origin + obj1.x_pos;
-        rect1.y = window_y_origin + obj1.y_pos; 
-        rect1.w = obj1.width;
-        rect1.h = obj1.height;
+    simulation_t *sim = context;
+    broadphase_pairs_t *pairs = sim->pairs;
+    const uint32_t n = sim->bodies->awake_count;
+    uint32_t i, k;
 
-        for (j = 0; j < ncols; j++)
-        {
+    broadphase_find_pairs(sim->broadphase, sim->bodies, pairs);
 
-            if (i == j) continue;       // skip the border collision case
+    for (i = 0, k = 0; k < pairs->count; k++)
+    {
+        if (pairs->pairs[k].a < n)
+        {
+            pairs->pairs[i++] = pairs->pairs[k];
+        }
+    }
 
-            obj2 = *obj[j];
+    pairs->count = i;
 
-            // convert object's x-y coordinates to window coordinates
-            rect2.x = window_x_origin + obj2.x_pos;
-            rect2.y = window_y_origin + obj2.y_pos; 
-            rect2.w = obj2.width;
-            rect2.h = obj2.height;
+}
 
-            collision_matrix[i][j] = detect_object_collision(rect1, rect2);
+// works out this step's external acceleration of the awake bodies, the pull of every other body
+// plus the force field, which the integrator adds to their own. It's zeroed first every step, so
+// nothing is left over once gravity is turned off or the field is cleared
+static void simulation_task_forces(uint32_t worker, void *context)
+{
 
-        }
+    simulation_t *sim = context;
+    bodystore_t *bodies = sim->bodies;
 
-    }
+    memset(bodies->ext_x_acc, 0, bodies->awake_count * sizeof(float));
+    memset(bodies->ext_y_acc, 0, bodies->awake_count * sizeof(float));
 
-    // unwrap array into 1D
-    for (i = 0, col_index = 0; col_index < ncols; col_index++)
+    if (sim->gravity->mode == GRAVITY_OFF && !sim->field->enabled)
     {
-        for (row_index = 0; row_index < nrows; row_index++, i++)
-        {
-            collision_matrix_unwrapped[i] = collision_matrix[row_index][col_index];
-        }
+        return;
     }
 
-    return collision_matrix_unwrapped;
+    gravity_apply(sim->gravity, bodies);
+    forcefield_apply(sim->field, bodies);
 
 }
 
-// marks objects with what objects they are colliding with
-static void simulation_handle_collisions(simobject_t *obj[SIMULATION_NUM_OBJECTS], uint8_t *collision_matrix_unwrapped, fieldproperties_t props)
+// tests the broadphase's pairs for touching circles in fixed size chunks across the workers, then
+// appends each chunk's contacts in chunk order so the list comes out the same on any thread count
+static void simulation_task_narrowphase(uint32_t worker, void *context)
 {
 
-    uint8_t i, j, k;
-    uint8_t collision_matrix[SIMULATION_NUM_OBJECTS][SIMULATION_NUM_OBJECTS] = {0};
-    static uint8_t last_collision_matrix[SIMULATION_NUM_OBJECTS][SIMULATION_NUM_OBJECTS];
-    uint8_t nrows, ncols;
-    uint16_t row_index, col_index, obj_index;
-    uint16_t counter = 0;
-    uint8_t num_ignore_frames = 2;
+    simulation_t *sim = context;
+    simstep_t *step = sim->step;
+    const contactlist_t *chunk;
+    uint32_t chunks, c, k;
 
-    nrows = SIMULATION_NUM_OBJECTS;
-    ncols = SIMULATION_NUM_OBJECTS;
+    chunks = (sim->pairs->count + SIMULATION_NARROWPHASE_GRAIN - 1) / SIMULATION_NARROWPHASE_GRAIN;
 
-    // unwrap collision matrix to 2D
-    for (i = 0, col_index = 0; col_index < ncols; col_index++)
+    if (chunks > step->chunk_capacity)
     {
-        for (row_index = 0; row_index < nrows; row_index++, i++)
+        step->chunk_contacts = realloc(step->chunk_contacts, chunks * sizeof(contactlist_t));
+
+        for (c = step->chunk_capacity; c < chunks; c++)
         {
-            collision_matrix[row_index][col_index] = collision_matrix_unwrapped[i];
+            contactlist_init(&step->chunk_contacts[c]);
         }
+
+        step->chunk_capacity = chunks;
+    }
+
+    // a pool of one thread runs the whole loop as one range, into the first chunk
+    for (c = 0; c < chunks; c++)
+    {
+        step->chunk_contacts[c].count = 0;
     }
 
-    //^ print collision matrix
-    printf("----------\n");
-    for (i = 0; i < nrows; i++)
+    workers_parallel_for(sim->workers, sim->pairs->count, SIMULATION_NARROWPHASE_GRAIN, simulation_narrowphase_range, sim);
+
+    for (c = 0; c < chunks; c++)
     {
-        printf("|");
-        for (j = 0; j < ncols; j++)
+
+        chunk = &step->chunk_contacts[c];
+
+        for (k = 0; k < chunk->count; k++)
         {
-            printf("%d|", collision_matrix[i][j]);
+            *contactlist_push(sim->contacts) = chunk->contacts[k];
         }
-        printf("\n");
+
     }
-    printf("=----------\n");
-    //^
 
-    // every collision is just a simple harmonic oscillator... sshhh!
-    for (i = 0, obj_index = 0; i < nrows; i++, obj_index++)
+}
+
+static void simulation_narrowphase_range(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    simulation_t *sim = context;
+
+    detect_circle_contacts_range(sim->bodies, sim->pairs, begin, end, &sim->step->chunk_contacts[begin / SIMULATION_NARROWPHASE_GRAIN]);
+
+}
+
+// resolves this step's contacts, then puts resting islands to sleep and wakes the sleepers that
+// got touched
+static void simulation_task_solve(uint32_t worker, void *context)
+{
+
+    simulation_t *sim = context;
+
+    simulation_handle_collisions(sim->bodies, sim->broadphase, sim->contacts, sim->contact_cache, sim->solver);
+
+    #if (SIMULATION_SLEEP)
     {
-        for (j = 0; j < ncols; j++)
-        {
+        islands_update(sim->islands, sim->bodies, sim->contacts);
+    }
+    #endif
 
-            // if there's a collision between obj[i] and obj[j]
-            if (collision_matrix[i][j])
-            {
+}
 
-                // if these objects very recently collided, ignore it
-                if (last_collision_matrix[i][j] != 0)
-                {
-                    last_collision_matrix[i][j]--;
-                    continue;
-                }
+// update objects according to field properties, in parallel over the awake bodies
+static void simulation_task_integrate(uint32_t worker, void *context)
+{
 
-                // if it's a border collision
-                if (i == j)
-                {
-                    //^
-                    printf("object x,y velocity b4 collision = %f,%f\n", obj[i]->x_vel, obj[i]->y_vel);
-                    //^
+    simulation_t *sim = context;
 
-                    simobject_t border = { .mass = 10000, .x_vel = obj[i]->x_vel, .y_vel = obj[i]->y_vel };
-                    simobject_collision(obj[i], &border, collision_matrix[i][j], props);
+    #if (SIMULATION_CCD)
+    {
+        // sweep anything that moved far enough to tunnel through a body or the border
+        ccd_begin(sim->ccd, sim->bodies);
+        workers_parallel_for(sim->workers, sim->bodies->awake_count, 0, simulation_integrate_range, sim);
+        ccd_resolve(sim->ccd, sim->bodies, sim->broadphase, sim->fieldproperties, sim->properties->border.w / 2.0f, sim->properties->border.h / 2.0f);
+    }
+    #else
+    {
+        workers_parallel_for(sim->workers, sim->bodies->awake_count, 0, simulation_integrate_range, sim);
+    }
+    #endif
 
-                    //^
-                    printf("object x,y velocity after collision = %f,%f\n", obj[i]->x_vel, obj[i]->y_vel);
-                    //^
+}
 
-                    last_collision_matrix[i][j] = num_ignore_frames;
+static void simulation_integrate_range(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
 
-                }
+    simulation_t *sim = context;
 
-                // if it's an object collision
-                else
-                {
-                    simobject_collision(obj[i], obj[j], collision_matrix[i][j], props);
-                    last_collision_matrix[i][j] = num_ignore_frames;
-                }
+    simobject_update_states_range(sim->bodies, begin, end, sim->fieldproperties);
 
-                // don't re-calculate the collision
-                collision_matrix[j][i] = 0;
+}
 
-            }
-        }
+// publishes a snapshot from the last step of the batch
+static void simulation_task_render_prep(uint32_t worker, void *context)
+{
+
+    simulation_t *sim = context;
+
+    if (sim->step->render_prep)
+    {
+        simulation_publish_snapshot(sim);
     }
 
-    free(collision_matrix_unwrapped);
-    
+}
+
+// resolves every contact found this frame, warm starting the solver with the impulses pairs that
+// were already touching built up last frame
+static void simulation_handle_collisions(bodystore_t *bodies, const broadphase_t *broadphase, contactlist_t *contacts, contactcache_t *cache, solver_t *solver)
+{
+
+    const broadphase_pairs_t *began, *ended;
+
+    // carry over impulses from pairs that were already touching, and forget the ones whose
+    // bounds came apart if the broadphase tracks that
+    if (!broadphase_events(broadphase, &began, &ended))
+    {
+        ended = NULL;
+    }
+
+    contactcache_update(cache, bodies, contacts, ended);
+
+    solver_solve(solver, bodies, contacts);
+
+    contactcache_store(cache, bodies, contacts);
+
 }
 
 //! /* ---------------------------------------------------------------------------------------- */  //!
 
+// lays the step out as a task graph. The border, the broadphase and the forces only read the
+// bodies' positions, so they run side by side; everything after them runs in order, each phase spreading
+// its loops across the workers
+static void simulation_init_step(simulation_t *sim)
+{
+
+    workers_graph_t *graph = &sim->step->graph;
+    workers_task_t *border, *broadphase, *forces, *narrowphase, *solve, *integrate, *render_prep;
+
+    memset(sim->step, 0, sizeof(simstep_t));
+    workers_graph_init(graph);
+
+    border      = workers_graph_add(graph, "border",      simulation_task_border,      sim);
+    broadphase  = workers_graph_add(graph, "broadphase",  simulation_task_broadphase,  sim);
+    forces      = workers_graph_add(graph, "forces",      simulation_task_forces,      sim);
+    narrowphase = workers_graph_add(graph, "narrowphase", simulation_task_narrowphase, sim);
+    solve       = workers_graph_add(graph, "solve",       simulation_task_solve,       sim);
+    integrate   = workers_graph_add(graph, "integrate",   simulation_task_integrate,   sim);
+    render_prep = workers_graph_add(graph, "render-prep", simulation_task_render_prep, sim);
+
+    workers_graph_depend(narrowphase, border);
+    workers_graph_depend(narrowphase, broadphase);
+    workers_graph_depend(solve,       narrowphase);
+    workers_graph_depend(solve,       forces);
+    workers_graph_depend(integrate,   solve);
+    workers_graph_depend(render_prep, integrate);
+
+}
+
 // initializes the background for the simulation
 static void simulation_init_background(simulation_t *sim)
 {
@@ -476,54 +910,232 @@ static void simulation_init_border(simulation_t *sim)
 
 }
 
-// applies field properties to the objects in the simulation
-static void simulation_update_object_states(simulation_t *sim)
+// advances the simulation by one fixed step
+static void simulation_step(simulation_t *sim)
 {
 
-    uint8_t *cm_unwrapped;
+    static uint32_t counter;
+
+    simulation_update_object_states(sim);
+
+    sim->step->steps++;
+
+    // the hash only depends on the seed and the requests applied, never on the thread count, so two
+    // runs can be compared step by step
+    if (sim->properties->deterministic)
+    {
+        sim->step->hash = bodystore_hash(sim->bodies);
+        printf("step %llu hash %016llx\n", (unsigned long long)sim->step->steps, (unsigned long long)sim->step->hash);
+    }
+
+    // flip the field after five seconds' worth of steps. Bodies resting under the old field
+    // aren't resting under the new one
+    if (counter > sim->properties->fps * 5)
+    {
+        sim->fieldproperties->yacc_constant = -0.1;
+        sim->fieldproperties->xacc_constant = -0.5;
+        bodystore_wake_all(sim->bodies);
+        counter = 0;
+    }
+    else
+    {
+        counter++;
+    }
+
+}
+
+// applies field properties to the objects in the simulation. The step runs as a task graph on the
+// workers, see simulation_init_step
+static void simulation_update_object_states(simulation_t *sim)
+{
 
-    // applies any momenta transferrance between objects
-    cm_unwrapped = simulation_check_collisions(sim, sim->objects);
-    simulation_handle_collisions(sim->objects, cm_unwrapped, *sim->fieldproperties);
+    workers_graph_run(sim->workers, &sim->step->graph);
 
-    // update objects according to field properties
-    for(uint32_t i = 0; i < SIMULATION_NUM_OBJECTS; i++)
+    // report how well each phase used the threads, and how hard the latest solve worked, once a second
+    if (++sim->step->report_steps >= sim->properties->fps)
     {
-        simobject_update_state(sim->objects[i], *sim->fieldproperties);
+        workers_graph_report(sim->workers, &sim->step->graph);
+        printf("solver: %u iterations, residual %f\n", sim->solver->iterations_used, sim->solver->residual);
+        sim->step->report_steps = 0;
     }
 
 }
 
-// renders each object as a rectangle and draws them to the screen
+// renders each object of the newest snapshot as a circle and draws them to the screen. Bodies are
+// drawn between where they were before the snapshot's step and after it, by the fraction of a step
+// the accumulator held when it was published, so motion stays smooth at any display rate
 static void simulation_render_objects(simulation_t *sim)
 {
 
-    simobject_t cur_obj;
+    const snapshot_t *snapshot = snapshots_latest(sim->snapshots);
+    const float alpha = snapshot->alpha;
+    float x_pos, y_pos;
+
+    // the software rasterizer draws the background and border itself
+    if (sim->properties->software_render)
+    {
+        simulation_rasterize_objects(sim, snapshot, alpha);
+        SDL_RenderPresent(sim->sdl->renderer);
+        return;
+    }
 
     sdl_redraw_background(sim);
     sdl_redraw_border(sim);
 
-    for (uint32_t i = 0; i < SIMULATION_NUM_OBJECTS; i++)
+    #if (SIMULATION_BATCH_RENDER)
     {
 
-        cur_obj = *sim->objects[i];                                                  
+        // every body goes into one batch of triangles, drawn with a single call
+        const float x_origin = sim->properties->border.x + (sim->properties->border.w / 2.0f);
+        const float y_origin = sim->properties->border.y + (sim->properties->border.h / 2.0f);
+        const spriteatlas_sprite_t *sprite;
+        SDL_FRect rect;
+        float radius, extent;
+
+        renderbatch_clear(sim->batch);
+
+        for (uint32_t i = 0; i < snapshot->count; i++)
+        {
+
+            x_pos = snapshot->prev_x_pos[i] + alpha * (snapshot->x_pos[i] - snapshot->prev_x_pos[i]);
+            y_pos = snapshot->prev_y_pos[i] + alpha * (snapshot->y_pos[i] - snapshot->prev_y_pos[i]);
+
+            // the body's circle, see bodystore_radius, in window coordinates
+            x_pos  = x_origin + bodystore_center(x_pos, snapshot->width[i]);
+            y_pos  = y_origin + bodystore_center(y_pos, snapshot->width[i]);
+            radius = bodystore_radius(snapshot->width[i]);
+
+            if (sim->atlas->texture)
+            {
+
+                // the sprite's cell reaches past its disc, so the quad is stretched by as much
+                sprite = spriteatlas_find(sim->atlas, radius);
+                extent = radius * sprite->extent;
+                rect   = (SDL_FRect){ x_pos - extent, y_pos - extent, 2.0f * extent, 2.0f * extent };
+
+                renderbatch_add_quad(sim->batch, &rect, &sprite->uv, snapshot->color[i]);
 
-        if (SDL_SetRenderDrawColor(sim->sdl->renderer, cur_obj.color_r, cur_obj.color_g, cur_obj.color_b, 0xFF))         
+            }
+            else
+            {
+                renderbatch_add_ellipse(sim->batch, x_pos, y_pos, radius, radius, snapshot->color[i]);
+            }
+
+        }
+
+        if (renderbatch_submit(sim->batch, sim->sdl->renderer, sim->atlas->texture))
         {
             sdl_report_error();
-        }             
-        
-        if (shapes_render_circle(sim, &cur_obj))
+        }
+
+    }
+    #else
+    {
+
+        uint32_t color;
+
+        // the fills only collect their scanlines, which are drawn a run of same-colored bodies at a time
+        gfxPrimitivesBeginBatch(sim->sdl->renderer);
+
+        for (uint32_t i = 0; i < snapshot->count; i++)
+        {
+
+            color = snapshot->color[i];
+
+            if (SDL_SetRenderDrawColor(sim->sdl->renderer, color >> 24, (color >> 16) & 0xFF, (color >> 8) & 0xFF, 0xFF))
+            {
+                sdl_report_error();
+            }
+
+            x_pos = snapshot->prev_x_pos[i] + alpha * (snapshot->x_pos[i] - snapshot->prev_x_pos[i]);
+            y_pos = snapshot->prev_y_pos[i] + alpha * (snapshot->y_pos[i] - snapshot->prev_y_pos[i]);
+
+            if (shapes_render_circle(sim, x_pos, y_pos, snapshot->width[i], snapshot->height[i], color))
+            {
+                sdl_report_error();
+            }
+
+        }
+
+        if (gfxPrimitivesFlushBatch(sim->sdl->renderer))
         {
             sdl_report_error();
         }
 
     }
+    #endif
 
     SDL_RenderPresent(sim->sdl->renderer);
 
 }
 
+// draws the background, the border and every body of the snapshot into the CPU frame buffer, tile
+// by tile across the render workers, then uploads it to the texture in one go and stretches that
+// over the window
+static void simulation_rasterize_objects(simulation_t *sim, const snapshot_t *snapshot, float alpha)
+{
+
+    softraster_t *raster = sim->raster;
+    const SDL_FRect *border = &sim->properties->border;
+    const float x_origin = border->x + (border->w / 2.0f);
+    const float y_origin = border->y + (border->h / 2.0f);
+    float x_pos, y_pos;
+
+    softraster_begin(raster, 0x000000FF);
+    softraster_draw_rect(raster, border->x, border->y, border->w, border->h, 0xFFFFFFFF);
+
+    for (uint32_t i = 0; i < snapshot->count; i++)
+    {
+
+        x_pos = snapshot->prev_x_pos[i] + alpha * (snapshot->x_pos[i] - snapshot->prev_x_pos[i]);
+        y_pos = snapshot->prev_y_pos[i] + alpha * (snapshot->y_pos[i] - snapshot->prev_y_pos[i]);
+
+        // the body's circle, see bodystore_radius
+        softraster_fill_circle(raster, x_origin + bodystore_center(x_pos, snapshot->width[i]), y_origin + bodystore_center(y_pos, snapshot->width[i]),
+                               bodystore_radius(snapshot->width[i]), snapshot->color[i]);
+
+    }
+
+    softraster_end(raster);
+
+    if (SDL_UpdateTexture(sim->sdl->texture, NULL, raster->pixels, raster->width * sizeof(uint32_t)) ||
+        SDL_RenderCopy(sim->sdl->renderer, sim->sdl->texture, NULL, NULL))
+    {
+        sdl_report_error();
+    }
+
+}
+
+// copies what the renderer needs of every body into the back snapshot and hands it to the render
+// thread
+static void simulation_publish_snapshot(simulation_t *sim)
+{
+
+    snapshots_back(sim->snapshots, sim->bodies->count)->alpha = sim->step->alpha;
+
+    workers_parallel_for(sim->workers, sim->bodies->count, 0, simulation_publish_snapshot_range, sim);
+
+    snapshots_publish(sim->snapshots);
+
+}
+
+static void simulation_publish_snapshot_range(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    simulation_t *sim = context;
+    const bodystore_t *bodies = sim->bodies;
+    snapshot_t *snapshot = &sim->snapshots->buffers[sim->snapshots->back];
+
+    memcpy(&snapshot->prev_x_pos[begin], &bodies->prev_x_pos[begin], (end - begin) * sizeof(float));
+    memcpy(&snapshot->prev_y_pos[begin], &bodies->prev_y_pos[begin], (end - begin) * sizeof(float));
+    memcpy(&snapshot->x_pos[begin],      &bodies->x_pos[begin],      (end - begin) * sizeof(float));
+    memcpy(&snapshot->y_pos[begin],      &bodies->y_pos[begin],      (end - begin) * sizeof(float));
+    memcpy(&snapshot->width[begin],      &bodies->width[begin],      (end - begin) * sizeof(float));
+    memcpy(&snapshot->height[begin],     &bodies->height[begin],     (end - begin) * sizeof(float));
+    memcpy(&snapshot->color[begin],      &bodies->color[begin],      (end - begin) * sizeof(uint32_t));
+
+}
+
 /* ---------------------------------------------------------------------------------------- */
 
 // initializes all SDL2-related components of the simulation
@@ -547,7 +1159,7 @@ static void sdl_initialize(simulation_t *sim)
         sdl_report_error();
     }
 
-    sim->sdl->texture = SDL_CreateTexture(sim->sdl->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, WINDOW_WIDTH * TEXTURE_SCALING_FACTOR, WINDOW_HEIGHT * TEXTURE_SCALING_FACTOR);
+    sim->sdl->texture = SDL_CreateTexture(sim->sdl->renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, WINDOW_WIDTH * TEXTURE_SCALING_FACTOR, WINDOW_HEIGHT * TEXTURE_SCALING_FACTOR);
     if (!sim->sdl->texture)
     {
         sdl_report_error();
@@ -577,6 +1189,15 @@ static void sdl_process_events(simulation_t *sim)
             case SDL_KEYUP:
                 evt_sdl_keyup_handler(&event, sim);
                 break;
+
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+                evt_sdl_mousebutton_handler(&event, sim);
+                break;
+
+            case SDL_MOUSEMOTION:
+                evt_sdl_mousemotion_handler(&event, sim);
+                break;
                 
             default:
                 break;
@@ -0,0 +1,96 @@
+/*
+ *  snapshots.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/snapshots.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+void snapshots_init(snapshots_t *snapshots)
+{
+
+    memset(snapshots, 0, sizeof(snapshots_t));
+
+    snapshots->back  = 0;
+    snapshots->front = 1;
+    SDL_AtomicSet(&snapshots->middle, 2);
+
+}
+
+void snapshots_destroy(snapshots_t *snapshots)
+{
+
+    snapshot_t *snapshot;
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+
+        snapshot = &snapshots->buffers[i];
+
+        free(snapshot->prev_x_pos);
+        free(snapshot->prev_y_pos);
+        free(snapshot->x_pos);
+        free(snapshot->y_pos);
+        free(snapshot->width);
+        free(snapshot->height);
+        free(snapshot->color);
+
+    }
+
+    memset(snapshots, 0, sizeof(snapshots_t));
+
+}
+
+// writer side. The buffer to fill next, with room for count bodies
+snapshot_t* snapshots_back(snapshots_t *snapshots, uint32_t count)
+{
+
+    snapshot_t *snapshot = &snapshots->buffers[snapshots->back];
+
+    if (count > snapshot->capacity)
+    {
+        snapshot->capacity   = count;
+        snapshot->prev_x_pos = realloc(snapshot->prev_x_pos, count * sizeof(float));
+        snapshot->prev_y_pos = realloc(snapshot->prev_y_pos, count * sizeof(float));
+        snapshot->x_pos      = realloc(snapshot->x_pos,      count * sizeof(float));
+        snapshot->y_pos      = realloc(snapshot->y_pos,      count * sizeof(float));
+        snapshot->width      = realloc(snapshot->width,      count * sizeof(float));
+        snapshot->height     = realloc(snapshot->height,     count * sizeof(float));
+        snapshot->color      = realloc(snapshot->color,      count * sizeof(uint32_t));
+    }
+
+    snapshot->count = count;
+
+    return snapshot;
+
+}
+
+// writer side. Hands the filled back buffer over and takes the middle one to fill next, whether or
+// not the reader got to it
+void snapshots_publish(snapshots_t *snapshots)
+{
+    snapshots->back = SDL_AtomicSet(&snapshots->middle, snapshots->back | SNAPSHOTS_FRESH) & ~SNAPSHOTS_FRESH;
+}
+
+// reader side. Takes the newest published snapshot if there's one it hasn't drawn. The snapshot
+// stays untouched until the next call
+const snapshot_t* snapshots_latest(snapshots_t *snapshots)
+{
+
+    if (SDL_AtomicGet(&snapshots->middle) & SNAPSHOTS_FRESH)
+    {
+        snapshots->front = SDL_AtomicSet(&snapshots->middle, snapshots->front) & ~SNAPSHOTS_FRESH;
+    }
+
+    return &snapshots->buffers[snapshots->front];
+
+}
@@ -0,0 +1,734 @@
+/*
+ *  softraster.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <math.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define SOFTRASTER_X86_SIMD 1
+#else
+#define SOFTRASTER_X86_SIMD 0
+#endif
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/workers.h"
+#include "../inc/softraster.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// the pixels a tile covers, or the part of one a shape is drawn into
+typedef struct softraster_tile_t
+{
+
+    uint32_t            first_x, first_y, last_x, last_y;
+
+} softraster_tile_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+static softraster_shape_t* softraster_push(softraster_t *raster);
+static void softraster_reserve_chunks(softraster_t *raster, uint32_t chunks);
+static void softraster_reserve_bins(softraster_t *raster, uint32_t count);
+static void softraster_push_line(softraster_t *raster, float x0, float y0, float x1, float y1, uint32_t color);
+static bool softraster_span(float low, float high, uint32_t min, uint32_t max, uint32_t *first, uint32_t *last);
+static bool softraster_cells(float low, float high, uint32_t max, uint32_t *first, uint32_t *last);
+static void softraster_blend(uint32_t *pixel, uint32_t color, float coverage);
+
+static void softraster_count_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void softraster_scatter_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void softraster_tile_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+
+static void softraster_draw_box(const softraster_t *raster, const softraster_shape_t *shape, const softraster_tile_t *tile);
+static void softraster_draw_line_shape(const softraster_t *raster, const softraster_shape_t *shape, const softraster_tile_t *tile);
+static void softraster_draw_circle(const softraster_t *raster, const softraster_shape_t *shape, const softraster_tile_t *tile);
+
+static void softraster_select_fill(softraster_t *raster);
+static void softraster_fill_scalar(uint32_t *pixels, uint32_t count, uint32_t color);
+
+#if (SOFTRASTER_X86_SIMD)
+static void softraster_fill_sse2(uint32_t *pixels, uint32_t count, uint32_t color);
+static void softraster_fill_avx2(uint32_t *pixels, uint32_t count, uint32_t color);
+#endif
+
+/* ---------------------------------------------------------------------------------------- */
+
+void softraster_init(softraster_t *raster, uint32_t width, uint32_t height, float scale, workers_t *workers)
+{
+
+    memset(raster, 0, sizeof(softraster_t));
+
+    raster->width     = width;
+    raster->height    = height;
+    raster->pixels    = calloc((size_t)width * height, sizeof(uint32_t));
+    raster->scale     = scale;
+    raster->workers   = workers;
+
+    raster->tiles_x   = (width + SOFTRASTER_TILE_SIZE - 1) / SOFTRASTER_TILE_SIZE;
+    raster->tiles_y   = (height + SOFTRASTER_TILE_SIZE - 1) / SOFTRASTER_TILE_SIZE;
+    raster->bin_start = calloc(raster->tiles_x * raster->tiles_y + 1, sizeof(uint32_t));
+
+    softraster_select_fill(raster);
+
+}
+
+void softraster_destroy(softraster_t *raster)
+{
+
+    free(raster->pixels);
+    free(raster->shapes);
+    free(raster->histograms);
+    free(raster->bin_start);
+    free(raster->bins);
+
+    memset(raster, 0, sizeof(softraster_t));
+
+}
+
+// starts recording a frame that begins as one color
+void softraster_begin(softraster_t *raster, uint32_t clear)
+{
+    raster->clear       = clear;
+    raster->shape_count = 0;
+}
+
+// records a rectangle filling the pixels whose centers lie inside it, ignoring the color's alpha
+void softraster_fill_rect(softraster_t *raster, float x, float y, float w, float h, uint32_t color)
+{
+
+    uint32_t first_x, last_x, first_y, last_y;
+    softraster_shape_t *shape;
+
+    if (!softraster_span(x * raster->scale, (x + w) * raster->scale, 0, raster->width - 1, &first_x, &last_x) ||
+        !softraster_span(y * raster->scale, (y + h) * raster->scale, 0, raster->height - 1, &first_y, &last_y))
+    {
+        return;
+    }
+
+    shape = softraster_push(raster);
+    *shape = (softraster_shape_t){ SOFTRASTER_BOX, color, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, first_x, first_y, last_x, last_y };
+
+}
+
+// records the one pixel outline of the pixels fill_rect would fill as four lines through the
+// centers of its edge pixels, ignoring the color's alpha
+void softraster_draw_rect(softraster_t *raster, float x, float y, float w, float h, uint32_t color)
+{
+
+    uint32_t first_x, last_x, first_y, last_y;
+    float left, right, top, bottom;
+
+    if (!softraster_span(x * raster->scale, (x + w) * raster->scale, 0, raster->width - 1, &first_x, &last_x) ||
+        !softraster_span(y * raster->scale, (y + h) * raster->scale, 0, raster->height - 1, &first_y, &last_y))
+    {
+        return;
+    }
+
+    left   = first_x + 0.5f;
+    right  = last_x + 0.5f;
+    top    = first_y + 0.5f;
+    bottom = last_y + 0.5f;
+
+    softraster_push_line(raster, left, top, right, top, color);
+
+    if (first_y == last_y)
+    {
+        return;
+    }
+
+    softraster_push_line(raster, left, bottom, right, bottom, color);
+    softraster_push_line(raster, left, top, left, bottom, color);
+
+    if (first_x != last_x)
+    {
+        softraster_push_line(raster, right, top, right, bottom, color);
+    }
+
+}
+
+// records a one pixel wide line between two points, ignoring the color's alpha
+void softraster_draw_line(softraster_t *raster, float x0, float y0, float x1, float y1, uint32_t color)
+{
+    softraster_push_line(raster, x0 * raster->scale, y0 * raster->scale, x1 * raster->scale, y1 * raster->scale, color);
+}
+
+// records an anti-aliased disc, bounded by the pixels within half a pixel of its edge
+void softraster_fill_circle(softraster_t *raster, float x, float y, float radius, uint32_t color)
+{
+
+    uint32_t first_x, last_x, first_y, last_y;
+    softraster_shape_t *shape;
+
+    x      *= raster->scale;
+    y      *= raster->scale;
+    radius *= raster->scale;
+
+    if (!softraster_span(x - radius - 0.5f, x + radius + 0.5f, 0, raster->width - 1, &first_x, &last_x) ||
+        !softraster_span(y - radius - 0.5f, y + radius + 0.5f, 0, raster->height - 1, &first_y, &last_y))
+    {
+        return;
+    }
+
+    shape = softraster_push(raster);
+    *shape = (softraster_shape_t){ SOFTRASTER_CIRCLE, color, x, y, radius, 0.0f, 0.0f, first_x, first_y, last_x, last_y };
+
+}
+
+// bins the recorded shapes into tiles and draws every tile across the workers
+void softraster_end(softraster_t *raster)
+{
+
+    const uint32_t tiles  = raster->tiles_x * raster->tiles_y;
+    const uint32_t chunks = (raster->shape_count + SOFTRASTER_GRAIN - 1) / SOFTRASTER_GRAIN;
+    uint32_t *h, start = 0, total;
+
+    softraster_reserve_chunks(raster, chunks);
+
+    if (raster->shape_count)
+    {
+        workers_parallel_for(raster->workers, raster->shape_count, SOFTRASTER_GRAIN, softraster_count_job, raster);
+    }
+
+    // tile by tile, each chunk writes after the chunks before it, so a bin keeps the drawing order
+    for (uint32_t t = 0; t < tiles; t++)
+    {
+
+        raster->bin_start[t] = start;
+
+        for (uint32_t c = 0; c < chunks; c++)
+        {
+            h      = &raster->histograms[c * tiles + t];
+            total  = *h;
+            *h     = start;
+            start += total;
+        }
+
+    }
+
+    raster->bin_start[tiles] = start;
+
+    softraster_reserve_bins(raster, start);
+
+    if (raster->shape_count)
+    {
+        workers_parallel_for(raster->workers, raster->shape_count, SOFTRASTER_GRAIN, softraster_scatter_job, raster);
+    }
+
+    workers_parallel_for(raster->workers, tiles, 1, softraster_tile_job, raster);
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// adds a shape to the frame for the caller to fill in
+static softraster_shape_t* softraster_push(softraster_t *raster)
+{
+
+    if (raster->shape_count == raster->shape_capacity)
+    {
+        raster->shape_capacity = SDL_max(raster->shape_capacity * 2, SOFTRASTER_MIN_SHAPES);
+        raster->shapes         = realloc(raster->shapes, raster->shape_capacity * sizeof(softraster_shape_t));
+    }
+
+    return &raster->shapes[raster->shape_count++];
+
+}
+
+static void softraster_reserve_chunks(softraster_t *raster, uint32_t chunks)
+{
+
+    if (chunks > raster->chunk_capacity)
+    {
+        raster->chunk_capacity = chunks;
+        raster->histograms     = realloc(raster->histograms, chunks * raster->tiles_x * raster->tiles_y * sizeof(uint32_t));
+    }
+
+}
+
+static void softraster_reserve_bins(softraster_t *raster, uint32_t count)
+{
+
+    if (count > raster->bin_capacity)
+    {
+        raster->bin_capacity = SDL_max(count, SDL_max(raster->bin_capacity * 2, SOFTRASTER_MIN_SHAPES));
+        raster->bins         = realloc(raster->bins, raster->bin_capacity * sizeof(uint32_t));
+    }
+
+}
+
+// records a line given in pixels, bounded by the columns whose centers lie between its ends and
+// the rows those reach, or the other way around when it's steep. A line with both ends in one
+// place is the pixel under them
+static void softraster_push_line(softraster_t *raster, float x0, float y0, float x1, float y1, uint32_t color)
+{
+
+    const float low_x  = SDL_min(x0, x1), high_x = SDL_max(x0, x1);
+    const float low_y  = SDL_min(y0, y1), high_y = SDL_max(y0, y1);
+    uint32_t first_x, last_x, first_y, last_y;
+    softraster_shape_t *shape;
+    bool in;
+
+    if (x0 == x1 && y0 == y1)
+    {
+        in = softraster_cells(x0, x0, raster->width - 1, &first_x, &last_x) &&
+             softraster_cells(y0, y0, raster->height - 1, &first_y, &last_y);
+    }
+    else if (high_x - low_x >= high_y - low_y)
+    {
+        in = softraster_span(low_x, high_x, 0, raster->width - 1, &first_x, &last_x) &&
+             softraster_cells(low_y, high_y, raster->height - 1, &first_y, &last_y);
+    }
+    else
+    {
+        in = softraster_cells(low_x, high_x, raster->width - 1, &first_x, &last_x) &&
+             softraster_span(low_y, high_y, 0, raster->height - 1, &first_y, &last_y);
+    }
+
+    if (!in)
+    {
+        return;
+    }
+
+    shape = softraster_push(raster);
+    *shape = (softraster_shape_t){ SOFTRASTER_LINE, color, x0, y0, 0.0f, x1, y1, first_x, first_y, last_x, last_y };
+
+}
+
+// the pixels whose centers lie within [low, high], clipped to [min, max]. Returns false if none do
+static bool softraster_span(float low, float high, uint32_t min, uint32_t max, uint32_t *first, uint32_t *last)
+{
+
+    const float lowest  = ceilf(low - 0.5f);
+    const float highest = floorf(high - 0.5f);
+
+    if (highest < (float)min || lowest > (float)max || lowest > highest)
+    {
+        return false;
+    }
+
+    *first = (uint32_t)SDL_max(lowest, (float)min);
+    *last  = (uint32_t)SDL_min(highest, (float)max);
+
+    return true;
+
+}
+
+// the pixels [low, high] passes through, clipped to [0, max]. Returns false if none are in it
+static bool softraster_cells(float low, float high, uint32_t max, uint32_t *first, uint32_t *last)
+{
+
+    const float lowest  = floorf(low);
+    const float highest = floorf(high);
+
+    if (highest < 0.0f || lowest > (float)max)
+    {
+        return false;
+    }
+
+    *first = (uint32_t)SDL_max(lowest, 0.0f);
+    *last  = (uint32_t)SDL_min(highest, (float)max);
+
+    return true;
+
+}
+
+// mixes color into the pixel by the coverage times the color's alpha. The pixel is opaque
+// afterwards if it was before
+static void softraster_blend(uint32_t *pixel, uint32_t color, float coverage)
+{
+
+    const uint32_t dst = *pixel;
+    uint32_t a, out = 0;
+
+    coverage = SDL_clamp(coverage, 0.0f, 1.0f);
+    a        = (uint32_t)(coverage * (color & 0xFF) + 0.5f);
+
+    if (a == 0)
+    {
+        return;
+    }
+
+    for (uint32_t shift = 8; shift < 32; shift += 8)
+    {
+        out |= ((((color >> shift) & 0xFF) * a + ((dst >> shift) & 0xFF) * (255 - a) + 127) / 255) << shift;
+    }
+
+    *pixel = out | (a + (dst & 0xFF) * (255 - a) / 255);
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// counts the shapes each chunk puts in each tile, a range can span several chunks when it isn't split
+static void softraster_count_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    softraster_t *raster = context;
+    const uint32_t tiles = raster->tiles_x * raster->tiles_y;
+    const softraster_shape_t *shape;
+    uint32_t chunk_end, *h;
+
+    for (; begin < end; begin = chunk_end)
+    {
+
+        chunk_end = SDL_min(begin + SOFTRASTER_GRAIN, end);
+        h = &raster->histograms[(begin / SOFTRASTER_GRAIN) * tiles];
+
+        memset(h, 0, tiles * sizeof(uint32_t));
+
+        for (uint32_t i = begin; i < chunk_end; i++)
+        {
+
+            shape = &raster->shapes[i];
+
+            for (uint32_t ty = shape->first_y / SOFTRASTER_TILE_SIZE; ty <= shape->last_y / SOFTRASTER_TILE_SIZE; ty++)
+            {
+                for (uint32_t tx = shape->first_x / SOFTRASTER_TILE_SIZE; tx <= shape->last_x / SOFTRASTER_TILE_SIZE; tx++)
+                {
+                    h[ty * raster->tiles_x + tx]++;
+                }
+            }
+
+        }
+
+    }
+
+}
+
+// writes each shape into the bin of every tile it touches, where its chunk's counts say
+static void softraster_scatter_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    softraster_t *raster = context;
+    const uint32_t tiles = raster->tiles_x * raster->tiles_y;
+    const softraster_shape_t *shape;
+    uint32_t chunk_end, *h;
+
+    for (; begin < end; begin = chunk_end)
+    {
+
+        chunk_end = SDL_min(begin + SOFTRASTER_GRAIN, end);
+        h = &raster->histograms[(begin / SOFTRASTER_GRAIN) * tiles];
+
+        for (uint32_t i = begin; i < chunk_end; i++)
+        {
+
+            shape = &raster->shapes[i];
+
+            for (uint32_t ty = shape->first_y / SOFTRASTER_TILE_SIZE; ty <= shape->last_y / SOFTRASTER_TILE_SIZE; ty++)
+            {
+                for (uint32_t tx = shape->first_x / SOFTRASTER_TILE_SIZE; tx <= shape->last_x / SOFTRASTER_TILE_SIZE; tx++)
+                {
+                    raster->bins[h[ty * raster->tiles_x + tx]++] = i;
+                }
+            }
+
+        }
+
+    }
+
+}
+
+// clears each tile and draws its bin into it
+static void softraster_tile_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    softraster_t *raster = context;
+    const softraster_shape_t *shape;
+    softraster_tile_t tile;
+
+    for (uint32_t t = begin; t < end; t++)
+    {
+
+        tile.first_x = (t % raster->tiles_x) * SOFTRASTER_TILE_SIZE;
+        tile.first_y = (t / raster->tiles_x) * SOFTRASTER_TILE_SIZE;
+        tile.last_x  = SDL_min(tile.first_x + SOFTRASTER_TILE_SIZE, raster->width) - 1;
+        tile.last_y  = SDL_min(tile.first_y + SOFTRASTER_TILE_SIZE, raster->height) - 1;
+
+        for (uint32_t y = tile.first_y; y <= tile.last_y; y++)
+        {
+            raster->fill(&raster->pixels[y * raster->width + tile.first_x], tile.last_x - tile.first_x + 1, raster->clear);
+        }
+
+        for (uint32_t k = raster->bin_start[t]; k < raster->bin_start[t + 1]; k++)
+        {
+
+            shape = &raster->shapes[raster->bins[k]];
+
+            switch (shape->kind)
+            {
+
+                case SOFTRASTER_BOX:
+                    softraster_draw_box(raster, shape, &tile);
+                    break;
+
+                case SOFTRASTER_LINE:
+                    softraster_draw_line_shape(raster, shape, &tile);
+                    break;
+
+                case SOFTRASTER_CIRCLE:
+                    softraster_draw_circle(raster, shape, &tile);
+                    break;
+
+            }
+
+        }
+
+    }
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+static void softraster_draw_box(const softraster_t *raster, const softraster_shape_t *shape, const softraster_tile_t *tile)
+{
+
+    const uint32_t first_x = SDL_max(shape->first_x, tile->first_x), last_x = SDL_min(shape->last_x, tile->last_x);
+    const uint32_t first_y = SDL_max(shape->first_y, tile->first_y), last_y = SDL_min(shape->last_y, tile->last_y);
+
+    if (first_x > last_x)
+    {
+        return;
+    }
+
+    for (uint32_t y = first_y; y <= last_y; y++)
+    {
+        raster->fill(&raster->pixels[y * raster->width + first_x], last_x - first_x + 1, shape->color);
+    }
+
+}
+
+// walks the columns of a shallow line, or the rows of a steep one, that lie in the tile, and sets
+// the pixel the line crosses the middle of each in. Where it crosses only depends on the line, so
+// neighbouring tiles agree on the pixels along their edge
+static void softraster_draw_line_shape(const softraster_t *raster, const softraster_shape_t *shape, const softraster_tile_t *tile)
+{
+
+    const uint32_t first_x = SDL_max(shape->first_x, tile->first_x), last_x = SDL_min(shape->last_x, tile->last_x);
+    const uint32_t first_y = SDL_max(shape->first_y, tile->first_y), last_y = SDL_min(shape->last_y, tile->last_y);
+    const float dx = shape->end_x - shape->x, dy = shape->end_y - shape->y;
+    float slope, at;
+
+    if (first_x > last_x || first_y > last_y)
+    {
+        return;
+    }
+
+    if (dx == 0.0f && dy == 0.0f)
+    {
+        raster->pixels[first_y * raster->width + first_x] = shape->color;
+    }
+    else if (fabsf(dx) >= fabsf(dy))
+    {
+
+        slope = dy / dx;
+
+        for (uint32_t c = first_x; c <= last_x; c++)
+        {
+
+            at = floorf(shape->y + (c + 0.5f - shape->x) * slope);
+
+            if (at >= (float)first_y && at <= (float)last_y)
+            {
+                raster->pixels[(uint32_t)at * raster->width + c] = shape->color;
+            }
+
+        }
+
+    }
+    else
+    {
+
+        slope = dx / dy;
+
+        for (uint32_t r = first_y; r <= last_y; r++)
+        {
+
+            at = floorf(shape->x + (r + 0.5f - shape->y) * slope);
+
+            if (at >= (float)first_x && at <= (float)last_x)
+            {
+                raster->pixels[r * raster->width + (uint32_t)at] = shape->color;
+            }
+
+        }
+
+    }
+
+}
+
+// a pixel is covered by radius + 1/2 minus the distance to its center, clamped to [0, 1], so each
+// row is a solid span between the pixels within half a pixel of the edge
+static void softraster_draw_circle(const softraster_t *raster, const softraster_shape_t *shape, const softraster_tile_t *tile)
+{
+
+    const bool opaque  = (shape->color & 0xFF) == 0xFF;
+    const float x      = shape->x, y = shape->y, radius = shape->radius;
+    const float outer  = radius + 0.5f;
+    const float inner  = radius - 0.5f;
+    const uint32_t first_y = SDL_max(shape->first_y, tile->first_y), last_y = SDL_min(shape->last_y, tile->last_y);
+    uint32_t first, last, solid_first, solid_last, *row;
+    float dx, dy, half;
+
+    for (uint32_t r = first_y; r <= last_y; r++)
+    {
+
+        row = &raster->pixels[r * raster->width];
+        dy  = r + 0.5f - y;
+
+        // every pixel with any coverage
+        if (dy * dy >= outer * outer)
+        {
+            continue;
+        }
+
+        half = sqrtf(outer * outer - dy * dy);
+
+        if (!softraster_span(x - half, x + half, tile->first_x, tile->last_x, &first, &last))
+        {
+            continue;
+        }
+
+        // the covered pixels in between, none if the row only grazes the disc
+        solid_first = last + 1;
+        solid_last  = last;
+
+        if (inner > 0.0f && dy * dy < inner * inner)
+        {
+
+            half = sqrtf(inner * inner - dy * dy);
+
+            if (!softraster_span(x - half, x + half, tile->first_x, tile->last_x, &solid_first, &solid_last))
+            {
+                solid_first = last + 1;
+                solid_last  = last;
+            }
+
+        }
+
+        for (uint32_t c = first; c < solid_first; c++)
+        {
+            dx = c + 0.5f - x;
+            softraster_blend(&row[c], shape->color, outer - sqrtf(dx * dx + dy * dy));
+        }
+
+        if (opaque)
+        {
+            raster->fill(&row[solid_first], solid_last + 1 - solid_first, shape->color);
+        }
+        else
+        {
+            for (uint32_t c = solid_first; c <= solid_last; c++)
+            {
+                softraster_blend(&row[c], shape->color, 1.0f);
+            }
+        }
+
+        for (uint32_t c = solid_last + 1; c <= last; c++)
+        {
+            dx = c + 0.5f - x;
+            softraster_blend(&row[c], shape->color, outer - sqrtf(dx * dx + dy * dy));
+        }
+
+    }
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// picks the widest span fill this CPU can run
+static void softraster_select_fill(softraster_t *raster)
+{
+
+    #if (SOFTRASTER_X86_SIMD)
+    {
+        if (SDL_HasAVX2())
+        {
+            raster->fill      = softraster_fill_avx2;
+            raster->fill_name = "avx2";
+            return;
+        }
+
+        if (SDL_HasSSE2())
+        {
+            raster->fill      = softraster_fill_sse2;
+            raster->fill_name = "sse2";
+            return;
+        }
+    }
+    #endif
+
+    raster->fill      = softraster_fill_scalar;
+    raster->fill_name = "scalar";
+
+}
+
+static void softraster_fill_scalar(uint32_t *pixels, uint32_t count, uint32_t color)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pixels[i] = color;
+    }
+}
+
+#if (SOFTRASTER_X86_SIMD)
+
+/*
+ *  The wide fills finish a span with one more store ending on its last pixel, overlapping what's
+ *  already written with the same color instead of looping over the remainder. Spans shorter than
+ *  a register take the next narrower path.
+ */
+
+__attribute__((target("sse2")))
+static void softraster_fill_sse2(uint32_t *pixels, uint32_t count, uint32_t color)
+{
+
+    const __m128i c = _mm_set1_epi32((int)color);
+
+    if (count < 4)
+    {
+        softraster_fill_scalar(pixels, count, color);
+        return;
+    }
+
+    for (uint32_t i = 0; i + 4 < count; i += 4)
+    {
+        _mm_storeu_si128((__m128i*)&pixels[i], c);
+    }
+
+    _mm_storeu_si128((__m128i*)&pixels[count - 4], c);
+
+}
+
+__attribute__((target("avx2")))
+static void softraster_fill_avx2(uint32_t *pixels, uint32_t count, uint32_t color)
+{
+
+    const __m256i c = _mm256_set1_epi32((int)color);
+
+    if (count < 8)
+    {
+        softraster_fill_sse2(pixels, count, color);
+        return;
+    }
+
+    for (uint32_t i = 0; i + 8 < count; i += 8)
+    {
+        _mm256_storeu_si256((__m256i*)&pixels[i], c);
+    }
+
+    _mm256_storeu_si256((__m256i*)&pixels[count - 8], c);
+
+    // the blending around it is SSE code, which stalls on dirty upper halves
+    _mm256_zeroupper();
+
+}
+
+#endif
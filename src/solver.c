@@ -0,0 +1,809 @@
+/*
+ *  solver.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <math.h>
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/bodystore.h"
+#include "../inc/collisions.h"
+#include "../inc/workers.h"
+#include "../inc/solver.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// what a range of a solver pass needs, handed to the workers
+typedef struct solver_job_t
+{
+
+    solver_t            *solver;
+    bodystore_t         *bodies;
+    contactlist_t       *contacts;
+    uint32_t            offset;                                 // first contact of the color being swept
+    float               *x, *y;                                 // arrays a jacobi gather adds into
+
+} solver_job_t;
+
+static void solver_reserve(solver_t *solver, const bodystore_t *bodies, const contactlist_t *contacts);
+static void solver_color(solver_t *solver, const bodystore_t *bodies, contactlist_t *contacts);
+static void solver_build_adjacency(solver_t *solver, const bodystore_t *bodies, const contactlist_t *contacts);
+static void solver_run(solver_t *solver, solver_job_t *job, workers_range_t range);
+static float solver_reduce_residual(solver_t *solver);
+
+static void solver_prepare(solver_t *solver, bodystore_t *bodies, const contactlist_t *contacts, uint32_t begin, uint32_t end);
+static void solver_warm_start(solver_t *solver, bodystore_t *bodies, const contactlist_t *contacts, uint32_t begin, uint32_t end);
+static float solver_iterate(solver_t *solver, bodystore_t *bodies, contactlist_t *contacts, uint32_t begin, uint32_t end);
+static void solver_correct_positions(solver_t *solver, bodystore_t *bodies, const contactlist_t *contacts, uint32_t begin, uint32_t end);
+static void solver_apply(bodystore_t *bodies, const contact_t *contact, const solver_constraint_t *c, float normal_impulse, float tangent_impulse);
+
+static void solver_prepare_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void solver_warm_start_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void solver_iterate_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void solver_correct_positions_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+
+static void solver_jacobi_warm_start_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void solver_jacobi_iterate_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void solver_jacobi_correct_positions_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+static void solver_jacobi_gather_job(uint32_t begin, uint32_t end, uint32_t worker, void *context);
+
+/* ---------------------------------------------------------------------------------------- */
+
+// workers may be NULL for the sequential mode, the parallel modes then run on the calling thread
+void solver_init(solver_t *solver, uint32_t iterations, solver_mode_t mode, workers_t *workers)
+{
+
+    memset(solver, 0, sizeof(solver_t));
+
+    solver->iterations = iterations;
+    solver->mode       = mode;
+    solver->workers    = workers;
+
+}
+
+void solver_destroy(solver_t *solver)
+{
+
+    free(solver->constraints);
+    free(solver->scratch);
+    free(solver->contact_colors);
+    free(solver->impulse_x);
+    free(solver->impulse_y);
+    free(solver->body_contacts);
+    free(solver->body_colors);
+    free(solver->body_start);
+
+    memset(solver, 0, sizeof(solver_t));
+
+}
+
+// resolves every contact: warm starts from the impulses the contacts carry in, iterates until the
+// impulses settle or the budget runs out, then pushes out what's left of the overlap. The
+// impulses each contact ends up with are left on it for the contact cache. The colored mode
+// reorders the contacts by color
+void solver_solve(solver_t *solver, bodystore_t *bodies, contactlist_t *contacts)
+{
+
+    solver_job_t job = { solver, bodies, contacts, 0, NULL, NULL };
+    bool parallel = solver->mode != SOLVER_SEQUENTIAL && solver->workers != NULL;
+
+    solver->iterations_used = 0;
+    solver->residual        = 0.0f;
+    solver->color_count     = 0;
+
+    if (contacts->count == 0)
+    {
+        return;
+    }
+
+    solver_reserve(solver, bodies, contacts);
+
+    if (solver->mode == SOLVER_COLORED)
+    {
+        solver_color(solver, bodies, contacts);
+    }
+    else if (solver->mode == SOLVER_JACOBI)
+    {
+        solver_build_adjacency(solver, bodies, contacts);
+    }
+
+    // constraints only read velocities the step started with, so they can all be built at once
+    if (parallel)
+    {
+        workers_parallel_for(solver->workers, contacts->count, SOLVER_GRAIN, solver_prepare_job, &job);
+    }
+    else
+    {
+        solver_prepare(solver, bodies, contacts, 0, contacts->count);
+    }
+
+    switch (solver->mode)
+    {
+
+        case SOLVER_COLORED:
+
+            solver_run(solver, &job, solver_warm_start_job);
+
+            while (solver->iterations_used < solver->iterations)
+            {
+
+                memset(solver->worker_residual, 0, sizeof(solver->worker_residual));
+                solver_run(solver, &job, solver_iterate_job);
+
+                solver->residual = solver_reduce_residual(solver);
+                solver->iterations_used++;
+
+                if (solver->residual < SOLVER_TOLERANCE)
+                {
+                    break;
+                }
+
+            }
+
+            solver_run(solver, &job, solver_correct_positions_job);
+
+            break;
+
+        case SOLVER_JACOBI:
+
+            job.x = bodies->x_vel;
+            job.y = bodies->y_vel;
+
+            solver_run(solver, &job, solver_jacobi_warm_start_job);
+            solver_run(solver, &job, solver_jacobi_gather_job);
+
+            while (solver->iterations_used < solver->iterations)
+            {
+
+                memset(solver->worker_residual, 0, sizeof(solver->worker_residual));
+                solver_run(solver, &job, solver_jacobi_iterate_job);
+                solver_run(solver, &job, solver_jacobi_gather_job);
+
+                solver->residual = solver_reduce_residual(solver);
+                solver->iterations_used++;
+
+                if (solver->residual < SOLVER_TOLERANCE)
+                {
+                    break;
+                }
+
+            }
+
+            job.x = bodies->x_pos;
+            job.y = bodies->y_pos;
+
+            solver_run(solver, &job, solver_jacobi_correct_positions_job);
+            solver_run(solver, &job, solver_jacobi_gather_job);
+
+            break;
+
+        default:
+
+            solver_warm_start(solver, bodies, contacts, 0, contacts->count);
+
+            while (solver->iterations_used < solver->iterations)
+            {
+
+                solver->residual = solver_iterate(solver, bodies, contacts, 0, contacts->count);
+                solver->iterations_used++;
+
+                if (solver->residual < SOLVER_TOLERANCE)
+                {
+                    break;
+                }
+
+            }
+
+            solver_correct_positions(solver, bodies, contacts, 0, contacts->count);
+
+            break;
+
+    }
+
+}
+
+const char* solver_mode_name(solver_mode_t mode)
+{
+
+    switch (mode)
+    {
+        case SOLVER_SEQUENTIAL:     return "sequential";
+        case SOLVER_COLORED:        return "colored";
+        case SOLVER_JACOBI:         return "jacobi";
+        default:                    return "unknown";
+    }
+
+}
+
+// looks up a solver mode by the name solver_mode_name gives it, returns false if there's no match
+bool solver_parse_mode(const char *name, solver_mode_t *mode)
+{
+
+    for (solver_mode_t m = SOLVER_SEQUENTIAL; m <= SOLVER_JACOBI; m++)
+    {
+        if (!strcmp(name, solver_mode_name(m)))
+        {
+            *mode = m;
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// grows the per-contact and per-body arrays to fit this solve
+static void solver_reserve(solver_t *solver, const bodystore_t *bodies, const contactlist_t *contacts)
+{
+
+    if (contacts->count > solver->capacity)
+    {
+        solver->capacity       = SDL_max(contacts->count, SDL_max(solver->capacity * 2, SOLVER_MIN_CONSTRAINTS));
+        solver->constraints    = realloc(solver->constraints,    solver->capacity * sizeof(solver_constraint_t));
+        solver->scratch        = realloc(solver->scratch,        solver->capacity * sizeof(contact_t));
+        solver->contact_colors = realloc(solver->contact_colors, solver->capacity * sizeof(uint8_t));
+        solver->impulse_x      = realloc(solver->impulse_x,      solver->capacity * sizeof(float));
+        solver->impulse_y      = realloc(solver->impulse_y,      solver->capacity * sizeof(float));
+        solver->body_contacts  = realloc(solver->body_contacts,  solver->capacity * 2 * sizeof(uint32_t));
+    }
+
+    if (bodies->count > solver->body_capacity)
+    {
+        solver->body_capacity = bodies->capacity;
+        solver->body_colors   = realloc(solver->body_colors, solver->body_capacity * sizeof(uint64_t));
+        solver->body_start    = realloc(solver->body_start,  (solver->body_capacity + 1) * sizeof(uint32_t));
+    }
+
+}
+
+// gives every contact the lowest color neither of its bodies takes part in yet, then sorts the
+// contacts by color so each color is one range. Contacts whose bodies have used up every color
+// go to the overflow range at the end
+static void solver_color(solver_t *solver, const bodystore_t *bodies, contactlist_t *contacts)
+{
+
+    uint64_t *body_colors = solver->body_colors;
+    uint32_t *color_start = solver->color_start;
+    const contact_t *contact;
+    uint64_t used;
+    uint32_t color, k, start;
+
+    memset(body_colors, 0, bodies->count * sizeof(uint64_t));
+    memset(color_start, 0, sizeof(solver->color_start));
+
+    for (k = 0; k < contacts->count; k++)
+    {
+
+        contact = &contacts->contacts[k];
+
+        // the border never moves, so border contacts only claim a color on their body
+        used = body_colors[contact->a];
+
+        if (contact->type != CONTACT_BORDER)
+        {
+            used |= body_colors[contact->b];
+        }
+
+        if (used == UINT64_MAX)
+        {
+            color = SOLVER_MAX_COLORS;
+        }
+        else
+        {
+
+            color = __builtin_ctzll(~used);
+
+            body_colors[contact->a] |= 1ull << color;
+
+            if (contact->type != CONTACT_BORDER)
+            {
+                body_colors[contact->b] |= 1ull << color;
+            }
+
+            solver->color_count = SDL_max(solver->color_count, color + 1);
+
+        }
+
+        solver->contact_colors[k] = (uint8_t)color;
+        color_start[color + 1]++;
+
+    }
+
+    for (color = 1; color <= SOLVER_MAX_COLORS + 1; color++)
+    {
+        color_start[color] += color_start[color - 1];
+    }
+
+    // stable counting sort, color_start[color] walks forward through its range and is put back after
+    for (k = 0; k < contacts->count; k++)
+    {
+        color = solver->contact_colors[k];
+        solver->scratch[color_start[color]++] = contacts->contacts[k];
+    }
+
+    start = 0;
+
+    for (color = 0; color <= SOLVER_MAX_COLORS; color++)
+    {
+        k = color_start[color];
+        color_start[color] = start;
+        start = k;
+    }
+
+    memcpy(contacts->contacts, solver->scratch, contacts->count * sizeof(contact_t));
+
+}
+
+// lists the contacts of every body, in contact order so each body always sums its impulses the
+// same way no matter how the work is split
+static void solver_build_adjacency(solver_t *solver, const bodystore_t *bodies, const contactlist_t *contacts)
+{
+
+    uint32_t *body_start = solver->body_start;
+    const contact_t *contact;
+    uint32_t i, k;
+
+    memset(body_start, 0, (bodies->count + 1) * sizeof(uint32_t));
+
+    for (k = 0; k < contacts->count; k++)
+    {
+
+        contact = &contacts->contacts[k];
+
+        body_start[contact->a + 1]++;
+
+        if (contact->type != CONTACT_BORDER)
+        {
+            body_start[contact->b + 1]++;
+        }
+
+    }
+
+    for (i = 1; i <= bodies->count; i++)
+    {
+        body_start[i] += body_start[i - 1];
+    }
+
+    // body_start[i] walks forward through body i's range, which leaves it where body i + 1 starts
+    for (k = 0; k < contacts->count; k++)
+    {
+
+        contact = &contacts->contacts[k];
+
+        solver->body_contacts[body_start[contact->a]++] = k << 1;
+
+        if (contact->type != CONTACT_BORDER)
+        {
+            solver->body_contacts[body_start[contact->b]++] = k << 1 | 1;
+        }
+
+    }
+
+    for (i = bodies->count; i > 0; i--)
+    {
+        body_start[i] = body_start[i - 1];
+    }
+
+    body_start[0] = 0;
+
+}
+
+// runs one pass of the colored or jacobi mode. Colors are swept one after another, each split
+// across the workers, the overflow on this thread. Jacobi passes over contacts or bodies in one go
+static void solver_run(solver_t *solver, solver_job_t *job, workers_range_t range)
+{
+
+    uint32_t color, total;
+
+    if (solver->mode == SOLVER_JACOBI)
+    {
+
+        job->offset = 0;
+        total = range == solver_jacobi_gather_job ? job->bodies->count : job->contacts->count;
+
+        if (solver->workers)
+        {
+            workers_parallel_for(solver->workers, total, SOLVER_GRAIN, range, job);
+        }
+        else
+        {
+            range(0, total, 0, job);
+        }
+
+        return;
+
+    }
+
+    for (color = 0; color < solver->color_count; color++)
+    {
+
+        job->offset = solver->color_start[color];
+        total = solver->color_start[color + 1] - job->offset;
+
+        if (solver->workers)
+        {
+            workers_parallel_for(solver->workers, total, SOLVER_GRAIN, range, job);
+        }
+        else
+        {
+            range(0, total, 0, job);
+        }
+
+    }
+
+    job->offset = solver->color_start[SOLVER_MAX_COLORS];
+    total = job->contacts->count - job->offset;
+
+    if (total)
+    {
+        range(0, total, 0, job);
+    }
+
+}
+
+// largest residual any worker saw this iteration
+static float solver_reduce_residual(solver_t *solver)
+{
+
+    float residual = 0.0f;
+
+    for (uint32_t w = 0; w < WORKERS_MAX; w++)
+    {
+        residual = SDL_max(residual, solver->worker_residual[w]);
+    }
+
+    return residual;
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// builds the constraints of contacts [begin, end) from the velocities the step started with
+static void solver_prepare(solver_t *solver, bodystore_t *bodies, const contactlist_t *contacts, uint32_t begin, uint32_t end)
+{
+
+    const uint32_t *body_start = solver->body_start;
+    const contact_t *contact;
+    solver_constraint_t *c;
+    uint32_t a, b, k, degree;
+    float vn, restitution;
+    bool border;
+
+    for (k = begin; k < end; k++)
+    {
+
+        contact = &contacts->contacts[k];
+        c       = &solver->constraints[k];
+
+        a      = contact->a;
+        b      = contact->b;
+        border = contact->type == CONTACT_BORDER;
+
+        // the border is an immovable body, it takes part with zero inverse mass and velocity
+        c->inv_mass_a = 1.0f / bodies->mass[a];
+        c->inv_mass_b = border ? 0.0f : 1.0f / bodies->mass[b];
+
+        // round bodies don't spin, so the effective mass is the same along any direction
+        c->normal_mass  = 1.0f / (c->inv_mass_a + c->inv_mass_b);
+        c->tangent_mass = c->normal_mass;
+
+        restitution = border ? bodies->restitution[a] : solver_mix_restitution(bodies->restitution[a], bodies->restitution[b]);
+        c->friction = border ? bodies->friction[a]    : solver_mix_friction(bodies->friction[a], bodies->friction[b]);
+
+        // restitution targets a separating speed from the approach speed before any impulse
+        vn = border ? -(bodies->x_vel[a] * contact->normal_x + bodies->y_vel[a] * contact->normal_y)
+                    : (bodies->x_vel[b] - bodies->x_vel[a]) * contact->normal_x + (bodies->y_vel[b] - bodies->y_vel[a]) * contact->normal_y;
+
+        c->bias = vn < -SOLVER_RESTITUTION_THRESHOLD ? -restitution * vn : 0.0f;
+
+        // a jacobi body gets every one of its contacts' impulses at once, each sized as if it were
+        // alone, so they're scaled down by how many contacts share the busier body
+        c->relaxation = 1.0f;
+
+        if (solver->mode == SOLVER_JACOBI)
+        {
+
+            degree = body_start[a + 1] - body_start[a];
+
+            if (!border)
+            {
+                degree = SDL_max(degree, body_start[b + 1] - body_start[b]);
+            }
+
+            c->relaxation = 1.0f / degree;
+
+        }
+
+    }
+
+}
+
+// applies the warm start impulses of contacts [begin, end). Only once every bias has seen the
+// velocities the step started with
+static void solver_warm_start(solver_t *solver, bodystore_t *bodies, const contactlist_t *contacts, uint32_t begin, uint32_t end)
+{
+
+    const contact_t *contact;
+
+    for (uint32_t k = begin; k < end; k++)
+    {
+        contact = &contacts->contacts[k];
+        solver_apply(bodies, contact, &solver->constraints[k], contact->normal_impulse, contact->tangent_impulse);
+    }
+
+}
+
+// one pass over contacts [begin, end), friction first so the normal impulse has the last word.
+// Returns the largest change in relative velocity any impulse made
+static float solver_iterate(solver_t *solver, bodystore_t *bodies, contactlist_t *contacts, uint32_t begin, uint32_t end)
+{
+
+    const float *x_vel = bodies->x_vel;
+    const float *y_vel = bodies->y_vel;
+
+    contact_t *contact;
+    const solver_constraint_t *c;
+    uint32_t a, b, k;
+    float rvx, rvy, vt, vn, total, limit, d_normal, d_tangent;
+    float residual = 0.0f;
+
+    for (k = begin; k < end; k++)
+    {
+
+        contact = &contacts->contacts[k];
+        c       = &solver->constraints[k];
+
+        a = contact->a;
+        b = contact->b;
+
+        rvx = contact->type == CONTACT_BORDER ? -x_vel[a] : x_vel[b] - x_vel[a];
+        rvy = contact->type == CONTACT_BORDER ? -y_vel[a] : y_vel[b] - y_vel[a];
+
+        // friction across the normal, the tangent being the normal turned a quarter counterclockwise.
+        // It can't exceed what the normal impulse pressing the bodies together allows
+        vt    = -rvx * contact->normal_y + rvy * contact->normal_x;
+        limit = c->friction * contact->normal_impulse;
+        total = SDL_clamp(contact->tangent_impulse - vt * c->tangent_mass, -limit, limit);
+        d_tangent    = total - contact->tangent_impulse;
+        contact->tangent_impulse = total;
+
+        // along the normal, the accumulated impulse may only ever push the bodies apart. The friction
+        // impulse is perpendicular to it and leaves vn alone
+        vn    = rvx * contact->normal_x + rvy * contact->normal_y;
+        total = SDL_max(contact->normal_impulse - (vn - c->bias) * c->normal_mass, 0.0f);
+        d_normal    = total - contact->normal_impulse;
+        contact->normal_impulse = total;
+
+        solver_apply(bodies, contact, c, d_normal, d_tangent);
+
+        residual = SDL_max(residual, (fabsf(d_normal) + fabsf(d_tangent)) * (c->inv_mass_a + c->inv_mass_b));
+
+    }
+
+    return residual;
+
+}
+
+// pushes a fraction of the overlap past the slop out of contacts [begin, end), split by inverse mass
+static void solver_correct_positions(solver_t *solver, bodystore_t *bodies, const contactlist_t *contacts, uint32_t begin, uint32_t end)
+{
+
+    const contact_t *contact;
+    const solver_constraint_t *c;
+    float correction;
+
+    for (uint32_t k = begin; k < end; k++)
+    {
+
+        contact = &contacts->contacts[k];
+        c       = &solver->constraints[k];
+
+        correction = SDL_max(contact->depth - SOLVER_CORRECTION_SLOP, 0.0f) * SOLVER_CORRECTION_FRACTION * c->normal_mass;
+
+        bodies->x_pos[contact->a] -= correction * c->inv_mass_a * contact->normal_x;
+        bodies->y_pos[contact->a] -= correction * c->inv_mass_a * contact->normal_y;
+
+        if (contact->type != CONTACT_BORDER)
+        {
+            bodies->x_pos[contact->b] += correction * c->inv_mass_b * contact->normal_x;
+            bodies->y_pos[contact->b] += correction * c->inv_mass_b * contact->normal_y;
+        }
+
+    }
+
+}
+
+// applies a normal and tangent impulse to a contact's bodies, pushing a back and b forward
+static void solver_apply(bodystore_t *bodies, const contact_t *contact, const solver_constraint_t *c, float normal_impulse, float tangent_impulse)
+{
+
+    float px = normal_impulse * contact->normal_x - tangent_impulse * contact->normal_y;
+    float py = normal_impulse * contact->normal_y + tangent_impulse * contact->normal_x;
+
+    bodies->x_vel[contact->a] -= px * c->inv_mass_a;
+    bodies->y_vel[contact->a] -= py * c->inv_mass_a;
+
+    if (contact->type != CONTACT_BORDER)
+    {
+        bodies->x_vel[contact->b] += px * c->inv_mass_b;
+        bodies->y_vel[contact->b] += py * c->inv_mass_b;
+    }
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// colored mode passes, [begin, end) is relative to the color being swept
+
+static void solver_prepare_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+    solver_job_t *job = context;
+    solver_prepare(job->solver, job->bodies, job->contacts, begin, end);
+}
+
+static void solver_warm_start_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+    solver_job_t *job = context;
+    solver_warm_start(job->solver, job->bodies, job->contacts, job->offset + begin, job->offset + end);
+}
+
+static void solver_iterate_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    solver_job_t *job = context;
+    float residual = solver_iterate(job->solver, job->bodies, job->contacts, job->offset + begin, job->offset + end);
+
+    job->solver->worker_residual[worker] = SDL_max(job->solver->worker_residual[worker], residual);
+
+}
+
+static void solver_correct_positions_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+    solver_job_t *job = context;
+    solver_correct_positions(job->solver, job->bodies, job->contacts, job->offset + begin, job->offset + end);
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// jacobi mode passes. Contact passes only write their own contact's impulse, the gather pass
+// then adds them to the bodies
+
+// the impulse each contact carried in, applied whole
+static void solver_jacobi_warm_start_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    solver_job_t *job = context;
+    solver_t *solver = job->solver;
+    const contact_t *contact;
+
+    for (uint32_t k = begin; k < end; k++)
+    {
+        contact = &job->contacts->contacts[k];
+        solver->impulse_x[k] = contact->normal_impulse * contact->normal_x - contact->tangent_impulse * contact->normal_y;
+        solver->impulse_y[k] = contact->normal_impulse * contact->normal_y + contact->tangent_impulse * contact->normal_x;
+    }
+
+}
+
+// the same impulses as solver_iterate, but every contact sees the velocities the pass started
+// with and applies only its relaxed share
+static void solver_jacobi_iterate_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    solver_job_t *job = context;
+    solver_t *solver = job->solver;
+    const float *x_vel = job->bodies->x_vel;
+    const float *y_vel = job->bodies->y_vel;
+
+    contact_t *contact;
+    const solver_constraint_t *c;
+    uint32_t a, b, k;
+    float rvx, rvy, vt, vn, total, limit, d_normal, d_tangent;
+    float residual = 0.0f;
+
+    for (k = begin; k < end; k++)
+    {
+
+        contact = &job->contacts->contacts[k];
+        c       = &solver->constraints[k];
+
+        a = contact->a;
+        b = contact->b;
+
+        rvx = contact->type == CONTACT_BORDER ? -x_vel[a] : x_vel[b] - x_vel[a];
+        rvy = contact->type == CONTACT_BORDER ? -y_vel[a] : y_vel[b] - y_vel[a];
+
+        vt    = -rvx * contact->normal_y + rvy * contact->normal_x;
+        limit = c->friction * contact->normal_impulse;
+        total = SDL_clamp(contact->tangent_impulse - c->relaxation * vt * c->tangent_mass, -limit, limit);
+        d_tangent    = total - contact->tangent_impulse;
+        contact->tangent_impulse = total;
+
+        vn    = rvx * contact->normal_x + rvy * contact->normal_y;
+        total = SDL_max(contact->normal_impulse - c->relaxation * (vn - c->bias) * c->normal_mass, 0.0f);
+        d_normal    = total - contact->normal_impulse;
+        contact->normal_impulse = total;
+
+        solver->impulse_x[k] = d_normal * contact->normal_x - d_tangent * contact->normal_y;
+        solver->impulse_y[k] = d_normal * contact->normal_y + d_tangent * contact->normal_x;
+
+        residual = SDL_max(residual, (fabsf(d_normal) + fabsf(d_tangent)) * (c->inv_mass_a + c->inv_mass_b));
+
+    }
+
+    solver->worker_residual[worker] = SDL_max(solver->worker_residual[worker], residual);
+
+}
+
+// each contact's overlap correction, gathered into positions the same way impulses are
+static void solver_jacobi_correct_positions_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    solver_job_t *job = context;
+    solver_t *solver = job->solver;
+    const contact_t *contact;
+    float correction;
+
+    for (uint32_t k = begin; k < end; k++)
+    {
+
+        contact    = &job->contacts->contacts[k];
+        correction = SDL_max(contact->depth - SOLVER_CORRECTION_SLOP, 0.0f) * SOLVER_CORRECTION_FRACTION * solver->constraints[k].normal_mass;
+
+        solver->impulse_x[k] = correction * contact->normal_x;
+        solver->impulse_y[k] = correction * contact->normal_y;
+
+    }
+
+}
+
+// adds the impulses of each body's contacts into job->x and job->y, pushing a back and b forward
+static void solver_jacobi_gather_job(uint32_t begin, uint32_t end, uint32_t worker, void *context)
+{
+
+    solver_job_t *job = context;
+    const solver_t *solver = job->solver;
+    const solver_constraint_t *c;
+    uint32_t i, e, entry, k;
+    float dx, dy;
+
+    for (i = begin; i < end; i++)
+    {
+
+        dx = 0.0f;
+        dy = 0.0f;
+
+        for (e = solver->body_start[i]; e < solver->body_start[i + 1]; e++)
+        {
+
+            entry = solver->body_contacts[e];
+            k     = entry >> 1;
+            c     = &solver->constraints[k];
+
+            if (entry & 1)
+            {
+                dx += solver->impulse_x[k] * c->inv_mass_b;
+                dy += solver->impulse_y[k] * c->inv_mass_b;
+            }
+            else
+            {
+                dx -= solver->impulse_x[k] * c->inv_mass_a;
+                dy -= solver->impulse_y[k] * c->inv_mass_a;
+            }
+
+        }
+
+        job->x[i] += dx;
+        job->y[i] += dy;
+
+    }
+
+}
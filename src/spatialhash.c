@@ -0,0 +1,230 @@
+/*
+ *  spatialhash.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <math.h>
+#include <string.h>
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/bodystore.h"
+#include "../inc/broadphase.h"
+#include "../inc/spatialhash.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define SPATIALHASH_MIN_TABLE 64                                // smallest bucket table the grid uses
+
+/* ---------------------------------------------------------------------------------------- */
+
+static void spatialhash_reserve(spatialhash_t *grid, uint32_t bodies, uint32_t entries, uint32_t table);
+static float spatialhash_cell_size(const bodystore_t *bodies);
+static uint32_t spatialhash_bucket(const spatialhash_t *grid, int32_t cx, int32_t cy);
+static uint64_t spatialhash_key(int32_t cx, int32_t cy);
+
+/* ---------------------------------------------------------------------------------------- */
+
+void spatialhash_init(spatialhash_t *grid)
+{
+    memset(grid, 0, sizeof(spatialhash_t));
+}
+
+void spatialhash_destroy(spatialhash_t *grid)
+{
+
+    free(grid->cell_x0);
+    free(grid->cell_y0);
+    free(grid->cell_x1);
+    free(grid->cell_y1);
+    free(grid->entry_body);
+    free(grid->entry_cell);
+    free(grid->bucket_start);
+
+    memset(grid, 0, sizeof(spatialhash_t));
+
+}
+
+// rebuilds the grid from the bodies' current positions, then reports every overlapping pair once
+void spatialhash_find_pairs(spatialhash_t *grid, const bodystore_t *bodies, broadphase_pairs_t *pairs)
+{
+
+    const float *x_pos  = bodies->x_pos;
+    const float *y_pos  = bodies->y_pos;
+    const float *width  = bodies->width;
+    const float *height = bodies->height;
+
+    uint32_t n = bodies->count;
+    uint32_t i, j, k, h, end, entries, table;
+    int32_t cx, cy;
+    uint64_t key;
+    float inv_cell;
+
+    pairs->count = 0;
+
+    if (n < 2)
+    {
+        return;
+    }
+
+    grid->cell_size = spatialhash_cell_size(bodies);
+    inv_cell = 1.0f / grid->cell_size;
+
+    spatialhash_reserve(grid, n, 0, 0);
+
+    // work out which cells each body covers, at most 2x2 since cells are as big as the largest body
+    entries = 0;
+    for (i = 0; i < n; i++)
+    {
+
+        grid->cell_x0[i] = (int32_t)floorf(x_pos[i] * inv_cell);
+        grid->cell_y0[i] = (int32_t)floorf(y_pos[i] * inv_cell);
+        grid->cell_x1[i] = (int32_t)floorf((x_pos[i] + width[i]) * inv_cell);
+        grid->cell_y1[i] = (int32_t)floorf((y_pos[i] + height[i]) * inv_cell);
+
+        entries += (uint32_t)(grid->cell_x1[i] - grid->cell_x0[i] + 1) * (uint32_t)(grid->cell_y1[i] - grid->cell_y0[i] + 1);
+
+    }
+
+    // keep the table at most half full so buckets stay short
+    table = SPATIALHASH_MIN_TABLE;
+    while (table < entries * 2) table <<= 1;
+
+    spatialhash_reserve(grid, n, entries, table);
+    grid->table_mask = table - 1;
+
+    // counting sort of (body, cell) entries by bucket: count, prefix sum, then scatter backwards
+    memset(grid->bucket_start, 0, (table + 1) * sizeof(uint32_t));
+
+    for (i = 0; i < n; i++)
+    {
+        for (cy = grid->cell_y0[i]; cy <= grid->cell_y1[i]; cy++)
+        {
+            for (cx = grid->cell_x0[i]; cx <= grid->cell_x1[i]; cx++)
+            {
+                grid->bucket_start[spatialhash_bucket(grid, cx, cy)]++;
+            }
+        }
+    }
+
+    for (h = 1; h < table; h++)
+    {
+        grid->bucket_start[h] += grid->bucket_start[h - 1];
+    }
+    grid->bucket_start[table] = entries;
+
+    // walking bodies in reverse leaves every bucket sorted by ascending body index
+    for (i = n; i-- > 0; )
+    {
+        for (cy = grid->cell_y1[i]; cy >= grid->cell_y0[i]; cy--)
+        {
+            for (cx = grid->cell_x1[i]; cx >= grid->cell_x0[i]; cx--)
+            {
+                k = --grid->bucket_start[spatialhash_bucket(grid, cx, cy)];
+                grid->entry_body[k] = i;
+                grid->entry_cell[k] = spatialhash_key(cx, cy);
+            }
+        }
+    }
+
+    // a pair shares up to four cells, it's only reported from the cell holding the min corner of the overlap
+    for (i = 0; i < n; i++)
+    {
+        for (cy = grid->cell_y0[i]; cy <= grid->cell_y1[i]; cy++)
+        {
+            for (cx = grid->cell_x0[i]; cx <= grid->cell_x1[i]; cx++)
+            {
+
+                h   = spatialhash_bucket(grid, cx, cy);
+                key = spatialhash_key(cx, cy);
+                end = grid->bucket_start[h + 1];
+
+                for (k = grid->bucket_start[h]; k < end; k++)
+                {
+
+                    j = grid->entry_body[k];
+
+                    if (j <= i || grid->entry_cell[k] != key) continue;
+
+                    if (cx != SDL_max(grid->cell_x0[i], grid->cell_x0[j])) continue;
+                    if (cy != SDL_max(grid->cell_y0[i], grid->cell_y0[j])) continue;
+
+                    if (x_pos[i] < x_pos[j] + width[j]  && x_pos[j] < x_pos[i] + width[i] &&
+                        y_pos[i] < y_pos[j] + height[j] && y_pos[j] < y_pos[i] + height[i])
+                    {
+                        broadphase_pairs_push(pairs, i, j);
+                    }
+
+                }
+
+            }
+        }
+    }
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// grows the per-body, per-entry and bucket arrays, never shrinks them
+static void spatialhash_reserve(spatialhash_t *grid, uint32_t bodies, uint32_t entries, uint32_t table)
+{
+
+    if (bodies > grid->body_capacity)
+    {
+        grid->body_capacity = bodies + bodies / 2;
+        grid->cell_x0 = realloc(grid->cell_x0, grid->body_capacity * sizeof(int32_t));
+        grid->cell_y0 = realloc(grid->cell_y0, grid->body_capacity * sizeof(int32_t));
+        grid->cell_x1 = realloc(grid->cell_x1, grid->body_capacity * sizeof(int32_t));
+        grid->cell_y1 = realloc(grid->cell_y1, grid->body_capacity * sizeof(int32_t));
+    }
+
+    if (entries > grid->entry_capacity)
+    {
+        grid->entry_capacity = entries + entries / 2;
+        grid->entry_body = realloc(grid->entry_body, grid->entry_capacity * sizeof(uint32_t));
+        grid->entry_cell = realloc(grid->entry_cell, grid->entry_capacity * sizeof(uint64_t));
+    }
+
+    if (table > grid->table_capacity)
+    {
+        grid->table_capacity = table;
+        grid->bucket_start = realloc(grid->bucket_start, (table + 1) * sizeof(uint32_t));
+    }
+
+}
+
+// cells are sized to the largest body extent so no body spans more than two cells per axis
+static float spatialhash_cell_size(const bodystore_t *bodies)
+{
+
+    float size = 1.0f;
+
+    for (uint32_t i = 0; i < bodies->count; i++)
+    {
+        if (bodies->width[i]  > size) size = bodies->width[i];
+        if (bodies->height[i] > size) size = bodies->height[i];
+    }
+
+    return size;
+
+}
+
+static uint32_t spatialhash_bucket(const spatialhash_t *grid, int32_t cx, int32_t cy)
+{
+
+    uint32_t h = ((uint32_t)cx * 0x9E3779B1u) ^ ((uint32_t)cy * 0x85EBCA77u);
+
+    h ^= h >> 15;
+
+    return h & grid->table_mask;
+
+}
+
+static uint64_t spatialhash_key(int32_t cx, int32_t cy)
+{
+    return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+}
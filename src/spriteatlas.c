@@ -0,0 +1,150 @@
+/*
+ *  spriteatlas.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <math.h>
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/spriteatlas.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+static void spriteatlas_rasterize(SDL_Surface *surface, int x, int y, int half, float radius);
+
+/* ---------------------------------------------------------------------------------------- */
+
+// packs the discs into rows, rasterizes them and uploads the result, returns false and leaves
+// the texture NULL if SDL couldn't make it
+bool spriteatlas_init(spriteatlas_t *atlas, SDL_Renderer *renderer)
+{
+
+    int x = 0, y = 0, row = 0, half, side;
+    int cells[SPRITEATLAS_SPRITES][3];
+    SDL_Surface *surface;
+    float radius;
+
+    memset(atlas, 0, sizeof(spriteatlas_t));
+
+    // every cell leaves at least one transparent pixel past the disc's soft edge
+    for (uint32_t k = 0; k < SPRITEATLAS_SPRITES; k++)
+    {
+
+        radius = (k + 1) * SPRITEATLAS_STEP;
+        half   = (int)ceilf(radius) + 1;
+        side   = 2 * half;
+
+        if (x + side > SPRITEATLAS_WIDTH)
+        {
+            x    = 0;
+            y   += row + SPRITEATLAS_GAP;
+            row  = 0;
+        }
+
+        cells[k][0] = x;
+        cells[k][1] = y;
+        cells[k][2] = half;
+
+        x  += side + SPRITEATLAS_GAP;
+        row = SDL_max(row, side);
+
+    }
+
+    atlas->width  = SPRITEATLAS_WIDTH;
+    atlas->height = y + row;
+
+    surface = SDL_CreateRGBSurfaceWithFormat(0, atlas->width, atlas->height, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!surface)
+    {
+        return false;
+    }
+
+    // white everywhere, the discs only write their coverage into the alpha
+    SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, 0xFF, 0xFF, 0xFF, 0x00));
+
+    for (uint32_t k = 0; k < SPRITEATLAS_SPRITES; k++)
+    {
+
+        spriteatlas_sprite_t *sprite = &atlas->sprites[k];
+
+        sprite->radius = (k + 1) * SPRITEATLAS_STEP;
+        sprite->extent = cells[k][2] / sprite->radius;
+        sprite->uv     = (SDL_FRect){ (float)cells[k][0] / atlas->width, (float)cells[k][1] / atlas->height,
+                                      2.0f * cells[k][2] / atlas->width, 2.0f * cells[k][2] / atlas->height };
+
+        spriteatlas_rasterize(surface, cells[k][0], cells[k][1], cells[k][2], sprite->radius);
+
+    }
+
+    atlas->texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+
+    if (!atlas->texture)
+    {
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(atlas->texture, SDL_ScaleModeLinear);
+
+    return true;
+
+}
+
+void spriteatlas_destroy(spriteatlas_t *atlas)
+{
+
+    if (atlas->texture)
+    {
+        SDL_DestroyTexture(atlas->texture);
+    }
+
+    memset(atlas, 0, sizeof(spriteatlas_t));
+
+}
+
+// the disc closest in size to the given radius, the largest one for anything bigger
+const spriteatlas_sprite_t* spriteatlas_find(const spriteatlas_t *atlas, float radius)
+{
+
+    const int k = (int)lroundf(radius / SPRITEATLAS_STEP) - 1;
+
+    return &atlas->sprites[SDL_clamp(k, 0, SPRITEATLAS_SPRITES - 1)];
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// writes a disc into the square cell of side 2 * half at (x, y). A pixel's alpha is how much of it
+// the disc covers, taken from how far its center is from the edge
+static void spriteatlas_rasterize(SDL_Surface *surface, int x, int y, int half, float radius)
+{
+
+    float dx, dy, coverage;
+    uint32_t *pixels;
+
+    for (int row = 0; row < 2 * half; row++)
+    {
+
+        pixels = (uint32_t*)((uint8_t*)surface->pixels + (y + row) * surface->pitch) + x;
+        dy     = row + 0.5f - half;
+
+        for (int column = 0; column < 2 * half; column++)
+        {
+
+            dx       = column + 0.5f - half;
+            coverage = SDL_clamp(radius + 0.5f - sqrtf(dx * dx + dy * dy), 0.0f, 1.0f);
+
+            pixels[column] = SDL_MapRGBA(surface->format, 0xFF, 0xFF, 0xFF, (uint8_t)lroundf(coverage * 255.0f));
+
+        }
+
+    }
+
+}
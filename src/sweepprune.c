@@ -0,0 +1,444 @@
+/*
+ *  sweepprune.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <string.h>
+
+#include "../inc/common.h"
+#include "../inc/bodystore.h"
+#include "../inc/broadphase.h"
+#include "../inc/pairmap.h"
+#include "../inc/sweepprune.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+#define SWEEPPRUNE_UNTRACKED UINT32_MAX
+
+#define SWEEPPRUNE_SLOT(id)   ((id) >> 1)
+#define SWEEPPRUNE_IS_MAX(id) ((id) & 1)
+
+#define SWEEPPRUNE_ALIVE    0x01                                // pair overlaps as of the latest swap
+#define SWEEPPRUNE_REPORTED 0x02                                // pair's begin has been reported
+
+/* ---------------------------------------------------------------------------------------- */
+
+// what sweepprune_emit_pair needs while walking the pair map
+typedef struct sweepprune_emit_t
+{
+
+    sweepprune_t            *sap;
+    const bodystore_t       *bodies;
+    broadphase_pairs_t      *pairs;
+
+} sweepprune_emit_t;
+
+/* ---------------------------------------------------------------------------------------- */
+
+static bool sweepprune_sync(sweepprune_t *sap, const bodystore_t *bodies);
+static void sweepprune_update_values(sweepprune_t *sap, const bodystore_t *bodies);
+static void sweepprune_insertion_sort(sweepprune_t *sap, const bodystore_t *bodies, sweepprune_endpoint_t *e);
+static void sweepprune_rebuild(sweepprune_t *sap, const bodystore_t *bodies);
+static void sweepprune_emit_pairs(sweepprune_t *sap, const bodystore_t *bodies, broadphase_pairs_t *pairs);
+static bool sweepprune_less(sweepprune_endpoint_t a, sweepprune_endpoint_t b);
+static int sweepprune_compare(const void *a, const void *b);
+static bool sweepprune_overlap(const bodystore_t *bodies, uint32_t slot_a, uint32_t slot_b);
+static void sweepprune_add_pair(sweepprune_t *sap, uint32_t slot_a, uint32_t slot_b);
+static void sweepprune_drop_pair(sweepprune_t *sap, uint32_t slot_a, uint32_t slot_b);
+static bool sweepprune_keep_tracked(uint64_t key, void *value, void *context);
+static bool sweepprune_emit_pair(uint64_t key, void *value, void *context);
+
+/* ---------------------------------------------------------------------------------------- */
+
+void sweepprune_init(sweepprune_t *sap)
+{
+
+    memset(sap, 0, sizeof(sweepprune_t));
+
+    pairmap_init(&sap->overlaps, sizeof(uint8_t), 0);
+    broadphase_pairs_init(&sap->began);
+    broadphase_pairs_init(&sap->ended);
+
+}
+
+void sweepprune_destroy(sweepprune_t *sap)
+{
+
+    free(sap->endpoints[0]);
+    free(sap->endpoints[1]);
+    free(sap->tracked);
+    free(sap->active);
+
+    pairmap_destroy(&sap->overlaps);
+    broadphase_pairs_destroy(&sap->began);
+    broadphase_pairs_destroy(&sap->ended);
+
+    memset(sap, 0, sizeof(sweepprune_t));
+
+}
+
+// brings the endpoint lists up to date with the bodies' new positions, then reports every overlapping pair once
+void sweepprune_find_pairs(sweepprune_t *sap, const bodystore_t *bodies, broadphase_pairs_t *pairs)
+{
+
+    bool rebuild;
+
+    sap->began.count = 0;
+    sap->ended.count = 0;
+    sap->swaps       = 0;
+
+    rebuild = sweepprune_sync(sap, bodies);
+
+    sweepprune_update_values(sap, bodies);
+
+    if (rebuild)
+    {
+        sweepprune_rebuild(sap, bodies);
+    }
+    else
+    {
+        sweepprune_insertion_sort(sap, bodies, sap->endpoints[0]);
+        sweepprune_insertion_sort(sap, bodies, sap->endpoints[1]);
+    }
+
+    sweepprune_emit_pairs(sap, bodies, pairs);
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+// drops endpoints of removed bodies and appends endpoints for new ones. Returns true if so many
+// bodies are new that sorting from scratch is cheaper than insertion sort
+static bool sweepprune_sync(sweepprune_t *sap, const bodystore_t *bodies)
+{
+
+    uint32_t i, k, axis, slot, kept, added;
+    bool removed = false;
+
+    if (bodies->slot_count > sap->slot_capacity)
+    {
+        sap->tracked = realloc(sap->tracked, bodies->slot_capacity * sizeof(uint32_t));
+        memset(sap->tracked + sap->slot_capacity, 0xFF, (bodies->slot_capacity - sap->slot_capacity) * sizeof(uint32_t));
+        sap->slot_capacity = bodies->slot_capacity;
+    }
+
+    // a slot whose generation moved on was removed (and maybe reused), forget it...
+    for (k = 0; k < sap->endpoint_count; k++)
+    {
+
+        slot = SWEEPPRUNE_SLOT(sap->endpoints[0][k].id);
+
+        if (sap->tracked[slot] != SWEEPPRUNE_UNTRACKED && sap->tracked[slot] != bodies->slot_generation[slot])
+        {
+            sap->tracked[slot] = SWEEPPRUNE_UNTRACKED;
+            removed = true;
+        }
+
+    }
+
+    // ...its endpoints on both axes...
+    if (removed)
+    {
+        for (axis = 0; axis < 2; axis++)
+        {
+
+            kept = 0;
+
+            for (k = 0; k < sap->endpoint_count; k++)
+            {
+                if (sap->tracked[SWEEPPRUNE_SLOT(sap->endpoints[axis][k].id)] != SWEEPPRUNE_UNTRACKED)
+                {
+                    sap->endpoints[axis][kept++] = sap->endpoints[axis][k];
+                }
+            }
+
+        }
+
+        sap->endpoint_count = kept;
+
+        // ...and every pair it was part of
+        pairmap_retain(&sap->overlaps, sweepprune_keep_tracked, sap);
+    }
+
+    if (2 * bodies->count > sap->endpoint_capacity)
+    {
+        sap->endpoint_capacity = 2 * bodies->count + bodies->count;
+        sap->endpoints[0] = realloc(sap->endpoints[0], sap->endpoint_capacity * sizeof(sweepprune_endpoint_t));
+        sap->endpoints[1] = realloc(sap->endpoints[1], sap->endpoint_capacity * sizeof(sweepprune_endpoint_t));
+    }
+
+    // new bodies go on the end, the sort carries them into place
+    added = 0;
+    for (i = 0; i < bodies->count; i++)
+    {
+
+        slot = bodies->slot[i];
+
+        if (sap->tracked[slot] == SWEEPPRUNE_UNTRACKED)
+        {
+
+            sap->tracked[slot] = bodies->slot_generation[slot];
+
+            for (axis = 0; axis < 2; axis++)
+            {
+                sap->endpoints[axis][sap->endpoint_count]     = (sweepprune_endpoint_t){ 0.0f, slot << 1 };
+                sap->endpoints[axis][sap->endpoint_count + 1] = (sweepprune_endpoint_t){ 0.0f, (slot << 1) | 1 };
+            }
+
+            sap->endpoint_count += 2;
+            added++;
+
+        }
+
+    }
+
+    return added > 0 && added * SWEEPPRUNE_REBUILD_FRACTION >= bodies->count;
+
+}
+
+// copies each body's current intervals into its endpoints
+static void sweepprune_update_values(sweepprune_t *sap, const bodystore_t *bodies)
+{
+
+    sweepprune_endpoint_t *ex = sap->endpoints[0];
+    sweepprune_endpoint_t *ey = sap->endpoints[1];
+    uint32_t i;
+
+    for (uint32_t k = 0; k < sap->endpoint_count; k++)
+    {
+        i = bodies->slot_index[SWEEPPRUNE_SLOT(ex[k].id)];
+        ex[k].value = SWEEPPRUNE_IS_MAX(ex[k].id) ? bodies->x_pos[i] + bodies->width[i] : bodies->x_pos[i];
+    }
+
+    for (uint32_t k = 0; k < sap->endpoint_count; k++)
+    {
+        i = bodies->slot_index[SWEEPPRUNE_SLOT(ey[k].id)];
+        ey[k].value = SWEEPPRUNE_IS_MAX(ey[k].id) ? bodies->y_pos[i] + bodies->height[i] : bodies->y_pos[i];
+    }
+
+}
+
+// re-sorts one nearly sorted axis, turning min/max crossings into overlap begin/end
+static void sweepprune_insertion_sort(sweepprune_t *sap, const bodystore_t *bodies, sweepprune_endpoint_t *e)
+{
+
+    sweepprune_endpoint_t moving, other;
+    uint32_t k, j, a, b;
+
+    for (k = 1; k < sap->endpoint_count; k++)
+    {
+
+        moving = e[k];
+
+        for (j = k; j > 0 && sweepprune_less(moving, e[j - 1]); j--)
+        {
+
+            other = e[j - 1];
+            e[j]  = other;
+            sap->swaps++;
+
+            a = SWEEPPRUNE_SLOT(moving.id);
+            b = SWEEPPRUNE_SLOT(other.id);
+
+            if (a == b || SWEEPPRUNE_IS_MAX(moving.id) == SWEEPPRUNE_IS_MAX(other.id)) continue;
+
+            // a min moving left past a max may open an overlap. Positions are final, so checking both axes settles it
+            if (!SWEEPPRUNE_IS_MAX(moving.id))
+            {
+                if (sweepprune_overlap(bodies, a, b))
+                {
+                    sweepprune_add_pair(sap, a, b);
+                }
+            }
+
+            // a max moving left past a min always closes one
+            else
+            {
+                sweepprune_drop_pair(sap, a, b);
+            }
+
+        }
+
+        e[j] = moving;
+
+    }
+
+}
+
+// sorts both axes from scratch and sweeps x to find every overlapping pair
+static void sweepprune_rebuild(sweepprune_t *sap, const bodystore_t *bodies)
+{
+
+    sweepprune_endpoint_t *e = sap->endpoints[0];
+    uint32_t active = 0;
+    uint32_t k, m, slot;
+
+    qsort(sap->endpoints[0], sap->endpoint_count, sizeof(sweepprune_endpoint_t), sweepprune_compare);
+    qsort(sap->endpoints[1], sap->endpoint_count, sizeof(sweepprune_endpoint_t), sweepprune_compare);
+
+    if (sap->active_capacity < bodies->count)
+    {
+        sap->active_capacity = bodies->count;
+        sap->active = realloc(sap->active, sap->active_capacity * sizeof(uint32_t));
+    }
+
+    // clear every known pair, the sweep revives the ones that are still overlapping
+    for (k = 0; k < sap->overlaps.capacity; k++)
+    {
+        if (sap->overlaps.keys[k] != PAIRMAP_EMPTY)
+        {
+            *(uint8_t *)pairmap_value_at(&sap->overlaps, k) &= ~SWEEPPRUNE_ALIVE;
+        }
+    }
+
+    for (k = 0; k < sap->endpoint_count; k++)
+    {
+
+        slot = SWEEPPRUNE_SLOT(e[k].id);
+
+        if (SWEEPPRUNE_IS_MAX(e[k].id))
+        {
+            for (m = 0; m < active; m++)
+            {
+                if (sap->active[m] == slot)
+                {
+                    sap->active[m] = sap->active[--active];
+                    break;
+                }
+            }
+            continue;
+        }
+
+        for (m = 0; m < active; m++)
+        {
+            if (sweepprune_overlap(bodies, slot, sap->active[m]))
+            {
+                sweepprune_add_pair(sap, slot, sap->active[m]);
+            }
+        }
+
+        sap->active[active++] = slot;
+
+    }
+
+}
+
+// reports every overlapping pair by dense index, and the net begin/end of each pair this frame by slot
+static void sweepprune_emit_pairs(sweepprune_t *sap, const bodystore_t *bodies, broadphase_pairs_t *pairs)
+{
+
+    sweepprune_emit_t emit = { sap, bodies, pairs };
+
+    pairs->count = 0;
+
+    pairmap_retain(&sap->overlaps, sweepprune_emit_pair, &emit);
+
+}
+
+// drops pairs whose body was removed, reporting the end if the begin was reported
+static bool sweepprune_keep_tracked(uint64_t key, void *value, void *context)
+{
+
+    sweepprune_t *sap = context;
+
+    if (sap->tracked[pairmap_key_lo(key)] != SWEEPPRUNE_UNTRACKED && sap->tracked[pairmap_key_hi(key)] != SWEEPPRUNE_UNTRACKED)
+    {
+        return true;
+    }
+
+    if (*(uint8_t *)value & SWEEPPRUNE_REPORTED)
+    {
+        broadphase_pairs_push(&sap->ended, pairmap_key_lo(key), pairmap_key_hi(key));
+    }
+
+    return false;
+
+}
+
+// reports one pair's begin/end and, if it's still overlapping, the pair itself
+static bool sweepprune_emit_pair(uint64_t key, void *value, void *context)
+{
+
+    sweepprune_emit_t *emit = context;
+    uint8_t *flags = value;
+    uint32_t i, j;
+
+    if (!(*flags & SWEEPPRUNE_ALIVE))
+    {
+
+        if (*flags & SWEEPPRUNE_REPORTED)
+        {
+            broadphase_pairs_push(&emit->sap->ended, pairmap_key_lo(key), pairmap_key_hi(key));
+        }
+
+        return false;
+
+    }
+
+    if (!(*flags & SWEEPPRUNE_REPORTED))
+    {
+        broadphase_pairs_push(&emit->sap->began, pairmap_key_lo(key), pairmap_key_hi(key));
+        *flags |= SWEEPPRUNE_REPORTED;
+    }
+
+    i = emit->bodies->slot_index[pairmap_key_lo(key)];
+    j = emit->bodies->slot_index[pairmap_key_hi(key)];
+
+    broadphase_pairs_push(emit->pairs, i < j ? i : j, i < j ? j : i);
+
+    return true;
+
+}
+
+// endpoint order: by value, with max endpoints first on ties so touching intervals don't count as overlapping
+static bool sweepprune_less(sweepprune_endpoint_t a, sweepprune_endpoint_t b)
+{
+    return a.value < b.value || (a.value == b.value && SWEEPPRUNE_IS_MAX(a.id) > SWEEPPRUNE_IS_MAX(b.id));
+}
+
+static int sweepprune_compare(const void *a, const void *b)
+{
+
+    const sweepprune_endpoint_t *ea = a;
+    const sweepprune_endpoint_t *eb = b;
+
+    if (sweepprune_less(*ea, *eb)) return -1;
+    if (sweepprune_less(*eb, *ea)) return  1;
+
+    return 0;
+
+}
+
+static bool sweepprune_overlap(const bodystore_t *bodies, uint32_t slot_a, uint32_t slot_b)
+{
+
+    uint32_t i = bodies->slot_index[slot_a];
+    uint32_t j = bodies->slot_index[slot_b];
+
+    return bodies->x_pos[i] < bodies->x_pos[j] + bodies->width[j]  && bodies->x_pos[j] < bodies->x_pos[i] + bodies->width[i] &&
+           bodies->y_pos[i] < bodies->y_pos[j] + bodies->height[j] && bodies->y_pos[j] < bodies->y_pos[i] + bodies->height[i];
+
+}
+
+// marks a pair as overlapping, adding it if it's new
+static void sweepprune_add_pair(sweepprune_t *sap, uint32_t slot_a, uint32_t slot_b)
+{
+    *(uint8_t *)pairmap_insert(&sap->overlaps, pairmap_key(slot_a, slot_b), NULL) |= SWEEPPRUNE_ALIVE;
+}
+
+// marks a pair as no longer overlapping, it's dropped when the pairs are emitted
+static void sweepprune_drop_pair(sweepprune_t *sap, uint32_t slot_a, uint32_t slot_b)
+{
+
+    uint8_t *flags = pairmap_find(&sap->overlaps, pairmap_key(slot_a, slot_b));
+
+    if (flags)
+    {
+        *flags &= ~SWEEPPRUNE_ALIVE;
+    }
+
+}
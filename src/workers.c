@@ -0,0 +1,531 @@
+/*
+ *  workers.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Dylan
+ */
+
+/* ---------------------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../inc/SDL2/SDL.h"
+#include "../inc/common.h"
+#include "../inc/workers.h"
+
+/* ---------------------------------------------------------------------------------------- */
+
+// a parallel for under way, it lives on the caller's stack until every index has run
+struct workers_loop_t
+{
+
+    workers_range_t     job;
+    void                *context;
+    uint32_t            grain;
+    workers_task_t      *phase;                                 // task the loop's time is charged to, if any
+    SDL_atomic_t        remaining;                              // indices that haven't run yet
+
+};
+
+static _Thread_local uint32_t workers_self;                     // worker number of the running thread
+static _Thread_local workers_task_t *workers_phase;             // task the running thread's time is charged to
+static _Thread_local uint64_t workers_mark;                     // when that charge began
+
+static int workers_main(void *data);
+static void workers_wait(workers_t *workers, SDL_atomic_t *counter);
+static bool workers_push(workers_t *workers, workers_item_t item);
+static bool workers_find(workers_t *workers, workers_item_t *item);
+static void workers_wake(workers_t *workers);
+static bool workers_unsleep(workers_t *workers);
+static void workers_run_item(workers_t *workers, workers_item_t item);
+static void workers_run_range(workers_t *workers, workers_loop_t *loop, uint32_t begin, uint32_t end);
+static void workers_run_task(workers_t *workers, workers_task_t *task);
+static workers_task_t* workers_charge(workers_task_t *phase);
+
+/* ---------------------------------------------------------------------------------------- */
+
+// starts count - 1 threads to work alongside the caller, count 0 means one per CPU. The caller
+// becomes worker 0
+void workers_init(workers_t *workers, uint32_t count)
+{
+
+    memset(workers, 0, sizeof(workers_t));
+
+    if (count == 0)
+    {
+        count = SDL_GetCPUCount();
+    }
+
+    workers->count  = SDL_clamp(count, 1, WORKERS_MAX);
+    workers->deques = calloc(workers->count, sizeof(workers_deque_t));
+    workers->wake   = SDL_CreateSemaphore(0);
+
+    workers_self = 0;
+
+    for (uint32_t i = 1; i < workers->count; i++)
+    {
+        workers->threads[i] = SDL_CreateThread(workers_main, "worker", workers);
+    }
+
+}
+
+void workers_destroy(workers_t *workers)
+{
+
+    SDL_AtomicSet(&workers->quit, 1);
+
+    for (uint32_t i = 1; i < workers->count; i++)
+    {
+        SDL_SemPost(workers->wake);
+    }
+
+    for (uint32_t i = 1; i < workers->count; i++)
+    {
+        SDL_WaitThread(workers->threads[i], NULL);
+    }
+
+    SDL_DestroySemaphore(workers->wake);
+    free(workers->deques);
+
+    memset(workers, 0, sizeof(workers_t));
+
+}
+
+// runs job over [0, total) one grain at a time and returns once all of it is done. A grain of 0
+// picks one that cuts the loop into WORKERS_CHUNKS_PER_WORKER chunks per thread
+void workers_parallel_for(workers_t *workers, uint32_t total, uint32_t grain, workers_range_t job, void *context)
+{
+
+    workers_loop_t loop;
+    workers_task_t *phase;
+
+    if (total == 0)
+    {
+        return;
+    }
+
+    if (grain == 0)
+    {
+        grain = SDL_max(total / (workers->count * WORKERS_CHUNKS_PER_WORKER), 1);
+    }
+
+    // not worth splitting
+    if (workers->count == 1 || total <= grain)
+    {
+        job(0, total, workers_self, context);
+        return;
+    }
+
+    loop.job     = job;
+    loop.context = context;
+    loop.grain   = grain;
+    loop.phase   = workers_phase;
+    SDL_AtomicSet(&loop.remaining, (int)total);
+
+    workers_run_range(workers, &loop, 0, total);
+
+    // the wait isn't work for whatever the caller is charged to, what it helps with is charged itself
+    phase = workers_charge(NULL);
+    workers_wait(workers, &loop.remaining);
+    workers_charge(phase);
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+void workers_graph_init(workers_graph_t *graph)
+{
+    memset(graph, 0, sizeof(workers_graph_t));
+}
+
+// adds a task that runs func(worker, context), returns NULL once the graph is full
+workers_task_t* workers_graph_add(workers_graph_t *graph, const char *name, workers_func_t func, void *context)
+{
+
+    workers_task_t *task;
+
+    if (graph->count >= WORKERS_MAX_TASKS)
+    {
+        return NULL;
+    }
+
+    task = &graph->tasks[graph->count++];
+
+    task->name    = name;
+    task->func    = func;
+    task->context = context;
+    task->graph   = graph;
+
+    return task;
+
+}
+
+// makes task wait for on to finish before it starts
+void workers_graph_depend(workers_task_t *task, workers_task_t *on)
+{
+
+    if (on->dependent_count >= WORKERS_MAX_DEPENDENTS)
+    {
+        printf("task '%s' already has %u dependents, '%s' can't wait on it\n", on->name, on->dependent_count, task->name);
+        return;
+    }
+
+    on->dependents[on->dependent_count++] = task;
+    task->dependencies++;
+
+}
+
+// runs every task of the graph once, in dependency order, and returns when the last one finishes
+void workers_graph_run(workers_t *workers, workers_graph_t *graph)
+{
+
+    workers_task_t *phase;
+    uint32_t k;
+
+    if (graph->count == 0)
+    {
+        return;
+    }
+
+    SDL_AtomicSet(&graph->remaining, (int)graph->count);
+
+    // every count has to be armed before the first task can finish and count down its dependents
+    for (k = 0; k < graph->count; k++)
+    {
+        SDL_AtomicSet(&graph->tasks[k].pending, (int)graph->tasks[k].dependencies);
+    }
+
+    for (k = 0; k < graph->count; k++)
+    {
+        if (graph->tasks[k].dependencies == 0 && !workers_push(workers, (workers_item_t){ NULL, &graph->tasks[k], 0, 0 }))
+        {
+            workers_run_task(workers, &graph->tasks[k]);
+        }
+    }
+
+    phase = workers_charge(NULL);
+    workers_wait(workers, &graph->remaining);
+    workers_charge(phase);
+
+}
+
+// prints each task's average time and parallel efficiency since the last report, the share of
+// every thread's time over the task's run that went into it, then starts counting over
+void workers_graph_report(const workers_t *workers, workers_graph_t *graph)
+{
+
+    const double frequency = (double)SDL_GetPerformanceFrequency();
+    workers_task_t *task;
+    uint64_t busy;
+
+    for (uint32_t k = 0; k < graph->count; k++)
+    {
+
+        task = &graph->tasks[k];
+        busy = 0;
+
+        for (uint32_t w = 0; w < workers->count; w++)
+        {
+            busy += task->busy[w];
+        }
+
+        if (task->runs && task->wall)
+        {
+            printf("%-12s %8.3f ms  %5.1f%% of %u threads\n", task->name, 1000.0 * task->wall / frequency / task->runs,
+                   100.0 * busy / ((double)task->wall * workers->count), workers->count);
+        }
+
+        task->runs = 0;
+        task->wall = 0;
+        memset(task->busy, 0, sizeof(task->busy));
+
+    }
+
+}
+
+/* ---------------------------------------------------------------------------------------- */
+
+static int workers_main(void *data)
+{
+
+    workers_t *workers = data;
+    workers_item_t item;
+    uint32_t spins = 0;
+
+    workers_self = (uint32_t)SDL_AtomicAdd(&workers->started, 1) + 1;
+
+    while (!SDL_AtomicGet(&workers->quit))
+    {
+
+        if (workers_find(workers, &item))
+        {
+            workers_run_item(workers, item);
+            spins = 0;
+            continue;
+        }
+
+        if (++spins < WORKERS_SPINS)
+        {
+            continue;
+        }
+
+        spins = 0;
+
+        // announce the sleep before the last look, so work pushed after that look sees a sleeper to wake
+        SDL_AtomicIncRef(&workers->sleeping);
+
+        if (SDL_AtomicGet(&workers->quit))
+        {
+            break;
+        }
+
+        if (workers_find(workers, &item))
+        {
+
+            // a pusher may have already taken our count and owes us a post, take it
+            if (!workers_unsleep(workers))
+            {
+                SDL_SemWait(workers->wake);
+            }
+
+            workers_run_item(workers, item);
+            continue;
+
+        }
+
+        SDL_SemWait(workers->wake);
+
+    }
+
+    return 0;
+
+}
+
+// runs whatever work can be found until counter drops to zero
+static void workers_wait(workers_t *workers, SDL_atomic_t *counter)
+{
+
+    workers_item_t item;
+    uint32_t spins = 0;
+
+    while (SDL_AtomicGet(counter) > 0)
+    {
+
+        if (workers_find(workers, &item))
+        {
+            workers_run_item(workers, item);
+            spins = 0;
+        }
+        else if (++spins >= WORKERS_SPINS)
+        {
+            // whoever holds the rest of the work may need this core
+            SDL_Delay(0);
+            spins = 0;
+        }
+
+    }
+
+}
+
+// pushes onto the back of the running thread's deque and wakes a sleeper to steal it. Returns
+// false if the deque is full, the caller then runs the item itself
+static bool workers_push(workers_t *workers, workers_item_t item)
+{
+
+    workers_deque_t *deque = &workers->deques[workers_self];
+
+    SDL_AtomicLock(&deque->lock);
+
+    if (deque->tail - deque->head >= WORKERS_DEQUE_SIZE)
+    {
+        SDL_AtomicUnlock(&deque->lock);
+        return false;
+    }
+
+    deque->items[deque->tail++ % WORKERS_DEQUE_SIZE] = item;
+
+    SDL_AtomicUnlock(&deque->lock);
+
+    workers_wake(workers);
+
+    return true;
+
+}
+
+// pops the newest item of the running thread's deque, or steals the oldest of someone else's
+static bool workers_find(workers_t *workers, workers_item_t *item)
+{
+
+    workers_deque_t *deque = &workers->deques[workers_self];
+    bool found = false;
+
+    SDL_AtomicLock(&deque->lock);
+
+    if (deque->tail != deque->head)
+    {
+        *item = deque->items[--deque->tail % WORKERS_DEQUE_SIZE];
+        found = true;
+    }
+
+    SDL_AtomicUnlock(&deque->lock);
+
+    for (uint32_t i = 1; !found && i < workers->count; i++)
+    {
+
+        deque = &workers->deques[(workers_self + i) % workers->count];
+
+        SDL_AtomicLock(&deque->lock);
+
+        if (deque->tail != deque->head)
+        {
+            *item = deque->items[deque->head++ % WORKERS_DEQUE_SIZE];
+            found = true;
+        }
+
+        SDL_AtomicUnlock(&deque->lock);
+
+    }
+
+    return found;
+
+}
+
+// wakes one sleeping thread, if there is one no post is owed to yet
+static void workers_wake(workers_t *workers)
+{
+
+    int sleeping;
+
+    while ((sleeping = SDL_AtomicGet(&workers->sleeping)) > 0)
+    {
+        if (SDL_AtomicCAS(&workers->sleeping, sleeping, sleeping - 1))
+        {
+            SDL_SemPost(workers->wake);
+            return;
+        }
+    }
+
+}
+
+// takes back a sleep that was announced, false if a waker already took it and a post is coming
+static bool workers_unsleep(workers_t *workers)
+{
+
+    int sleeping;
+
+    while ((sleeping = SDL_AtomicGet(&workers->sleeping)) > 0)
+    {
+        if (SDL_AtomicCAS(&workers->sleeping, sleeping, sleeping - 1))
+        {
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+static void workers_run_item(workers_t *workers, workers_item_t item)
+{
+
+    if (item.loop)
+    {
+        workers_run_range(workers, item.loop, item.begin, item.end);
+    }
+    else
+    {
+        workers_run_task(workers, item.task);
+    }
+
+}
+
+// splits the upper half of [begin, end) off for thieves until a grain is left, then runs it.
+// Splits land on grain boundaries, and a range a full deque kept whole still runs a grain at a time
+static void workers_run_range(workers_t *workers, workers_loop_t *loop, uint32_t begin, uint32_t end)
+{
+
+    const uint32_t grain = loop->grain;
+    workers_task_t *phase;
+    uint32_t chunks, middle, b;
+
+    while ((chunks = (end - begin + grain - 1) / grain) > 1)
+    {
+
+        middle = begin + (chunks / 2) * grain;
+
+        if (!workers_push(workers, (workers_item_t){ loop, NULL, middle, end }))
+        {
+            break;
+        }
+
+        end = middle;
+
+    }
+
+    phase = workers_charge(loop->phase);
+
+    for (b = begin; b < end; b += grain)
+    {
+        loop->job(b, SDL_min(b + grain, end), workers_self, loop->context);
+    }
+
+    workers_charge(phase);
+
+    // the loop lives on its caller's stack, it's gone as soon as this reaches zero
+    SDL_AtomicAdd(&loop->remaining, -(int)(end - begin));
+
+}
+
+// runs a graph task, then pushes the dependents it was the last to release
+static void workers_run_task(workers_t *workers, workers_task_t *task)
+{
+
+    workers_graph_t *graph = task->graph;
+    workers_task_t *phase, *dependent;
+
+    task->start = SDL_GetPerformanceCounter();
+
+    phase = workers_charge(task);
+    task->func(workers_self, task->context);
+    workers_charge(phase);
+
+    task->wall += SDL_GetPerformanceCounter() - task->start;
+    task->runs++;
+
+    for (uint32_t d = 0; d < task->dependent_count; d++)
+    {
+
+        dependent = task->dependents[d];
+
+        if (SDL_AtomicAdd(&dependent->pending, -1) == 1 && !workers_push(workers, (workers_item_t){ NULL, dependent, 0, 0 }))
+        {
+            workers_run_task(workers, dependent);
+        }
+
+    }
+
+    // the graph's runner may start over as soon as this reaches zero
+    SDL_AtomicAdd(&graph->remaining, -1);
+
+}
+
+// charges the time since the last charge to the running thread's current task, then makes phase
+// the current one. Returns the one it replaced
+static workers_task_t* workers_charge(workers_task_t *phase)
+{
+
+    uint64_t now = SDL_GetPerformanceCounter();
+    workers_task_t *previous = workers_phase;
+
+    if (previous)
+    {
+        previous->busy[workers_self] += now - workers_mark;
+    }
+
+    workers_phase = phase;
+    workers_mark  = now;
+
+    return previous;
+
+}